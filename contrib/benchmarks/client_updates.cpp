@@ -0,0 +1,389 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * Client update packet benchmark for login and raid pull bursts.
+ *
+ * Replays the stage MapManager::ScheduleClientUpdates runs after the map ticks: every session's UpdateData
+ * is turned into packets by UpdateData::BuildPacket, which deflates everything above 100 bytes with the
+ * deflate stream of the calling thread. Sockets are not involved, the packets are dropped after building.
+ *
+ * "serial" builds all sessions on the calling thread, the way one map did it at the end of its tick.
+ * "staged" cuts the sessions in chunks of 16 and runs them on a MapUpdater, as ScheduleClientUpdates does.
+ * ClientUpdateWorker takes its sessions from a Map, so the chunks run in a Worker doing the same loop as
+ * Map::SendPendingClientUpdates without the socket.
+ *
+ * The update blocks are synthetic but shaped like the real ones: create blocks of creatures, players and
+ * game objects (movement block, update mask, mostly small field values) for a login, values blocks with a
+ * few changed fields for a raid pull. Every session of a burst sees the same objects, so it gets the same
+ * blocks, like players standing together.
+ *
+ * Usage: client_updates [threads] [ticks] [compression level]
+ */
+
+#include "Common.h"
+#include "WorldPacket.h"
+#include "Entities/UpdateData.h"
+#include "Maps/MapUpdater.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    typedef std::chrono::steady_clock Clock;
+
+    size_t const CHUNK_SIZE = 16;                           // sessions per worker task, as in ScheduleClientUpdates
+
+    uint32 const OBJECT_END = 0x0006;
+    uint32 const UNIT_END = OBJECT_END + 0x008E;
+    uint32 const PLAYER_END = UNIT_END + 0x049A;
+    uint32 const GAMEOBJECT_END = OBJECT_END + 0x000C;
+
+    // CPU time of the calling thread, wall time would count the time a worker waits for a core
+    double ThreadCpuSeconds()
+    {
+#ifdef _WIN32
+        FILETIME creation, exit, kernel, user;
+        GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user);
+        return ((uint64(kernel.dwHighDateTime) << 32 | kernel.dwLowDateTime) + (uint64(user.dwHighDateTime) << 32 | user.dwLowDateTime)) * 1e-7;
+#else
+        timespec ts;
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+        return ts.tv_sec + ts.tv_nsec * 1e-9;
+#endif
+    }
+
+    class BlockFactory
+    {
+        public:
+            explicit BlockFactory(uint32 seed) : m_rng(seed) {}
+
+            // update mask plus the values of the set fields, creates set most of the fields an object uses
+            void AppendValues(ByteBuffer& buf, uint32 fieldCount, uint32 setFields, uint64 guid)
+            {
+                uint32 blocks = (fieldCount + 31) / 32;
+                std::vector<uint32> mask(blocks, 0);
+                std::vector<uint32> fields;
+                fields.push_back(0);                        // OBJECT_FIELD_GUID
+                fields.push_back(1);
+                fields.push_back(2);                        // OBJECT_FIELD_TYPE
+                std::uniform_int_distribution<uint32> field(3, fieldCount - 1);
+                while (fields.size() < std::min(setFields, fieldCount))
+                {
+                    uint32 f = field(m_rng);
+                    if (std::find(fields.begin(), fields.end(), f) == fields.end())
+                        fields.push_back(f);
+                }
+                std::sort(fields.begin(), fields.end());
+
+                for (uint32 f : fields)
+                    mask[f / 32] |= 1u << (f % 32);
+
+                buf << uint8(blocks);
+                for (uint32 m : mask)
+                    buf << m;
+
+                std::uniform_int_distribution<uint32> kind(0, 9);
+                for (uint32 f : fields)
+                {
+                    if (f == 0)
+                        buf << uint32(guid);
+                    else if (f == 1)
+                        buf << uint32(guid >> 32);
+                    else
+                    {
+                        // mostly flags, small counters and entries, some floats and 0
+                        switch (kind(m_rng))
+                        {
+                            case 0: case 1: case 2: buf << uint32(m_rng() % 100); break;
+                            case 3: case 4: buf << uint32(m_rng() % 40000); break;
+                            case 5: buf << float(m_rng() % 1000) / 10.0f; break;
+                            case 6: buf << 1.0f; break;
+                            case 7: buf << uint32(m_rng()); break;
+                            default: buf << uint32(0); break;
+                        }
+                    }
+                }
+            }
+
+            ByteBuffer CreateBlock(uint64 guid, uint8 typeId, uint32 fieldCount, uint32 setFields, bool living)
+            {
+                ByteBuffer buf(500);
+                buf << uint8(UPDATETYPE_CREATE_OBJECT2);
+                buf << ObjectGuid(guid).WriteAsPacked();
+                buf << typeId;
+
+                std::uniform_real_distribution<float> coord(-2000.0f, 2000.0f);
+                if (living)
+                {
+                    buf << uint16(UPDATEFLAG_LIVING | UPDATEFLAG_HAS_POSITION | UPDATEFLAG_HIGHGUID);
+                    buf << uint32(0);                       // movement flags
+                    buf << uint16(0);
+                    buf << uint32(m_rng());                 // time
+                    for (int i = 0; i < 4; ++i)
+                        buf << coord(m_rng);                // x, y, z, o
+                    buf << uint32(0);                       // fall time
+                    float const speeds[9] = { 2.5f, 7.0f, 4.5f, 4.722222f, 2.5f, 7.0f, 3.141594f, 3.141594f, 3.141594f };
+                    for (float speed : speeds)
+                        buf << speed;
+                }
+                else
+                {
+                    buf << uint16(UPDATEFLAG_HAS_POSITION | UPDATEFLAG_ROTATION);
+                    for (int i = 0; i < 4; ++i)
+                        buf << coord(m_rng);
+                    buf << uint64(m_rng());                 // packed rotation
+                }
+
+                AppendValues(buf, fieldCount, setFields, guid);
+                return buf;
+            }
+
+            ByteBuffer ValuesBlock(uint64 guid, uint32 fieldCount, uint32 setFields)
+            {
+                ByteBuffer buf(500);
+                buf << uint8(UPDATETYPE_VALUES);
+                buf << ObjectGuid(guid).WriteAsPacked();
+                AppendValues(buf, fieldCount, setFields, guid);
+                return buf;
+            }
+
+        private:
+            std::mt19937 m_rng;
+    };
+
+    struct Burst
+    {
+        char const* name;
+        std::vector<UpdateData> sessions;
+    };
+
+    // 40 players logging in at one spot, each gets everything around them
+    Burst LoginBurst()
+    {
+        BlockFactory factory(1);
+        std::vector<ByteBuffer> blocks;
+        for (uint32 i = 0; i < 200; ++i)
+            blocks.push_back(factory.CreateBlock(0xF130000000000000ULL | uint64(20000 + i) << 24 | (100000 + i), 3, UNIT_END, 45, true));
+        for (uint32 i = 0; i < 40; ++i)
+            blocks.push_back(factory.CreateBlock(1000 + i, 4, PLAYER_END, 160, true));
+        for (uint32 i = 0; i < 30; ++i)
+            blocks.push_back(factory.CreateBlock(0xF110000000000000ULL | uint64(180000 + i) << 24 | (5000 + i), 5, GAMEOBJECT_END, 12, false));
+
+        Burst burst { "login", std::vector<UpdateData>(40) };
+        for (UpdateData& session : burst.sessions)
+            for (ByteBuffer const& block : blocks)
+                session.AddUpdateBlock(block);
+        return burst;
+    }
+
+    // 25 players pulling a boss with adds: health, power, auras and target changes of everyone in sight every tick
+    Burst RaidPullBurst()
+    {
+        BlockFactory factory(2);
+        std::vector<ByteBuffer> blocks;
+        for (uint32 i = 0; i < 25; ++i)
+            blocks.push_back(factory.ValuesBlock(1000 + i, PLAYER_END, 6));
+        for (uint32 i = 0; i < 12; ++i)
+            blocks.push_back(factory.ValuesBlock(0xF130000000000000ULL | uint64(30000 + i) << 24 | (200000 + i), UNIT_END, 8));
+
+        Burst burst { "raid pull", std::vector<UpdateData>(25) };
+        for (UpdateData& session : burst.sessions)
+        {
+            session.AddOutOfRangeGUID(ObjectGuid(uint64(0xF130000000000000ULL | 30100ULL << 24 | 200100)));
+            for (ByteBuffer const& block : blocks)
+                session.AddUpdateBlock(block);
+        }
+        return burst;
+    }
+
+    struct Totals
+    {
+        uint64 packets = 0;
+        uint64 rawBytes = 0;
+        uint64 sentBytes = 0;
+        bool failed = false;
+    };
+
+    // the packet loop of Map::SendPendingClientUpdates for the sessions in [begin, end)
+    void BuildPackets(std::vector<UpdateData>& sessions, size_t begin, size_t end, Totals& totals)
+    {
+        for (size_t i = begin; i < end; ++i)
+        {
+            UpdateData& data = sessions[i];
+            if (!data.HasData())
+                continue;
+
+            for (size_t j = 0; j < data.GetPacketCount(); ++j)
+            {
+                WorldPacket packet = data.BuildPacket(j);
+                if (packet.GetOpcode() == SMSG_COMPRESSED_UPDATE_OBJECT)
+                    totals.rawBytes += packet.read<uint32>(0);
+                else if (packet.GetOpcode() == SMSG_UPDATE_OBJECT)
+                    totals.rawBytes += packet.size();
+                else
+                    totals.failed = true;
+
+                ++totals.packets;
+                totals.sentBytes += packet.size();
+            }
+        }
+    }
+
+    // one chunk of sessions, scheduled like ClientUpdateWorker
+    class PacketBuildWorker : public Worker
+    {
+        public:
+            PacketBuildWorker(MapUpdater& updater) : Worker(updater), m_sessions(nullptr), m_begin(0), m_end(0), m_cpuSeconds(0.0) {}
+
+            void SetRange(std::vector<UpdateData>& sessions, size_t begin, size_t end)
+            {
+                m_sessions = &sessions;
+                m_begin = begin;
+                m_end = end;
+            }
+
+            Totals const& GetTotals() const { return m_totals; }
+            double GetCpuSeconds() const { return m_cpuSeconds; }
+
+            void execute() override
+            {
+                double cpuStart = ThreadCpuSeconds();
+                BuildPackets(*m_sessions, m_begin, m_end, m_totals);
+                m_cpuSeconds += ThreadCpuSeconds() - cpuStart;
+                GetWorker().update_finished();
+            }
+
+        private:
+            std::vector<UpdateData>* m_sessions;
+            size_t m_begin;
+            size_t m_end;
+            Totals m_totals;
+            double m_cpuSeconds;
+    };
+
+    struct Result
+    {
+        Totals totals;
+        double wallSeconds = 0.0;
+        double cpuSeconds = 0.0;                            // summed over the threads doing the stage
+    };
+
+    Result RunSerial(Burst& burst, uint32 ticks)
+    {
+        Result result;
+        Clock::time_point start = Clock::now();
+        double cpuStart = ThreadCpuSeconds();
+        for (uint32 tick = 0; tick < ticks; ++tick)
+            BuildPackets(burst.sessions, 0, burst.sessions.size(), result.totals);
+        result.cpuSeconds = ThreadCpuSeconds() - cpuStart;
+        result.wallSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+        return result;
+    }
+
+    Result RunStaged(Burst& burst, uint32 ticks, uint32 threadCount)
+    {
+        MapUpdater updater(threadCount);
+        std::vector<std::unique_ptr<PacketBuildWorker>> workers;
+        for (size_t begin = 0; begin < burst.sessions.size(); begin += CHUNK_SIZE)
+        {
+            workers.emplace_back(new PacketBuildWorker(updater));
+            workers.back()->SetRange(burst.sessions, begin, std::min(begin + CHUNK_SIZE, burst.sessions.size()));
+        }
+
+        // the calling thread helps in wait(), as the world thread does in ScheduleClientUpdates
+        Clock::time_point start = Clock::now();
+        for (uint32 tick = 0; tick < ticks; ++tick)
+        {
+            for (auto& worker : workers)
+                updater.schedule_update(worker.get());
+            updater.wait();
+        }
+
+        Result result;
+        result.wallSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+        updater.deactivate();
+
+        // CPU time is taken in the chunks, wherever they ran
+        for (auto const& worker : workers)
+        {
+            Totals const& totals = worker->GetTotals();
+            result.totals.packets += totals.packets;
+            result.totals.rawBytes += totals.rawBytes;
+            result.totals.sentBytes += totals.sentBytes;
+            result.totals.failed |= totals.failed;
+            result.cpuSeconds += worker->GetCpuSeconds();
+        }
+        return result;
+    }
+
+    void Print(char const* burst, char const* mode, uint32 threads, Result const& result)
+    {
+        Totals const& t = result.totals;
+        printf("%-9s %-7s threads %2u  packets %7u  raw %6.1f KB/packet  sent %6.1f KB/packet  %8.2f us cpu/packet  %8.1f MB/s sent  %8.1f MB/s raw\n",
+               burst, mode, threads, uint32(t.packets), t.rawBytes / 1024.0 / t.packets, t.sentBytes / 1024.0 / t.packets,
+               result.cpuSeconds * 1e6 / t.packets, t.sentBytes / result.wallSeconds / 1e6, t.rawBytes / result.wallSeconds / 1e6);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    uint32 threadCount = argc > 1 ? uint32(atoi(argv[1])) : std::max(1u, std::thread::hardware_concurrency());
+    uint32 ticks = argc > 2 ? uint32(atoi(argv[2])) : 200;
+    int level = argc > 3 ? atoi(argv[3]) : 1;               // Compression default (Z_BEST_SPEED)
+
+    if (!threadCount || !ticks || level < 1 || level > 9)
+    {
+        printf("Usage: %s [threads] [ticks] [compression level 1-9]\n", argv[0]);
+        return 1;
+    }
+
+    UpdateData::SetCompressionLevel(level);
+
+    std::vector<Burst> bursts;
+    bursts.push_back(LoginBurst());
+    bursts.push_back(RaidPullBurst());
+
+    bool ok = true;
+    for (Burst& burst : bursts)
+    {
+        Result serial = RunSerial(burst, ticks);
+        Print(burst.name, "serial", 1, serial);
+        Result staged = RunStaged(burst, ticks, threadCount);
+        Print(burst.name, "staged", threadCount, staged);
+
+        ok = ok && !serial.totals.failed && !staged.totals.failed && serial.totals.sentBytes == staged.totals.sentBytes;
+    }
+
+    if (!ok)
+        printf("compression failed or the two stages sent different packets\n");
+    return ok ? 0 : 2;
+}
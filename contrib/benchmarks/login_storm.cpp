@@ -0,0 +1,425 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * Login storm benchmark for the realmd SRP6 work.
+ *
+ * Every login runs the server side of one logon challenge and proof, as AuthSocket does: verifier and salt
+ * set from the account, host ephemeral B, session key from the client's A, strong session key and proof M.
+ * The client side is computed too, so every proof is checked against the client's M1.
+ *
+ * "srp6" measures the SRP6 class; "reference" measures the same arithmetic with plain BN_mod_exp and a
+ * fresh BN_CTX per operation, which is what SRP6/BigNumber did before the fixed-base table and the thread
+ * BN_CTX. Both run on the given number of threads at the same time, like a burst of logins on the crypto pool.
+ *
+ * Usage: login_storm [threads] [logins per thread] [srp6|reference|both]
+ */
+
+#include "Common.h"
+#include "Auth/BigNumber.h"
+#include "Auth/Sha1.h"
+#include "SRP6/SRP6.h"
+
+#include <openssl/bn.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    char const* const PRIME_HEX = "894B645E89E1535BBDAD5B8B290650530801B18EBFBF5E8FAB3C82872A3E9BB7";
+    std::string const USERNAME = "BENCHMARK";
+    std::string const PASSWORD = "STORM";
+
+    struct Account
+    {
+        std::string salt;                                   // hex, as stored in the account table
+        std::string verifier;                               // hex
+        BigNumber x;                                        // client private key
+    };
+
+    // x = H(s, H(USERNAME:PASSWORD)), with the byte order SRP6::CalculateVerifier uses
+    BigNumber ClientPrivateKey(std::string const& rI, BigNumber& s)
+    {
+        BigNumber I;
+        I.SetHexStr(rI.c_str());
+
+        uint8 mDigest[SHA_DIGEST_LENGTH];
+        memset(mDigest, 0, SHA_DIGEST_LENGTH);
+        if (I.GetNumBytes() <= SHA_DIGEST_LENGTH)
+        {
+            auto const vect_I = I.AsByteArray();
+            memcpy(mDigest, vect_I.data(), vect_I.size());
+        }
+        std::reverse(mDigest, mDigest + SHA_DIGEST_LENGTH);
+
+        Sha1Hash sha;
+        sha.UpdateData(s.AsByteArray());
+        sha.UpdateData(mDigest, SHA_DIGEST_LENGTH);
+        sha.Finalize();
+
+        BigNumber x;
+        x.SetBinary(sha.GetDigest(), Sha1Hash::GetLength());
+        return x;
+    }
+
+    Account CreateAccount()
+    {
+        Sha1Hash sha;
+        sha.UpdateData(USERNAME + ":" + PASSWORD);
+        sha.Finalize();
+
+        std::string rI;
+        char hex[3];
+        for (int i = 0; i < SHA_DIGEST_LENGTH; ++i)
+        {
+            snprintf(hex, sizeof(hex), "%02X", sha.GetDigest()[i]);
+            rI += hex;
+        }
+
+        SRP6 srp;
+        srp.CalculateVerifier(rI);
+
+        Account account;
+        char const* salt = srp.GetSalt().AsHexStr();
+        char const* verifier = srp.GetVerifier().AsHexStr();
+        account.salt = salt;
+        account.verifier = verifier;
+        OPENSSL_free((void*)salt);
+        OPENSSL_free((void*)verifier);
+
+        BigNumber s = srp.GetSalt();
+        account.x = ClientPrivateKey(rI, s);
+        return account;
+    }
+
+    // K from S, interleaved SHA1 of the even and odd bytes
+    BigNumber SessionKeyHash(BigNumber const& S)
+    {
+        uint8 t[32];
+        uint8 t1[16];
+        uint8 vK[40];
+        memcpy(t, S.AsByteArray(32).data(), 32);
+
+        Sha1Hash sha;
+        for (int half = 0; half < 2; ++half)
+        {
+            for (int i = 0; i < 16; ++i)
+                t1[i] = t[i * 2 + half];
+
+            sha.Initialize();
+            sha.UpdateData(t1, 16);
+            sha.Finalize();
+            for (int i = 0; i < 20; ++i)
+                vK[i * 2 + half] = sha.GetDigest()[i];
+        }
+
+        BigNumber K;
+        K.SetBinary(vK, 40);
+        return K;
+    }
+
+    // M = H(H(N) ^ H(g), H(I), s, A, B, K)
+    BigNumber ProofHash(BigNumber& N, BigNumber& g, BigNumber& s, BigNumber& A, BigNumber& B, BigNumber& K)
+    {
+        uint8 hash[20];
+        Sha1Hash sha;
+        sha.UpdateBigNumbers(&N, nullptr);
+        sha.Finalize();
+        memcpy(hash, sha.GetDigest(), 20);
+        sha.Initialize();
+        sha.UpdateBigNumbers(&g, nullptr);
+        sha.Finalize();
+        for (int i = 0; i < 20; ++i)
+            hash[i] ^= sha.GetDigest()[i];
+
+        BigNumber t3;
+        t3.SetBinary(hash, 20);
+
+        sha.Initialize();
+        sha.UpdateData(USERNAME);
+        sha.Finalize();
+        uint8 t4[SHA_DIGEST_LENGTH];
+        memcpy(t4, sha.GetDigest(), SHA_DIGEST_LENGTH);
+
+        sha.Initialize();
+        sha.UpdateBigNumbers(&t3, nullptr);
+        sha.UpdateData(t4, SHA_DIGEST_LENGTH);
+        sha.UpdateBigNumbers(&s, &A, &B, &K, nullptr);
+        sha.Finalize();
+
+        BigNumber M;
+        M.SetBinary(sha.GetDigest(), 20);
+        return M;
+    }
+
+    BigNumber HashAB(BigNumber& A, BigNumber& B)
+    {
+        Sha1Hash sha;
+        sha.UpdateBigNumbers(&A, &B, nullptr);
+        sha.Finalize();
+
+        BigNumber u;
+        u.SetBinary(sha.GetDigest(), 20);
+        return u;
+    }
+
+    /// Client side of one login: picks a, answers B with A and M1
+    struct Client
+    {
+        BigNumber N, g, s, x, a, A;
+
+        explicit Client(Account const& account)
+        {
+            N.SetHexStr(PRIME_HEX);
+            g.SetDword(7);
+            s.SetHexStr(account.salt.c_str());
+            x = account.x;
+        }
+
+        void Start()
+        {
+            a.SetRand(19 * 8);
+            A = g.ModExp(a, N);
+        }
+
+        // S = (B - 3 * g^x)^(a + u * x)
+        BigNumber Proof(BigNumber B)
+        {
+            BigNumber u = HashAB(A, B);
+            BigNumber kgx = (g.ModExp(x, N) * 3) % N;
+            BigNumber base = ((B + N) - kgx) % N;
+            BigNumber S = base.ModExp(a + u * x, N);
+            BigNumber K = SessionKeyHash(S);
+            return ProofHash(N, g, s, A, B, K);
+        }
+    };
+
+    /// Server arithmetic as it was before the crypto pool: BN_mod_exp with a new BN_CTX for every operation
+    struct ReferenceServer
+    {
+        BIGNUM* N;
+        BIGNUM* g;
+        BIGNUM* v;
+        BIGNUM* b;
+        BIGNUM* B;
+        BigNumber s;
+
+        explicit ReferenceServer(Account const& account) : N(BN_new()), g(BN_new()), v(BN_new()), b(BN_new()), B(BN_new())
+        {
+            BN_hex2bn(&N, PRIME_HEX);
+            BN_set_word(g, 7);
+            BN_hex2bn(&v, account.verifier.c_str());
+            s.SetHexStr(account.salt.c_str());
+        }
+
+        ~ReferenceServer()
+        {
+            BN_free(N);
+            BN_free(g);
+            BN_free(v);
+            BN_free(b);
+            BN_free(B);
+        }
+
+        // B = (3 * v + g^b) % N
+        void Challenge()
+        {
+            BN_rand(b, 19 * 8, 0, 1);
+
+            BIGNUM* gmod = BN_new();
+            BIGNUM* v3 = BN_new();
+            BIGNUM* three = BN_new();
+            BN_set_word(three, 3);
+
+            BN_CTX* ctx = BN_CTX_new();
+            BN_mod_exp(gmod, g, b, N, ctx);
+            BN_CTX_free(ctx);
+
+            ctx = BN_CTX_new();
+            BN_mul(v3, v, three, ctx);
+            BN_CTX_free(ctx);
+
+            BN_add(v3, v3, gmod);
+
+            ctx = BN_CTX_new();
+            BN_nnmod(B, v3, N, ctx);
+            BN_CTX_free(ctx);
+
+            BN_free(three);
+            BN_free(v3);
+            BN_free(gmod);
+        }
+
+        // S = (A * v^u)^b, then K and M as SRP6 does
+        BigNumber Proof(BigNumber& A)
+        {
+            BigNumber Bn;
+            BN_copy(Bn.BN(), B);
+            BigNumber u = HashAB(A, Bn);
+
+            BIGNUM* vu = BN_new();
+            BIGNUM* S = BN_new();
+
+            BN_CTX* ctx = BN_CTX_new();
+            BN_mod_exp(vu, v, u.BN(), N, ctx);
+            BN_CTX_free(ctx);
+
+            ctx = BN_CTX_new();
+            BN_mul(S, A.BN(), vu, ctx);
+            BN_CTX_free(ctx);
+
+            ctx = BN_CTX_new();
+            BN_mod_exp(S, S, b, N, ctx);
+            BN_CTX_free(ctx);
+
+            BigNumber Sn;
+            BN_copy(Sn.BN(), S);
+            BN_free(S);
+            BN_free(vu);
+
+            BigNumber K = SessionKeyHash(Sn);
+            BigNumber Nn;
+            BN_copy(Nn.BN(), N);
+            BigNumber gn(7);
+            return ProofHash(Nn, gn, s, A, Bn, K);
+        }
+    };
+
+    enum class Mode { Srp6, Reference };
+
+    struct Result
+    {
+        uint32 logins = 0;
+        uint32 failures = 0;
+        double serverSeconds = 0.0;                         // time spent in the server side only
+    };
+
+    void RunLogins(Mode mode, Account const& account, uint32 count, Result& result)
+    {
+        typedef std::chrono::steady_clock Clock;
+        Client client(account);
+
+        for (uint32 i = 0; i < count; ++i)
+        {
+            client.Start();
+            std::vector<uint8> A = client.A.AsByteArray(32);
+            bool matches;
+
+            if (mode == Mode::Srp6)
+            {
+                auto start = Clock::now();
+                SRP6 srp;
+                srp.SetVerifier(account.verifier.c_str());
+                srp.SetSalt(account.salt.c_str());
+                srp.CalculateHostPublicEphemeral();
+                result.serverSeconds += std::chrono::duration<double>(Clock::now() - start).count();
+
+                std::vector<uint8> M1 = client.Proof(srp.GetHostPublicEphemeral()).AsByteArray(20);
+
+                start = Clock::now();
+                matches = srp.CalculateSessionKey(A.data(), 32);
+                srp.HashSessionKey();
+                srp.CalculateProof(USERNAME);
+                // SRP6::Proof compares M.AsByteArray(), which is one byte short when M has a leading zero
+                matches = matches && srp.GetProof().AsByteArray(20) == M1;
+                result.serverSeconds += std::chrono::duration<double>(Clock::now() - start).count();
+            }
+            else
+            {
+                auto start = Clock::now();
+                ReferenceServer server(account);
+                server.Challenge();
+                result.serverSeconds += std::chrono::duration<double>(Clock::now() - start).count();
+
+                BigNumber B;
+                BN_copy(B.BN(), server.B);
+                std::vector<uint8> M1 = client.Proof(B).AsByteArray(20);
+
+                start = Clock::now();
+                BigNumber An;
+                An.SetBinary(A.data(), 32);
+                std::vector<uint8> M = server.Proof(An).AsByteArray(20);
+                matches = M == M1;
+                result.serverSeconds += std::chrono::duration<double>(Clock::now() - start).count();
+            }
+
+            ++result.logins;
+            if (!matches)
+                ++result.failures;
+        }
+    }
+
+    bool RunStorm(Mode mode, Account const& account, uint32 threadCount, uint32 loginsPerThread)
+    {
+        std::vector<Result> results(threadCount);
+        std::vector<std::thread> threads;
+
+        auto start = std::chrono::steady_clock::now();
+        for (uint32 i = 0; i < threadCount; ++i)
+            threads.emplace_back(RunLogins, mode, std::cref(account), loginsPerThread, std::ref(results[i]));
+        for (auto& thread : threads)
+            thread.join();
+        double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        Result total;
+        for (Result const& result : results)
+        {
+            total.logins += result.logins;
+            total.failures += result.failures;
+            total.serverSeconds += result.serverSeconds;
+        }
+
+        double perThread = total.logins / total.serverSeconds;
+        printf("%-9s threads %2u  logins %7u  server %8.0f logins/s (%7.0f per thread)  %6.1f us/login  wall %6.2fs  failed proofs %u\n",
+               mode == Mode::Srp6 ? "srp6" : "reference", threadCount, total.logins, perThread * threadCount, perThread,
+               1e6 / perThread, wall, total.failures);
+
+        return total.failures == 0;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    uint32 threadCount = argc > 1 ? uint32(atoi(argv[1])) : std::max(1u, std::thread::hardware_concurrency());
+    uint32 loginsPerThread = argc > 2 ? uint32(atoi(argv[2])) : 5000;
+    std::string mode = argc > 3 ? argv[3] : "both";
+
+    if (!threadCount || !loginsPerThread || (mode != "srp6" && mode != "reference" && mode != "both"))
+    {
+        printf("Usage: %s [threads] [logins per thread] [srp6|reference|both]\n", argv[0]);
+        return 1;
+    }
+
+    Account account = CreateAccount();
+
+    bool ok = true;
+    if (mode != "reference")
+        ok = RunStorm(Mode::Srp6, account, threadCount, loginsPerThread) && ok;
+    if (mode != "srp6")
+        ok = RunStorm(Mode::Reference, account, threadCount, loginsPerThread) && ok;
+
+    return ok ? 0 : 2;
+}
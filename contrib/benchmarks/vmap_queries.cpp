@@ -0,0 +1,198 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * Replays line of sight and height queries over one loaded vmap tile.
+ *
+ * Casters are placed on the ground at random points of the tile, each with a group of targets around it,
+ * the way Spell::FillUnitTargets asks for line of sight. Every group is checked once ray by ray through
+ * VMapManager2::isInLineOfSight (BIH::intersectRay) and once as a batch (BIH::intersectRays packets), and
+ * the two must agree on every ray. The ground height under every caster and target is replayed as well.
+ *
+ * Usage: vmap_queries <vmaps dir> <map id> <tile x> <tile y> [casters] [targets per caster]
+ * The tile coordinates are grid coordinates, as in the vmaps/<map>_<y>_<x>.vmtile file names.
+ */
+
+#include "VMapManager2.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+    float const SIZE_OF_GRIDS = 533.33333f;
+    float const MAX_HEIGHT = 100000.0f;
+    float const MAX_FALL_DISTANCE = 250000.0f;
+    float const DEFAULT_HEIGHT_SEARCH = 10.0f;
+    float const EYE_HEIGHT = 2.0f;                          // rays start and end above the ground, like unit positions
+    float const TARGET_RANGE = 40.0f;
+    uint32 const PASSES = 5;
+
+    typedef std::chrono::steady_clock Clock;
+
+    double Milliseconds(Clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    struct Point
+    {
+        float x, y, z;
+    };
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 5)
+    {
+        printf("Usage: %s <vmaps dir> <map id> <tile x> <tile y> [casters] [targets per caster]\n", argv[0]);
+        return 1;
+    }
+
+    std::string basePath = argv[1];
+    uint32 mapId = uint32(atoi(argv[2]));
+    int tileX = atoi(argv[3]);
+    int tileY = atoi(argv[4]);
+    uint32 casterCount = argc > 5 ? uint32(atoi(argv[5])) : 2000;
+    uint32 targetCount = argc > 6 ? uint32(atoi(argv[6])) : 16;
+
+    if (!casterCount || !targetCount)
+    {
+        printf("casters and targets per caster must be positive\n");
+        return 1;
+    }
+
+    VMAP::VMapManager2 vmgr;
+    if (vmgr.loadMap(basePath.c_str(), mapId, tileX, tileY) != VMAP::VMAP_LOAD_RESULT_OK)
+    {
+        printf("Could not load vmap tile %u [%i,%i] from '%s'\n", mapId, tileX, tileY, basePath.c_str());
+        return 1;
+    }
+
+    // grid tileX covers the world x range ((31 - tileX) * SIZE_OF_GRIDS, (32 - tileX) * SIZE_OF_GRIDS], same for y
+    float minX = (31 - tileX) * SIZE_OF_GRIDS;
+    float minY = (31 - tileY) * SIZE_OF_GRIDS;
+
+    std::mt19937 rng(tileX * 64 + tileY);
+    std::uniform_real_distribution<float> inTile(0.0f, SIZE_OF_GRIDS);
+    std::uniform_real_distribution<float> aroundCaster(-TARGET_RANGE, TARGET_RANGE);
+
+    // ground points: the first point of every group is the caster, the others its targets
+    std::vector<Point> points;
+    uint32 misses = 0;
+    while (points.size() < casterCount * (targetCount + 1) && misses < casterCount * 100)
+    {
+        float x = minX + inTile(rng);
+        float y = minY + inTile(rng);
+        float ground = vmgr.getHeight(mapId, x, y, MAX_HEIGHT, MAX_FALL_DISTANCE);
+        if (ground <= VMAP_INVALID_HEIGHT)
+        {
+            ++misses;
+            continue;
+        }
+
+        points.push_back({ x, y, ground + EYE_HEIGHT });
+        for (uint32 i = 0; i < targetCount; ++i)
+        {
+            float tx = x + aroundCaster(rng);
+            float ty = y + aroundCaster(rng);
+            float tz = vmgr.getHeight(mapId, tx, ty, ground + TARGET_RANGE, 2 * TARGET_RANGE);
+            points.push_back({ tx, ty, (tz > VMAP_INVALID_HEIGHT ? tz : ground) + EYE_HEIGHT });
+        }
+    }
+
+    uint32 groups = points.size() / (targetCount + 1);
+    if (!groups)
+    {
+        printf("No vmap geometry found under tile %u [%i,%i]\n", mapId, tileX, tileY);
+        return 1;
+    }
+
+    printf("map %u tile [%i,%i]: %u casters, %u targets each, %u line of sight rays per pass, %u passes\n",
+           mapId, tileX, tileY, groups, targetCount, groups * targetCount, PASSES);
+
+    std::vector<VMAP::LineOfSightQuery> queries(groups * targetCount);
+    for (uint32 g = 0; g < groups; ++g)
+    {
+        Point const& caster = points[g * (targetCount + 1)];
+        for (uint32 i = 0; i < targetCount; ++i)
+        {
+            Point const& target = points[g * (targetCount + 1) + 1 + i];
+            queries[g * targetCount + i] = { caster.x, caster.y, caster.z, target.x, target.y, target.z, 1, true };
+        }
+    }
+
+    uint32 mismatches = 0;
+    for (bool ignoreM2Model : { false, true })
+    {
+        std::vector<bool> single(queries.size());
+        double singleMs = 0.0;
+        double batchedMs = 0.0;
+        uint32 blocked = 0;
+
+        for (uint32 pass = 0; pass < PASSES; ++pass)
+        {
+            Clock::time_point start = Clock::now();
+            for (size_t i = 0; i < queries.size(); ++i)
+            {
+                VMAP::LineOfSightQuery const& q = queries[i];
+                single[i] = vmgr.isInLineOfSight(mapId, q.x1, q.y1, q.z1, q.x2, q.y2, q.z2, ignoreM2Model);
+            }
+            singleMs += Milliseconds(start);
+
+            start = Clock::now();
+            for (uint32 g = 0; g < groups; ++g)
+                vmgr.isInLineOfSight(mapId, &queries[g * targetCount], targetCount, ignoreM2Model);
+            batchedMs += Milliseconds(start);
+
+            for (size_t i = 0; i < queries.size(); ++i)
+            {
+                if (queries[i].result != single[i])
+                    ++mismatches;
+                if (pass == 0 && !single[i])
+                    ++blocked;
+            }
+        }
+
+        uint32 rays = queries.size() * PASSES;
+        printf("line of sight%s: %u of %u blocked  single %8.1f ns/ray  batched %8.1f ns/ray  (%.2fx)\n",
+               ignoreM2Model ? " (ignore M2)" : "            ", blocked, uint32(queries.size()),
+               singleMs * 1e6 / rays, batchedMs * 1e6 / rays, singleMs / batchedMs);
+    }
+
+    double heightMs = 0.0;
+    uint32 found = 0;
+    for (uint32 pass = 0; pass < PASSES; ++pass)
+    {
+        Clock::time_point start = Clock::now();
+        for (Point const& p : points)
+        {
+            if (vmgr.getHeight(mapId, p.x, p.y, p.z, DEFAULT_HEIGHT_SEARCH) > VMAP_INVALID_HEIGHT)
+                ++found;
+        }
+        heightMs += Milliseconds(start);
+    }
+    printf("height: %u of %u found  %8.1f ns/query\n", found / PASSES, uint32(points.size()), heightMs * 1e6 / (points.size() * PASSES));
+
+    printf("packet walk vs intersectRay mismatches: %u\n", mismatches);
+    return mismatches ? 2 : 0;
+}
@@ -23,6 +23,9 @@
 #include "Errors.h"
 #include "Entities/Player.h"
 
+#include <algorithm>
+#include <iterator>
+
 Camera::Camera(Player* pl) : m_owner(*pl), m_source(pl)
 {
     m_source->GetViewPoint().Attach(this);
@@ -143,11 +146,85 @@ template void Camera::UpdateVisibilityOf(Corpse*, UpdateData&, WorldObjectSet&);
 template void Camera::UpdateVisibilityOf(GameObject*, UpdateData&, WorldObjectSet&);
 template void Camera::UpdateVisibilityOf(DynamicObject*, UpdateData&, WorldObjectSet&);
 
+// ids of the cells lying entirely within radius of x, y, in ascending order
+static void GetInnerCells(float x, float y, float radius, std::vector<uint32>& cells)
+{
+    cells.clear();
+
+    CellArea area = Cell::CalculateCellArea(x, y, radius);
+    for (uint32 cellY = area.low_bound.y_coord; cellY <= area.high_bound.y_coord; ++cellY)
+    {
+        // cell n covers the coordinates [(n - CENTER_GRID_CELL_ID) * SIZE_OF_GRID_CELL, (n - CENTER_GRID_CELL_ID + 1) * SIZE_OF_GRID_CELL)
+        double lowY = (double(cellY) - CENTER_GRID_CELL_ID) * SIZE_OF_GRID_CELL;
+        double dy = std::max(std::fabs(y - lowY), std::fabs(y - (lowY + SIZE_OF_GRID_CELL)));
+
+        for (uint32 cellX = area.low_bound.x_coord; cellX <= area.high_bound.x_coord; ++cellX)
+        {
+            double lowX = (double(cellX) - CENTER_GRID_CELL_ID) * SIZE_OF_GRID_CELL;
+            double dx = std::max(std::fabs(x - lowX), std::fabs(x - (lowX + SIZE_OF_GRID_CELL)));
+
+            if (dx * dx + dy * dy < double(radius) * radius)
+                cells.push_back(cellY * TOTAL_NUMBER_OF_CELLS_PER_MAP + cellX);
+        }
+    }
+}
+
 void Camera::UpdateVisibilityForOwner(bool addToWorld)
 {
     MaNGOS::VisibleNotifier notifier(*this);
     Cell::VisitAllObjects(m_source, notifier, addToWorld ? MAX_VISIBILITY_DISTANCE : m_source->GetVisibilityData().GetVisibilityDistance(), false);
     notifier.Notify();
+
+    // everything in range was evaluated, a following move only has to look at the cells that were not entirely in range
+    if (m_source == &m_owner)
+        GetInnerCells(m_source->GetPositionX(), m_source->GetPositionY(), m_source->GetVisibilityData().GetVisibilityDistance(), m_innerCells);
+    else
+        m_innerCells.clear();
+}
+
+void Camera::UpdateVisibilityForMovedOwner()
+{
+    // only for an alive player outside GM mode looking through its own eyes the visibility of most objects depends on
+    // nothing but their distance and their own state, and they update the players around them when their state changes.
+    // Any change of the player's own state does a full update
+    if (m_source != &m_owner || !m_owner.IsAlive() || m_owner.IsGameMaster() || m_innerCells.empty())
+    {
+        UpdateVisibilityForOwner();
+        return;
+    }
+
+    float x = m_source->GetPositionX();
+    float y = m_source->GetPositionY();
+    float radius = m_source->GetVisibilityData().GetVisibilityDistance();
+
+    std::vector<uint32> innerCells;
+    GetInnerCells(x, y, radius, innerCells);
+
+    // cells entirely in range before and after the move: the move changed the visibility of nothing in them
+    std::vector<uint32> skippedCells;
+    std::set_intersection(m_innerCells.begin(), m_innerCells.end(), innerCells.begin(), innerCells.end(), std::back_inserter(skippedCells));
+    m_innerCells.swap(innerCells);
+
+    MaNGOS::VisibleNotifier notifier(*this, &skippedCells);
+    TypeContainerVisitor<MaNGOS::VisibleNotifier, GridTypeMapContainer > gridVisitor(notifier);
+    TypeContainerVisitor<MaNGOS::VisibleNotifier, WorldTypeMapContainer > worldVisitor(notifier);
+
+    Map& map = *m_source->GetMap();
+    CellArea area = Cell::CalculateCellArea(x, y, radius + m_source->GetObjectBoundingRadius());
+    for (uint32 cellY = area.low_bound.y_coord; cellY <= area.high_bound.y_coord; ++cellY)
+    {
+        for (uint32 cellX = area.low_bound.x_coord; cellX <= area.high_bound.x_coord; ++cellX)
+        {
+            if (std::binary_search(skippedCells.begin(), skippedCells.end(), cellY * TOTAL_NUMBER_OF_CELLS_PER_MAP + cellX))
+                continue;
+
+            Cell cell(CellPair(cellX, cellY));
+            map.Visit(cell, gridVisitor);
+            map.Visit(cell, worldVisitor);
+        }
+    }
+
+    notifier.Notify();
 }
 
 //////////////////
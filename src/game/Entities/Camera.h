@@ -56,6 +56,8 @@ class Camera
         // updates visibility of worldobjects around viewpoint for camera's owner
         void UpdateVisibilityForOwner() { UpdateVisibilityForOwner(false); }
         void UpdateVisibilityForOwner(bool addToWorld);
+        // same after the viewpoint moved, cells that stayed entirely in visibility range are not visited again
+        void UpdateVisibilityForMovedOwner();
 
     private:
         // called when viewpoint changes visibility state
@@ -66,6 +68,7 @@ class Camera
 
         Player& m_owner;
         WorldObject* m_source;
+        std::vector<uint32> m_innerCells;                   // sorted ids of the cells entirely in visibility range at the last update
 
         void UpdateForCurrentViewPoint();
 
@@ -136,6 +139,11 @@ class ViewPoint
         {
             CameraCall(&Camera::UpdateVisibilityForOwner);
         }
+
+        void Call_UpdateVisibilityForMovedOwner()
+        {
+            CameraCall(&Camera::UpdateVisibilityForMovedOwner);
+        }
 };
 
 #endif
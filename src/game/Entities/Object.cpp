@@ -47,13 +47,14 @@
 #include "Spells/SpellMgr.h"
 #include "MotionGenerators/PathFinder.h"
 
-Object::Object(): m_updateFlag(0), m_itsNewObject(false)
+Object::Object(): m_updateFlag(0), m_itsNewObject(false), m_clientUpdateList(nullptr), m_clientUpdatePrev(nullptr), m_clientUpdateNext(nullptr)
 {
     m_objectTypeId      = TYPEID_OBJECT;
     m_objectType        = TYPEMASK_OBJECT;
 
     m_uint32Values      = nullptr;
     m_valuesCount       = 0;
+    m_changedBlocks     = 0;
 
     m_inWorld           = false;
     m_objectUpdated     = false;
@@ -75,17 +76,93 @@ Object::~Object()
         MANGOS_ASSERT(false);
     }
 
+    if (ClientUpdateList* list = m_clientUpdateList)
+        list->Remove(this);
+
     delete[] m_uint32Values;
 
     delete m_loot;
 }
 
+ClientUpdateList::~ClientUpdateList()
+{
+    while (PopFront()) {}
+}
+
+void ClientUpdateList::Add(Object* obj)
+{
+    ClientUpdateList* list = obj->m_clientUpdateList;
+    if (list == this)
+        return;
+
+    if (list)
+        Remove(obj);
+
+    std::lock_guard<std::mutex> guard(m_lock);
+    if (obj->m_clientUpdateList)                            // queued meanwhile by another thread
+        return;
+
+    obj->m_clientUpdateList = this;
+    obj->m_clientUpdatePrev = m_tail;
+    obj->m_clientUpdateNext = nullptr;
+
+    if (m_tail)
+        m_tail->m_clientUpdateNext = obj;
+    else
+        m_head = obj;
+    m_tail = obj;
+}
+
+void ClientUpdateList::Remove(Object* obj)
+{
+    // the object can be popped or moved by the thread owning its list until that list is locked
+    while (ClientUpdateList* list = obj->m_clientUpdateList)
+    {
+        std::lock_guard<std::mutex> guard(list->m_lock);
+        if (obj->m_clientUpdateList == list)
+        {
+            list->Unlink(obj);
+            return;
+        }
+    }
+}
+
+void ClientUpdateList::Unlink(Object* obj)
+{
+    ClientUpdateList* list = obj->m_clientUpdateList;
+
+    if (obj->m_clientUpdatePrev)
+        obj->m_clientUpdatePrev->m_clientUpdateNext = obj->m_clientUpdateNext;
+    else
+        list->m_head = obj->m_clientUpdateNext;
+
+    if (obj->m_clientUpdateNext)
+        obj->m_clientUpdateNext->m_clientUpdatePrev = obj->m_clientUpdatePrev;
+    else
+        list->m_tail = obj->m_clientUpdatePrev;
+
+    obj->m_clientUpdateList = nullptr;
+    obj->m_clientUpdatePrev = nullptr;
+    obj->m_clientUpdateNext = nullptr;
+}
+
+Object* ClientUpdateList::PopFront()
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    Object* obj = m_head;
+    if (obj)
+        Unlink(obj);
+    return obj;
+}
+
 void Object::_InitValues()
 {
     m_uint32Values = new uint32[ m_valuesCount ];
     memset(m_uint32Values, 0, m_valuesCount * sizeof(uint32));
 
-    m_changedValues.resize(m_valuesCount, false);
+    static_assert((PLAYER_END + 31) / 32 <= 64, "m_changedBlocks holds one bit per block of 32 fields");
+    m_changedValues.assign((m_valuesCount + 31) / 32, 0);
+    m_changedBlocks = 0;
 
     m_objectUpdated = false;
 }
@@ -516,7 +593,7 @@ void Object::BuildValuesUpdate(uint8 updatetype, ByteBuffer* data, UpdateMask* u
     // 2 specialized loops for speed optimization in non-unit case
     if (isType(TYPEMASK_UNIT))                              // unit (creature/player) case
     {
-        for (uint16 index = 0; index < m_valuesCount; ++index)
+        for (uint16 index = updateMask->FindNextBit(0); index < m_valuesCount; index = updateMask->FindNextBit(index + 1))
         {
             if (updateMask->GetBit(index))
             {
@@ -765,7 +842,7 @@ void Object::BuildValuesUpdate(uint8 updatetype, ByteBuffer* data, UpdateMask* u
     }
     else if (isType(TYPEMASK_CORPSE))                       // corpse case
     {
-        for (uint16 index = 0; index < m_valuesCount; ++index)
+        for (uint16 index = updateMask->FindNextBit(0); index < m_valuesCount; index = updateMask->FindNextBit(index + 1))
         {
             if (updateMask->GetBit(index))
             {
@@ -798,7 +875,7 @@ void Object::BuildValuesUpdate(uint8 updatetype, ByteBuffer* data, UpdateMask* u
     }
     else if (isType(TYPEMASK_GAMEOBJECT))                   // gameobject case
     {
-        for (uint16 index = 0; index < m_valuesCount; ++index)
+        for (uint16 index = updateMask->FindNextBit(0); index < m_valuesCount; index = updateMask->FindNextBit(index + 1))
         {
             if (updateMask->GetBit(index))
             {
@@ -862,7 +939,7 @@ void Object::BuildValuesUpdate(uint8 updatetype, ByteBuffer* data, UpdateMask* u
     }
     else                                                    // other objects case (no special index checks)
     {
-        for (uint16 index = 0; index < m_valuesCount; ++index)
+        for (uint16 index = updateMask->FindNextBit(0); index < m_valuesCount; index = updateMask->FindNextBit(index + 1))
         {
             if (updateMask->GetBit(index))
             {
@@ -877,8 +954,9 @@ void Object::ClearUpdateMask(bool remove)
 {
     if (m_uint32Values)
     {
-        for (uint16 index = 0; index < m_valuesCount; ++index)
-            m_changedValues[index] = false;
+        for (uint32 block = 0; m_changedBlocks; ++block, m_changedBlocks >>= 1)
+            if (m_changedBlocks & 1)
+                m_changedValues[block] = 0;
     }
 
     if (m_objectUpdated)
@@ -973,9 +1051,19 @@ void Object::_SetUpdateBits(UpdateMask& updateMask, Player* target) const
     uint16 visibleFlag = GetUpdateFieldFlagsForTarget(target, flags);
     MANGOS_ASSERT(flags);
 
-    for (uint16 index = 0; index < m_valuesCount; ++index)
-        if (m_changedValues[index] && (flags[index] & visibleFlag))
-            updateMask.SetBit(index);
+    // 32 fields at a time and only the blocks with changes, cost follows the changed fields not the field count
+    UpdateFieldFlagBlocks const* flagBlocks = UpdateFields::GetUpdateFieldFlagBlocks(GetTypeId());
+    MANGOS_ASSERT(flagBlocks);
+
+    uint64 changedBlocks = m_changedBlocks;
+    for (uint32 block = 0; changedBlocks; ++block, changedBlocks >>= 1)
+    {
+        if (!(changedBlocks & 1))
+            continue;
+
+        if (uint32 bits = m_changedValues[block] & flagBlocks->GetVisibleBlock(visibleFlag, block))
+            updateMask.SetBlock(block, bits);
+    }
 }
 
 void Object::_SetCreateBits(UpdateMask& updateMask, Player* target) const
@@ -996,7 +1084,7 @@ void Object::SetInt32Value(uint16 index, int32 value)
     if (m_int32Values[index] != value)
     {
         m_int32Values[index] = value;
-        m_changedValues[index] = true;
+        MarkChangedValue(index);
         MarkForClientUpdate();
     }
 }
@@ -1008,7 +1096,7 @@ void Object::SetUInt32Value(uint16 index, uint32 value)
     if (m_uint32Values[index] != value)
     {
         m_uint32Values[index] = value;
-        m_changedValues[index] = true;
+        MarkChangedValue(index);
         MarkForClientUpdate();
     }
 }
@@ -1020,8 +1108,8 @@ void Object::SetUInt64Value(uint16 index, const uint64& value)
     {
         m_uint32Values[index] = *((uint32*)&value);
         m_uint32Values[index + 1] = *(((uint32*)&value) + 1);
-        m_changedValues[index] = true;
-        m_changedValues[index + 1] = true;
+        MarkChangedValue(index);
+        MarkChangedValue(index + 1);
         MarkForClientUpdate();
     }
 }
@@ -1033,7 +1121,7 @@ void Object::SetFloatValue(uint16 index, float value)
     if (m_floatValues[index] != value)
     {
         m_floatValues[index] = value;
-        m_changedValues[index] = true;
+        MarkChangedValue(index);
         MarkForClientUpdate();
     }
 }
@@ -1052,7 +1140,7 @@ void Object::SetByteValue(uint16 index, uint8 offset, uint8 value)
     {
         m_uint32Values[index] &= ~uint32(uint32(0xFF) << (offset * 8));
         m_uint32Values[index] |= uint32(uint32(value) << (offset * 8));
-        m_changedValues[index] = true;
+        MarkChangedValue(index);
         MarkForClientUpdate();
     }
 }
@@ -1071,7 +1159,7 @@ void Object::SetUInt16Value(uint16 index, uint8 offset, uint16 value)
     {
         m_uint32Values[index] &= ~uint32(uint32(0xFFFF) << (offset * 16));
         m_uint32Values[index] |= uint32(uint32(value) << (offset * 16));
-        m_changedValues[index] = true;
+        MarkChangedValue(index);
         MarkForClientUpdate();
     }
 }
@@ -1133,7 +1221,7 @@ void Object::SetFlag(uint16 index, uint32 newFlag)
     if (oldval != newval)
     {
         m_uint32Values[index] = newval;
-        m_changedValues[index] = true;
+        MarkChangedValue(index);
         MarkForClientUpdate();
     }
 }
@@ -1147,7 +1235,7 @@ void Object::RemoveFlag(uint16 index, uint32 oldFlag)
     if (oldval != newval)
     {
         m_uint32Values[index] = newval;
-        m_changedValues[index] = true;
+        MarkChangedValue(index);
         MarkForClientUpdate();
     }
 }
@@ -1165,7 +1253,7 @@ void Object::SetByteFlag(uint16 index, uint8 offset, uint8 newFlag)
     if (!(uint8(m_uint32Values[index] >> (offset * 8)) & newFlag))
     {
         m_uint32Values[index] |= uint32(uint32(newFlag) << (offset * 8));
-        m_changedValues[index] = true;
+        MarkChangedValue(index);
         MarkForClientUpdate();
     }
 }
@@ -1183,7 +1271,7 @@ void Object::RemoveByteFlag(uint16 index, uint8 offset, uint8 oldFlag)
     if (uint8(m_uint32Values[index] >> (offset * 8)) & oldFlag)
     {
         m_uint32Values[index] &= ~uint32(uint32(oldFlag) << (offset * 8));
-        m_changedValues[index] = true;
+        MarkChangedValue(index);
         MarkForClientUpdate();
     }
 }
@@ -1195,7 +1283,7 @@ void Object::SetShortFlag(uint16 index, bool highpart, uint16 newFlag)
     if (!(uint16(m_uint32Values[index] >> (highpart ? 16 : 0)) & newFlag))
     {
         m_uint32Values[index] |= uint32(uint32(newFlag) << (highpart ? 16 : 0));
-        m_changedValues[index] = true;
+        MarkChangedValue(index);
         MarkForClientUpdate();
     }
 }
@@ -1207,7 +1295,7 @@ void Object::RemoveShortFlag(uint16 index, bool highpart, uint16 oldFlag)
     if (uint16(m_uint32Values[index] >> (highpart ? 16 : 0)) & oldFlag)
     {
         m_uint32Values[index] &= ~uint32(uint32(oldFlag) << (highpart ? 16 : 0));
-        m_changedValues[index] = true;
+        MarkChangedValue(index);
         MarkForClientUpdate();
     }
 }
@@ -1228,7 +1316,7 @@ bool Object::PrintEntryError(char const* descr) const
     return false;
 }
 
-void Object::BuildUpdateDataForPlayer(Player* pl, UpdateDataMapType& update_players) const
+void Object::BuildUpdateDataForPlayer(Player* pl, UpdateDataMapType& update_players, SharedUpdateBlocks* sharedBlocks) const
 {
     UpdateDataMapType::iterator iter = update_players.find(pl);
 
@@ -1239,7 +1327,84 @@ void Object::BuildUpdateDataForPlayer(Player* pl, UpdateDataMapType& update_play
         iter = p.first;
     }
 
-    BuildValuesUpdateBlockForPlayer(iter->second, iter->first);
+    if (!sharedBlocks)
+    {
+        BuildValuesUpdateBlockForPlayer(iter->second, iter->first);
+        return;
+    }
+
+    // observers of the same class receive the same bytes, serialize only for the first of them
+    uint32 updateClass = GetValuesUpdateClassForTarget(pl);
+    for (auto const& block : *sharedBlocks)
+    {
+        if (block.first == updateClass)
+        {
+            if (!block.second.empty())
+                iter->second.AddUpdateBlock(block.second);
+            return;
+        }
+    }
+
+    sharedBlocks->emplace_back(updateClass, ByteBuffer());
+    ByteBuffer& buf = sharedBlocks->back().second;
+
+    UpdateMask updateMask;
+    updateMask.SetCount(m_valuesCount);
+    _SetUpdateBits(updateMask, pl);
+    if (!updateMask.HasData())
+        return;                                             // empty block, nothing visible for this class
+
+    buf << uint8(UPDATETYPE_VALUES);
+    buf << GetPackGUID();
+    BuildValuesUpdate(UPDATETYPE_VALUES, &buf, &updateMask, pl);
+    iter->second.AddUpdateBlock(buf);
+}
+
+bool Object::IsValuesUpdateTargetDependent() const
+{
+    // GAMEOBJECT_DYNAMIC is part of every values update and depends on the quests of the target
+    if (isType(TYPEMASK_GAMEOBJECT))
+        return !static_cast<GameObject const*>(this)->IsDynTransport();
+
+    if (isType(TYPEMASK_UNIT))
+    {
+        // per caster aura state, loot/tap/track flags and trainer/flightmaster flags are computed per target
+        if (static_cast<Unit const*>(this)->HasAuraState(AURA_STATE_CONFLAGRATE) || IsChangedValue(UNIT_DYNAMIC_FLAGS))
+            return true;
+
+        if (GetTypeId() == TYPEID_UNIT)
+            return IsChangedValue(UNIT_NPC_FLAGS);
+
+        // [XFACTION]: faction is altered for crossfaction group members
+        return IsChangedValue(UNIT_FIELD_FACTIONTEMPLATE) && sWorld.getConfig(CONFIG_BOOL_ALLOW_TWO_SIDE_INTERACTION_GROUP);
+    }
+
+    // [XFACTION]: race is altered for crossfaction group members
+    if (isType(TYPEMASK_CORPSE))
+        return IsChangedValue(CORPSE_FIELD_BYTES_1) && sWorld.getConfig(CONFIG_BOOL_ALLOW_TWO_SIDE_INTERACTION_GROUP);
+
+    return false;
+}
+
+uint32 Object::GetValuesUpdateClassForTarget(Player const* target) const
+{
+    uint16 const* flags = nullptr;
+    uint32 updateClass = GetUpdateFieldFlagsForTarget(target, flags);
+
+    // remaining per target alterations of BuildValuesUpdate, the target itself always has its own class (UF_FLAG_PRIVATE)
+    if (isType(TYPEMASK_UNIT))
+    {
+        Unit const* unit = static_cast<Unit const*>(this);
+
+        if (IsChangedValue(UNIT_FIELD_HEALTH) || IsChangedValue(UNIT_FIELD_MAXHEALTH))
+            if (unit->IsFogOfWarVisibleHealth(target) || target->CanSeeSpecialInfoOf(unit))
+                updateClass |= 0x10000;                     // absolute health values instead of percentages
+
+        if (IsChangedValue(UNIT_FIELD_FLAGS) && target->IsGameMaster())
+            updateClass |= 0x20000;                         // selectable for gamemasters
+    }
+
+    return updateClass;
 }
 
 void Object::AddToClientUpdateList()
@@ -1274,7 +1439,7 @@ void Object::MarkForClientUpdate()
 
 void Object::ForceValuesUpdateAtIndex(uint16 index)
 {
-    m_changedValues[index] = true;
+    MarkChangedValue(index);
     if (m_inWorld && !m_objectUpdated)
     {
         AddToClientUpdateList();
@@ -2580,12 +2745,13 @@ struct WorldObjectChangeAccumulator
 {
     UpdateDataMapType& i_updateDatas;
     WorldObject& i_object;
-    WorldObjectChangeAccumulator(WorldObject& obj, UpdateDataMapType& d) : i_updateDatas(d), i_object(obj)
+    SharedUpdateBlocks* i_sharedBlocks;
+    WorldObjectChangeAccumulator(WorldObject& obj, UpdateDataMapType& d, SharedUpdateBlocks* sharedBlocks) : i_updateDatas(d), i_object(obj), i_sharedBlocks(sharedBlocks)
     {
         // send self fields changes in another way, otherwise
         // with new camera system when player's camera too far from player, camera wouldn't receive packets and changes from player
         if (i_object.isType(TYPEMASK_PLAYER))
-            i_object.BuildUpdateDataForPlayer((Player*)&i_object, i_updateDatas);
+            i_object.BuildUpdateDataForPlayer((Player*)&i_object, i_updateDatas, i_sharedBlocks);
     }
 
     void Visit(CameraMapType& m)
@@ -2594,7 +2760,7 @@ struct WorldObjectChangeAccumulator
         {
             Player* owner = iter.getSource()->GetOwner();
             if (owner != &i_object && owner->HasAtClient(&i_object))
-                i_object.BuildUpdateDataForPlayer(owner, i_updateDatas);
+                i_object.BuildUpdateDataForPlayer(owner, i_updateDatas, i_sharedBlocks);
         }
     }
 
@@ -2603,7 +2769,9 @@ struct WorldObjectChangeAccumulator
 
 void WorldObject::BuildUpdateData(UpdateDataMapType& update_players)
 {
-    WorldObjectChangeAccumulator notifier(*this, update_players);
+    // a raid watching the same object mostly shares a handful of visibility classes, build each values block once
+    SharedUpdateBlocks sharedBlocks;
+    WorldObjectChangeAccumulator notifier(*this, update_players, IsValuesUpdateTargetDependent() ? nullptr : &sharedBlocks);
     Cell::VisitWorldObjects(this, notifier, GetVisibilityData().GetVisibilityDistance());
 
     ClearUpdateMask(false);
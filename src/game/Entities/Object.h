@@ -34,6 +34,8 @@
 #include "Grids/Cell.h"
 #include "Utilities/EventProcessor.h"
 
+#include <atomic>
+#include <mutex>
 #include <set>
 
 enum TempSpawnType
@@ -99,6 +101,7 @@ struct PlayPacketParameters
     };
 };
 
+class Object;
 class WorldPacket;
 class UpdateData;
 class WorldSession;
@@ -121,6 +124,36 @@ class GenericTransport;
 
 typedef std::unordered_map<Player*, UpdateData> UpdateDataMapType;
 
+// values update blocks of one object for the current tick, keyed by visibility class of the receiving players
+typedef std::vector<std::pair<uint32, ByteBuffer> > SharedUpdateBlocks;
+
+// objects with pending client updates of a map, linked through the objects themselves
+// so add/remove are O(1) and never allocate, objects are visited in the order they were dirtied.
+// An object may be queued by another map's thread than the one flushing the list holding it
+// (scripts, items of a teleported owner), so every list is guarded by its own lock
+class ClientUpdateList
+{
+    public:
+        ClientUpdateList() : m_head(nullptr), m_tail(nullptr) {}
+        ~ClientUpdateList();
+
+        void Add(Object* obj);
+        // unlinks from the list that holds the object, which is not necessarily this one (items of a teleported owner)
+        void Remove(Object* obj);
+        Object* PopFront();
+
+    private:
+        ClientUpdateList(ClientUpdateList const&);
+        ClientUpdateList& operator=(ClientUpdateList const&);
+
+        // unlinks obj from its list, must hold that list's lock
+        void Unlink(Object* obj);
+
+        std::mutex m_lock;
+        Object* m_head;
+        Object* m_tail;
+};
+
 // Spell cooldown flags sent in SMSG_SPELL_COOLDOWN
 enum SpellCooldownFlags
 {
@@ -628,7 +661,11 @@ class Object
 
         void BuildMovementUpdate(ByteBuffer* data, uint16 updateFlags) const;
         void BuildValuesUpdate(uint8 updatetype, ByteBuffer* data, UpdateMask* updateMask, Player* target) const;
-        void BuildUpdateDataForPlayer(Player* pl, UpdateDataMapType& update_players) const;
+        void BuildUpdateDataForPlayer(Player* pl, UpdateDataMapType& update_players, SharedUpdateBlocks* sharedBlocks = nullptr) const;
+
+        // values update differs per observer beyond its visibility class, blocks can't be shared
+        bool IsValuesUpdateTargetDependent() const;
+        uint32 GetValuesUpdateClassForTarget(Player const* target) const;
 
         uint16 m_objectType;
 
@@ -642,16 +679,33 @@ class Object
             float*  m_floatValues;
         };
 
-        std::vector<bool> m_changedValues;
+        // fields changed since the last client update, one bit per field in UpdateMask block layout
+        // and one bit per block holding any change, so update building only visits the changed blocks
+        std::vector<uint32> m_changedValues;
+        uint64 m_changedBlocks;
+
+        void MarkChangedValue(uint16 index)
+        {
+            m_changedValues[index >> 5] |= 1u << (index & 0x1F);
+            m_changedBlocks |= uint64(1) << (index >> 5);
+        }
+        bool IsChangedValue(uint16 index) const { return (m_changedValues[index >> 5] & (1u << (index & 0x1F))) != 0; }
 
         uint16 m_valuesCount;
 
         bool m_objectUpdated;
 
     private:
+        friend class ClientUpdateList;
+
         bool m_inWorld;
         bool m_itsNewObject;
 
+        // ClientUpdateList hook, m_clientUpdateList only changes under the lock of the list it points to
+        std::atomic<ClientUpdateList*> m_clientUpdateList;
+        Object* m_clientUpdatePrev;
+        Object* m_clientUpdateNext;
+
         PackedGuid m_PackGUID;
 
         Object(const Object&);                              // prevent generation copy constructor
@@ -18,8 +18,10 @@
 
 #include "Entities/ObjectGuid.h"
 
+#ifndef NO_CORE_FUNCS
 #include "World/World.h"
 #include "Globals/ObjectMgr.h"
+#endif
 
 #include <sstream>
 
@@ -44,6 +46,7 @@ char const* ObjectGuid::GetTypeName(HighGuid high)
     }
 }
 
+#ifndef NO_CORE_FUNCS
 std::string ObjectGuid::GetString() const
 {
     std::ostringstream str;
@@ -73,6 +76,7 @@ uint32 ObjectGuidGenerator<high>::Generate()
     }
     return m_nextGuid++;
 }
+#endif
 
 ByteBuffer& operator<< (ByteBuffer& buf, ObjectGuid const& guid)
 {
@@ -98,6 +102,7 @@ ByteBuffer& operator>>(ByteBuffer& buf, PackedGuidReader const& guid)
     return buf;
 }
 
+#ifndef NO_CORE_FUNCS
 template uint32 ObjectGuidGenerator<HIGHGUID_ITEM>::Generate();
 template uint32 ObjectGuidGenerator<HIGHGUID_PLAYER>::Generate();
 template uint32 ObjectGuidGenerator<HIGHGUID_GAMEOBJECT>::Generate();
@@ -109,3 +114,4 @@ template uint32 ObjectGuidGenerator<HIGHGUID_DYNAMICOBJECT>::Generate();
 template uint32 ObjectGuidGenerator<HIGHGUID_CORPSE>::Generate();
 template uint32 ObjectGuidGenerator<HIGHGUID_INSTANCE>::Generate();
 template uint32 ObjectGuidGenerator<HIGHGUID_GROUP>::Generate();
+#endif
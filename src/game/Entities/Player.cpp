@@ -76,6 +76,10 @@
 #include "Config/Config.h"
 #endif
 
+#ifdef BUILD_METRICS
+ #include "Metric/Metric.h"
+#endif
+
 #include <cmath>
 
 #define ZONE_UPDATE_INTERVAL (1*IN_MILLISECONDS)
@@ -497,7 +501,11 @@ void TradeData::SetAccepted(bool state, bool crosssend /*= false*/)
 }
 
 //== Player ====================================================
-Player::Player(WorldSession* session): Unit(), m_taxiTracker(*this), m_mover(this), m_camera(this), m_achievementMgr(this), m_reputationMgr(this), m_launched(false)
+Player::Player(WorldSession* session): Unit(), m_taxiTracker(*this), m_mover(this), m_camera(this), m_achievementMgr(this), m_reputationMgr(this), m_launched(false),
+    m_auraSaveState("character_aura", "guid, caster_guid, item_guid, spell, stackcount, remaincharges, basepoints0, basepoints1, basepoints2, "
+                    "periodictime0, periodictime1, periodictime2, maxduration, effIndexMask", "remaintime"),
+    m_cooldownSaveState("character_spell_cooldown", "guid, SpellId, SpellExpireTime, Category, CategoryExpireTime, ItemId"),
+    m_instanceTimerSaveState("account_instances_entered", "AccountId, ExpireTime, InstanceId")
 {
 #ifdef BUILD_PLAYERBOT
     m_playerbotAI = 0;
@@ -4038,16 +4046,8 @@ void Player::_LoadSpellCooldowns(QueryResult* result)
     }
 }
 
-void Player::_SaveSpellCooldowns()
+uint32 Player::_SaveSpellCooldowns()
 {
-    static SqlStatementID deleteSpellCooldown;
-
-    // delete all old cooldown
-    SqlStatement stmt = CharacterDatabase.CreateStatement(deleteSpellCooldown, "DELETE FROM character_spell_cooldown WHERE guid = ?");
-    stmt.PExecute(GetGUIDLow());
-
-    static SqlStatementID insertSpellCooldown;
-
     for (auto& cdItr : m_cooldownMap)
     {
         auto& cdData = cdItr.second;
@@ -4060,16 +4060,17 @@ void Player::_SaveSpellCooldowns()
             uint64 spellExpireTime = uint64(Clock::to_time_t(sTime));
             uint64 catExpireTime = uint64(Clock::to_time_t(cTime));
 
-            stmt = CharacterDatabase.CreateStatement(insertSpellCooldown, "INSERT INTO character_spell_cooldown (guid, SpellId, SpellExpireTime, Category, CategoryExpireTime, ItemId) VALUES( ?, ?, ?, ?, ?, ?)");
-            stmt.addUInt32(GetGUIDLow());
-            stmt.addUInt32(cdData->GetSpellId());
-            stmt.addUInt64(spellExpireTime);
-            stmt.addUInt32(cdData->GetCategory());
-            stmt.addUInt64(catExpireTime);
-            stmt.addUInt32(cdData->GetItemId());
-            stmt.Execute();
+            std::ostringstream key, values;
+            key << "SpellId = " << cdData->GetSpellId();
+            values << GetGUIDLow() << ", " << cdData->GetSpellId() << ", " << spellExpireTime << ", "
+                   << cdData->GetCategory() << ", " << catExpireTime << ", " << cdData->GetItemId();
+            m_cooldownSaveState.AddRow(key.str(), values.str());
         }
     }
+
+    std::ostringstream owner;
+    owner << "guid = " << GetGUIDLow();
+    return m_cooldownSaveState.Commit(CharacterDatabase, owner.str());
 }
 
 uint32 Player::resetTalentsCost() const
@@ -4570,7 +4571,7 @@ void Player::DeleteFromDB(ObjectGuid playerguid, uint32 accountId, bool updateRe
             QueryResult* resultFriend = CharacterDatabase.PQuery("SELECT DISTINCT guid FROM character_social WHERE friend = '%u'", lowguid);
 
             // NOW we can finally clear other DB data related to character
-            CharacterDatabase.BeginTransaction();
+            CharacterDatabase.BeginTransaction(lowguid);
             if (resultPets)
             {
                 do
@@ -18019,7 +18020,9 @@ void Player::SaveToDB()
     DEBUG_FILTER_LOG(LOG_FILTER_PLAYER_STATS, "The value of player %s at save: ", m_name.c_str());
     outDebugStatsValues();
 
-    CharacterDatabase.BeginTransaction();
+    // keyed by guid: saves of this character stay ordered, other characters may be saved in parallel.
+    // The account id orders the account wide rows (instance timers, tutorials) against the other characters of the account
+    CharacterDatabase.BeginTransaction(GetGUIDLow(), GetSession()->GetAccountId());
 
     static SqlStatementID delChar ;
     static SqlStatementID insChar ;
@@ -18192,11 +18195,11 @@ void Player::SaveToDB()
     _SaveWeeklyQuestStatus();
     _SaveMonthlyQuestStatus();
     _SaveSpells();
-    _SaveSpellCooldowns();
+    uint32 rowsWritten = _SaveSpellCooldowns();
     _SaveActions();
-    _SaveAuras();
+    rowsWritten += _SaveAuras();
     _SaveSkills();
-    _SaveNewInstanceIdTimer();
+    rowsWritten += _SaveNewInstanceIdTimer();
     m_achievementMgr.SaveToDB();
     m_reputationMgr.SaveToDB();
     _SaveEquipmentSets();
@@ -18206,6 +18209,14 @@ void Player::SaveToDB()
 
     CharacterDatabase.CommitTransaction();
 
+#ifdef BUILD_METRICS
+    metric::measurement meas("player.save");
+    meas.add_field("rows_written", std::to_string(rowsWritten));
+    meas.add_field("rows_unchanged", std::to_string(m_cooldownSaveState.GetUnchangedRows() + m_auraSaveState.GetUnchangedRows() + m_instanceTimerSaveState.GetUnchangedRows()));
+#else
+    (void)rowsWritten;
+#endif
+
     // check if stats should only be saved on logout
     // save stats can be out of transaction
     if (m_session->isLogingOut() || !sWorld.getConfig(CONFIG_BOOL_STATS_SAVE_ONLY_ON_LOGOUT))
@@ -18287,23 +18298,10 @@ void Player::_SaveActions()
     }
 }
 
-void Player::_SaveAuras()
+uint32 Player::_SaveAuras()
 {
-    static SqlStatementID deleteAuras ;
-    static SqlStatementID insertAuras ;
-
-    SqlStatement stmt = CharacterDatabase.CreateStatement(deleteAuras, "DELETE FROM character_aura WHERE guid = ?");
-    stmt.PExecute(GetGUIDLow());
-
     SpellAuraHolderMap const& auraHolders = GetSpellAuraHolderMap();
 
-    if (auraHolders.empty())
-        return;
-
-    stmt = CharacterDatabase.CreateStatement(insertAuras, "INSERT INTO character_aura (guid, caster_guid, item_guid, spell, stackcount, remaincharges, "
-            "basepoints0, basepoints1, basepoints2, periodictime0, periodictime1, periodictime2, maxduration, remaintime, effIndexMask) "
-            "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)");
-
     for (const auto& auraHolder : auraHolders)
     {
         SpellAuraHolder* holder = auraHolder.second;
@@ -18335,25 +18333,28 @@ void Player::_SaveAuras()
             if (!effIndexMask)
                 continue;
 
-            stmt.addUInt32(GetGUIDLow());
-            stmt.addUInt64(holder->GetCasterGuid().GetRawValue());
-            stmt.addUInt32(holder->GetCastItemGuid().GetCounter());
-            stmt.addUInt32(holder->GetId());
-            stmt.addUInt32(holder->GetStackAmount());
-            stmt.addUInt8(holder->GetAuraCharges());
+            std::ostringstream key, values;
+            key << "caster_guid = " << holder->GetCasterGuid().GetRawValue() << " AND item_guid = " << holder->GetCastItemGuid().GetCounter()
+                << " AND spell = " << holder->GetId();
+
+            values << GetGUIDLow() << ", " << holder->GetCasterGuid().GetRawValue() << ", " << holder->GetCastItemGuid().GetCounter() << ", "
+                   << holder->GetId() << ", " << holder->GetStackAmount() << ", " << uint32(holder->GetAuraCharges());
 
             for (int i : damage)
-                stmt.addInt32(i);
+                values << ", " << i;
 
             for (unsigned int i : periodicTime)
-                stmt.addUInt32(i);
+                values << ", " << i;
 
-            stmt.addInt32(holder->GetAuraMaxDuration());
-            stmt.addInt32(holder->GetAuraDuration());
-            stmt.addUInt32(effIndexMask);
-            stmt.Execute();
+            // the remaining time changes on every save, rows where only it changed are fixed with one UPDATE
+            values << ", " << holder->GetAuraMaxDuration() << ", " << effIndexMask;
+            m_auraSaveState.AddRow(key.str(), values.str(), std::to_string(holder->GetAuraDuration()));
         }
     }
+
+    std::ostringstream owner;
+    owner << "guid = " << GetGUIDLow();
+    return m_auraSaveState.Commit(CharacterDatabase, owner.str());
 }
 
 void Player::_SaveGlyphs()
@@ -21754,7 +21755,7 @@ void Player::AutoUnequipOffhandIfNeed(uint8 bag)
     else
     {
         MoveItemFromInventory(INVENTORY_SLOT_BAG_0, EQUIPMENT_SLOT_OFFHAND, true);
-        CharacterDatabase.BeginTransaction();
+        CharacterDatabase.BeginTransaction(GetGUIDLow());
         offItem->DeleteFromInventoryDB();                   // deletes item from character's inventory
         offItem->SaveToDB();                                // recursive and not have transaction guard into self, item not in inventory and can be save standalone
         CharacterDatabase.CommitTransaction();
@@ -24850,24 +24851,19 @@ void Player::_LoadCreatedInstanceTimers()
     }
 }
 
-void Player::_SaveNewInstanceIdTimer()
+uint32 Player::_SaveNewInstanceIdTimer()
 {
-    CharacterDatabase.PExecute("DELETE FROM account_instances_entered WHERE AccountId = '%u'", m_session->GetAccountId());
-
-    if (m_enteredInstances.empty())
-        return;
-
-    static SqlStatementID insertInsertTimer;
     for (auto enterInstItr : m_enteredInstances)
     {
-        SqlStatement stmt = CharacterDatabase.CreateStatement(insertInsertTimer,
-                            "INSERT INTO account_instances_entered (AccountId, ExpireTime, InstanceId) VALUES( ?, ?, ?)");
-
-        stmt.addUInt32(m_session->GetAccountId());
-        stmt.addUInt64(Clock::to_time_t(enterInstItr.second));
-        stmt.addUInt32(enterInstItr.first);
-        stmt.Execute();
+        std::ostringstream key, values;
+        key << "InstanceId = " << enterInstItr.first;
+        values << m_session->GetAccountId() << ", " << uint64(Clock::to_time_t(enterInstItr.second)) << ", " << enterInstItr.first;
+        m_instanceTimerSaveState.AddRow(key.str(), values.str());
     }
+
+    std::ostringstream owner;
+    owner << "AccountId = " << m_session->GetAccountId();
+    return m_instanceTimerSaveState.Commit(CharacterDatabase, owner.str());
 }
 
 // Clears timers that expired
@@ -25,6 +25,7 @@
 #include "Entities/Item.h"
 
 #include "Database/DatabaseEnv.h"
+#include "Database/SqlRowSetDiff.h"
 #include "Quests/QuestDef.h"
 #include "Groups/Group.h"
 #include "Entities/Bag.h"
@@ -2511,7 +2512,7 @@ class Player : public Unit
         void SendClearCooldown(uint32 spell_id, Unit* target) const;
         void RemoveArenaSpellCooldowns();
         void _LoadSpellCooldowns(QueryResult* result);
-        void _SaveSpellCooldowns();
+        uint32 _SaveSpellCooldowns();
         void SetLastPotionId(uint32 item_id) { m_lastPotionId = item_id; }
         uint32 GetLastPotionId() const { return m_lastPotionId; }
         void UpdatePotionCooldown(Spell* spell = nullptr);
@@ -2612,14 +2613,14 @@ class Player : public Unit
         void _LoadGlyphs(QueryResult* result);
         void _LoadIntoDataField(const char* data, uint32 startOffset, uint32 count);
         void _LoadCreatedInstanceTimers();
-        void _SaveNewInstanceIdTimer();
+        uint32 _SaveNewInstanceIdTimer();
 
         /*********************************************************/
         /***                   SAVE SYSTEM                     ***/
         /*********************************************************/
 
         void _SaveActions();
-        void _SaveAuras();
+        uint32 _SaveAuras();
         void _SaveInventory();
         void _SaveMail();
         void _SaveQuestStatus();
@@ -2899,6 +2900,11 @@ class Player : public Unit
         std::unordered_map<uint32, TimePoint> m_enteredInstances;
         uint32 m_createdInstanceClearTimer;
 
+        // rows written by the previous save, only changed rows are written again
+        SqlRowSetDiff m_auraSaveState;
+        SqlRowSetDiff m_cooldownSaveState;
+        SqlRowSetDiff m_instanceTimerSaveState;
+
         uint32 m_pendingBindMapId;
         uint32 m_pendingBindId;
         uint32 m_pendingBindTimer;
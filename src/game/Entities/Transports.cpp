@@ -23,6 +23,7 @@
 #include "Globals/ObjectMgr.h"
 #include "Entities/ObjectGuid.h"
 #include "MotionGenerators/Path.h"
+#include "MotionGenerators/MoveMap.h"
 
 #include "WorldPacket.h"
 #include "Server/DBCStores.h"
@@ -695,6 +696,15 @@ void GenericTransport::UpdatePosition(float x, float y, float z, float o)
     UpdatePassengerPositions(m_passengers);
 }
 
+MMAP::NavMeshQueryPool* GenericTransport::GetNavMeshQueryPool()
+{
+    // path calculations of passengers may run on several threads, all of them store the same pool
+    if (!m_navMeshQueryPool)
+        m_navMeshQueryPool = MMAP::MMapFactory::createOrGetMMapManager()->GetModelNavMeshQueryPool(GetDisplayId());
+
+    return m_navMeshQueryPool;
+}
+
 void GenericTransport::SetGoState(GOState state)
 {
     GameObject::SetGoState(state);
@@ -22,15 +22,21 @@
 #include "Entities/GameObject.h"
 #include "Maps/TransportMgr.h"
 
+#include <atomic>
 #include <map>
 #include <set>
 
+namespace MMAP
+{
+    class NavMeshQueryPool;
+}
+
 typedef std::set<WorldObject*> PassengerSet;
 
 class GenericTransport : public GameObject
 {
     public:
-        GenericTransport() : m_passengerTeleportIterator(m_passengers.end()), m_pathProgress(0), m_movementStarted(0), m_stopped(false){}
+        GenericTransport() : m_passengerTeleportIterator(m_passengers.end()), m_pathProgress(0), m_movementStarted(0), m_stopped(false), m_navMeshQueryPool(nullptr) {}
         bool AddPassenger(WorldObject* passenger, bool adjustCoords = true);
         bool RemovePassenger(WorldObject* passenger);
         bool AddPetToTransport(Unit* passenger, Pet* pet);
@@ -60,6 +66,9 @@ class GenericTransport : public GameObject
 
         uint32 GetPathProgress() const { return m_pathProgress; }
 
+        // navmesh queries of the transport model, nullptr if it has no navmesh
+        MMAP::NavMeshQueryPool* GetNavMeshQueryPool();
+
         void SetGoState(GOState state) override;
     protected:
         void UpdatePassengerPositions(PassengerSet& passengers);
@@ -70,6 +79,8 @@ class GenericTransport : public GameObject
         uint32 m_pathProgress; // for MO transport its full time since start for normal time in cycle
         uint32 m_movementStarted;
         bool m_stopped;
+
+        std::atomic<MMAP::NavMeshQueryPool*> m_navMeshQueryPool;  // models are loaded at startup and never unloaded
 };
 
 class ElevatorTransport : public GenericTransport
@@ -291,9 +291,14 @@ Unit::Unit() :
     // m_removeAuraTimer = 4;
     m_spellAuraHoldersUpdateIterator = m_spellAuraHolders.end();
     m_AuraFlags = 0;
+    m_holderProcFlags = 0;
+    m_holderProcFlagCounts.fill(0);
+    m_damageInterruptedHolders = 0;
+    m_holderProcGeneration = sSpellMgr.GetSpellProcEventGeneration();
 
     m_Visibility = VISIBILITY_ON;
     m_AINotifyEvent = nullptr;
+    m_visibilityUpdateScheduled = false;
 
     m_transform = 0;
     m_canModifyStats = false;
@@ -5627,6 +5632,7 @@ bool Unit::AddSpellAuraHolder(SpellAuraHolder* holder)
     holder->_AddSpellAuraHolder();
     holder->SetCreationDelayFlag();
     m_spellAuraHolders.insert(SpellAuraHolderMap::value_type(holder->GetId(), holder));
+    UpdateHolderProcSummary(holder, true);
 
     for (int32 i = 0; i < MAX_EFFECT_INDEX; ++i)
         if (Aura* aur = holder->GetAuraByEffectIndex(SpellEffectIndex(i)))
@@ -5649,6 +5655,54 @@ void Unit::AddAuraToModList(Aura* aura)
         m_modAuras[aura->GetModifier()->m_auraname].push_back(aura);
 }
 
+void Unit::RemoveAuraFromModList(Aura* aura, AuraType type)
+{
+    if (m_modAuras[type].remove(aura))
+        m_modAurasToCompact.push_back(type);
+}
+
+void Unit::UpdateHolderProcSummary(SpellAuraHolder* holder, bool apply)
+{
+    uint32 procFlags = holder->GetProcEventFlags();
+    for (uint32 i = 0; i < m_holderProcFlagCounts.size(); ++i)
+    {
+        if (!(procFlags & (1u << i)))
+            continue;
+
+        if (apply)
+        {
+            if (m_holderProcFlagCounts[i]++ == 0)
+                m_holderProcFlags |= (1u << i);
+        }
+        else if (--m_holderProcFlagCounts[i] == 0)
+            m_holderProcFlags &= ~(1u << i);
+    }
+
+    if (holder->GetSpellProto()->AuraInterruptFlags & AURA_INTERRUPT_FLAG_DAMAGE)
+    {
+        if (apply)
+            ++m_damageInterruptedHolders;
+        else
+            --m_damageInterruptedHolders;
+    }
+}
+
+void Unit::RebuildHolderProcSummary()
+{
+    // spell_proc_event was reloaded, the holders still carry the proc flags of the previous load
+    m_holderProcFlags = 0;
+    m_holderProcFlagCounts.fill(0);
+    m_damageInterruptedHolders = 0;
+
+    for (auto& holderPair : m_spellAuraHolders)
+    {
+        holderPair.second->UpdateProcEventFlags();
+        UpdateHolderProcSummary(holderPair.second, true);
+    }
+
+    m_holderProcGeneration = sSpellMgr.GetSpellProcEventGeneration();
+}
+
 void Unit::RemoveRankAurasDueToSpell(uint32 spellId)
 {
     SpellEntry const* spellInfo = sSpellTemplate.LookupEntry<SpellEntry>(spellId);
@@ -6249,6 +6303,7 @@ void Unit::RemoveSpellAuraHolder(SpellAuraHolder* holder, AuraRemoveMode mode)
         if (itr->second == holder)
         {
             m_spellAuraHolders.erase(itr);
+            UpdateHolderProcSummary(holder, false);
             break;
         }
     }
@@ -6299,7 +6354,7 @@ void Unit::RemoveAura(Aura* Aur, AuraRemoveMode mode)
     // remove from list before mods removing (prevent cyclic calls, mods added before including to aura list - use reverse order)
     if (Aur->GetModifier()->m_auraname < TOTAL_AURAS)
     {
-        m_modAuras[Aur->GetModifier()->m_auraname].remove(Aur);
+        RemoveAuraFromModList(Aur, AuraType(Aur->GetModifier()->m_auraname));
     }
 
     // Set remove mode
@@ -9960,7 +10015,6 @@ void Unit::UpdateVisibilityAndView()
 
             if (!owner || !IsVisibleForOrDetect(owner, this, false))
             {
-                alist.erase(it);
                 RemoveAura(aura);
                 it = alist.begin();
             }
@@ -11125,11 +11179,10 @@ void Unit::ApplyMaxPowerMod(Powers power, uint32 val, bool apply)
 
 void Unit::ApplyAuraProcTriggerDamage(Aura* aura, bool apply)
 {
-    AuraList& tAuraProcTriggerDamage = m_modAuras[SPELL_AURA_PROC_TRIGGER_DAMAGE];
     if (apply)
-        tAuraProcTriggerDamage.push_back(aura);
+        m_modAuras[SPELL_AURA_PROC_TRIGGER_DAMAGE].push_back(aura);
     else
-        tAuraProcTriggerDamage.remove(aura);
+        RemoveAuraFromModList(aura, SPELL_AURA_PROC_TRIGGER_DAMAGE);
 }
 
 uint32 Unit::GetCreatePowers(Powers power) const
@@ -11152,6 +11205,7 @@ uint32 Unit::GetCreatePowers(Powers power) const
 void Unit::AddToWorld()
 {
     WorldObject::AddToWorld();
+    m_visibilityUpdateScheduled = false;                    // a queue entry of a previous map is stale
     uint32 delay = 0;
     if (IsCreature() && !IsPlayerControlled())
         delay = GetUInt32Value(UNIT_CREATED_BY_SPELL) ? 1000 : sWorld.getConfig(CONFIG_UINT32_CREATURE_RESPAWN_AGGRO_DELAY);
@@ -12757,9 +12811,14 @@ void Unit::CleanupDeletedAuras()
     m_deletedHolders.clear();
 
     // really delete auras "deleted" while processing its ApplyModify code
-    for (AuraList::const_iterator itr = m_deletedAuras.begin(); itr != m_deletedAuras.end(); ++itr)
-        delete *itr;
+    for (Aura* aura : m_deletedAuras)
+        delete aura;
     m_deletedAuras.clear();
+
+    // nothing iterates the aura lists here, so the holes of removed auras can be closed
+    for (AuraType type : m_modAurasToCompact)
+        m_modAuras[type].Compact();
+    m_modAurasToCompact.clear();
 }
 
 bool Unit::IsShapeShifted() const
@@ -12902,8 +12961,8 @@ void Unit::OnRelocated()
         m_last_notified_position.y = GetPositionY();
         m_last_notified_position.z = GetPositionZ();
 
-        GetViewPoint().Call_UpdateVisibilityForOwner();
-        UpdateObjectVisibility();
+        // all moves of this tick are evaluated once at its end
+        GetMap()->ScheduleVisibilityUpdate(this);
     }
     ScheduleAINotify(World::GetRelocationAINotifyDelay());
 }
@@ -45,6 +45,7 @@
 #include "Timer.h"
 #include "AI/BaseAI/UnitAI.h"
 #include "Spells/SpellDefines.h"
+#include "Spells/FlatAuraList.h"
 
 #include <list>
 #include <array>
@@ -1143,7 +1144,7 @@ class Unit : public WorldObject
         typedef std::pair<SpellAuraHolderMap::iterator, SpellAuraHolderMap::iterator> SpellAuraHolderBounds;
         typedef std::pair<SpellAuraHolderMap::const_iterator, SpellAuraHolderMap::const_iterator> SpellAuraHolderConstBounds;
         typedef std::list<SpellAuraHolder*> SpellAuraHolderList;
-        typedef std::list<Aura*> AuraList;
+        typedef FlatAuraList AuraList;
         typedef std::list<DiminishingReturn> Diminishing;
         typedef std::set<uint32 /*playerGuidLow*/> ComboPointHolderSet;
         typedef std::map<uint8 /*slot*/, uint32 /*spellId*/> VisibleAuraMap;
@@ -1929,6 +1930,9 @@ class Unit : public WorldObject
 
         bool AddSpellAuraHolder(SpellAuraHolder* holder);
         void AddAuraToModList(Aura* aura);
+        void RemoveAuraFromModList(Aura* aura, AuraType type);
+        void UpdateHolderProcSummary(SpellAuraHolder* holder, bool apply);
+        void RebuildHolderProcSummary();
 
         // removing specific aura stack
         void RemoveAura(Aura* Aur, AuraRemoveMode mode = AURA_REMOVE_BY_DEFAULT);
@@ -2412,6 +2416,9 @@ class Unit : public WorldObject
         void FinalizeAINotifyEvent() { m_AINotifyEvent = nullptr; }
         void AbortAINotifyEvent();
         void OnRelocated();
+        // queued in Map::ScheduleVisibilityUpdate, cleared once the map processed it
+        bool IsVisibilityUpdateScheduled() const { return m_visibilityUpdateScheduled; }
+        void SetVisibilityUpdateScheduled(bool scheduled) { m_visibilityUpdateScheduled = scheduled; }
 
 
         bool IsLinkingEventTrigger() const { return m_isCreatureLinkingTrigger; }
@@ -2548,7 +2555,7 @@ class Unit : public WorldObject
 
         SpellAuraHolderMap m_spellAuraHolders;
         SpellAuraHolderMap::iterator m_spellAuraHoldersUpdateIterator; // != end() in Unit::m_spellAuraHolders update and point to next element
-        AuraList m_deletedAuras;                            // auras removed while in ApplyModifier and waiting deleted
+        std::vector<Aura*> m_deletedAuras;                  // auras removed while in ApplyModifier and waiting deleted
         SpellAuraHolderList m_deletedHolders;
         std::map<uint32, Aura*> m_classScripts;
         std::vector<Aura*> m_scriptedLocations[SCRIPT_LOCATION_MAX];
@@ -2566,6 +2573,13 @@ class Unit : public WorldObject
         uint32 m_transform;
 
         AuraList m_modAuras[TOTAL_AURAS];
+        std::vector<AuraType> m_modAurasToCompact;          // m_modAuras lists with holes, compacted in CleanupDeletedAuras
+
+        // proc flags of the holders in m_spellAuraHolders, lets ProcDamageAndSpellFor skip the holder scan
+        uint32 m_holderProcFlags;
+        std::array<uint16, 32> m_holderProcFlagCounts;
+        uint32 m_damageInterruptedHolders;                  // holders with AURA_INTERRUPT_FLAG_DAMAGE
+        uint32 m_holderProcGeneration;                      // spell_proc_event load the summary was built from
         float m_auraModifiersGroup[UNIT_MOD_END][MODIFIER_TYPE_END];
 
         WeaponDamageInfo m_weaponDamageInfo;
@@ -2651,6 +2665,7 @@ class Unit : public WorldObject
         UnitVisibility m_Visibility;
         Position m_last_notified_position;
         BasicEvent* m_AINotifyEvent;
+        bool m_visibilityUpdateScheduled;
         ShortTimeTracker m_movesplineTimer;
 
         Diminishing m_Diminishing;
@@ -24,10 +24,11 @@
 #include "WorldPacket.h"
 #include "Log.h"
 #include "Server/Opcodes.h"
-#include "World/World.h"
 #include "Entities/ObjectGuid.h"
 #include "Server/WorldSession.h"
 
+std::atomic<int> UpdateData::s_compressionLevel(Z_BEST_SPEED);
+
 UpdateData::UpdateData() : m_data(1), m_currentIndex(0)
 {
     m_data[0].m_buffer = 0;
@@ -61,21 +62,67 @@ void UpdateData::AddUpdateBlock(const ByteBuffer& block)
     }
 }
 
+namespace
+{
+    // deflate state of the calling thread, deflateInit allocates a few hundred KB so it is only reset between packets
+    struct UpdateCompressor
+    {
+        z_stream stream;
+        int level;
+        bool initialized;
+
+        UpdateCompressor() : level(0), initialized(false) { memset(&stream, 0, sizeof(stream)); }
+        ~UpdateCompressor() { Release(); }
+
+        void Release()
+        {
+            if (initialized)
+                deflateEnd(&stream);
+            initialized = false;
+        }
+    };
+
+    thread_local UpdateCompressor t_compressor;
+}
+
 void UpdateData::Compress(void* dst, uint32* dst_size, void* src, int src_size)
 {
-    z_stream c_stream;
+    UpdateCompressor& compressor = t_compressor;
+    z_stream& c_stream = compressor.stream;
 
-    c_stream.zalloc = (alloc_func)nullptr;
-    c_stream.zfree = (free_func)nullptr;
-    c_stream.opaque = (voidpf)nullptr;
+    // a changed level after config reload needs a new stream
+    int level = s_compressionLevel;
+    if (compressor.initialized && compressor.level != level)
+        compressor.Release();
 
-    // default Z_BEST_SPEED (1)
-    int z_res = deflateInit(&c_stream, sWorld.getConfig(CONFIG_UINT32_COMPRESSION));
-    if (z_res != Z_OK)
+    int z_res;
+    if (!compressor.initialized)
     {
-        sLog.outError("Can't compress update packet (zlib: deflateInit) Error code: %i (%s)", z_res, zError(z_res));
-        *dst_size = 0;
-        return;
+        c_stream.zalloc = (alloc_func)nullptr;
+        c_stream.zfree = (free_func)nullptr;
+        c_stream.opaque = (voidpf)nullptr;
+
+        z_res = deflateInit(&c_stream, level);
+        if (z_res != Z_OK)
+        {
+            sLog.outError("Can't compress update packet (zlib: deflateInit) Error code: %i (%s)", z_res, zError(z_res));
+            *dst_size = 0;
+            return;
+        }
+
+        compressor.initialized = true;
+        compressor.level = level;
+    }
+    else
+    {
+        z_res = deflateReset(&c_stream);
+        if (z_res != Z_OK)
+        {
+            sLog.outError("Can't compress update packet (zlib: deflateReset) Error code: %i (%s)", z_res, zError(z_res));
+            compressor.Release();
+            *dst_size = 0;
+            return;
+        }
     }
 
     c_stream.next_out = (Bytef*)dst;
@@ -87,6 +134,7 @@ void UpdateData::Compress(void* dst, uint32* dst_size, void* src, int src_size)
     if (z_res != Z_OK)
     {
         sLog.outError("Can't compress update packet (zlib: deflate) Error code: %i (%s)", z_res, zError(z_res));
+        compressor.Release();
         *dst_size = 0;
         return;
     }
@@ -94,6 +142,7 @@ void UpdateData::Compress(void* dst, uint32* dst_size, void* src, int src_size)
     if (c_stream.avail_in != 0)
     {
         sLog.outError("Can't compress update packet (zlib: deflate not greedy)");
+        compressor.Release();
         *dst_size = 0;
         return;
     }
@@ -102,14 +151,7 @@ void UpdateData::Compress(void* dst, uint32* dst_size, void* src, int src_size)
     if (z_res != Z_STREAM_END)
     {
         sLog.outError("Can't compress update packet (zlib: deflate should report Z_STREAM_END instead %i (%s)", z_res, zError(z_res));
-        *dst_size = 0;
-        return;
-    }
-
-    z_res = deflateEnd(&c_stream);
-    if (z_res != Z_OK)
-    {
-        sLog.outError("Can't compress update packet (zlib: deflateEnd) Error code: %i (%s)", z_res, zError(z_res));
+        compressor.Release();
         *dst_size = 0;
         return;
     }
@@ -167,6 +209,7 @@ void UpdateData::Clear()
     m_outOfRangeGUIDs.clear();
 }
 
+#ifndef NO_CORE_FUNCS
 void UpdateData::SendData(WorldSession& session)
 {
     for (size_t i = 0; i < GetPacketCount(); ++i)
@@ -175,3 +218,4 @@ void UpdateData::SendData(WorldSession& session)
         session.SendPacket(packet);
     }
 }
+#endif
@@ -22,6 +22,8 @@
 #include "ByteBuffer.h"
 #include "Entities/ObjectGuid.h"
 
+#include <atomic>
+
 class WorldPacket;
 class WorldSession;
 
@@ -73,11 +75,16 @@ class UpdateData
 
         void SendData(WorldSession& session);
 
+        // zlib level of the compressed packets, the Compression setting
+        static void SetCompressionLevel(int level) { s_compressionLevel = level; }
+
     protected:
         GuidSet m_outOfRangeGUIDs;
         std::vector<BufferPair> m_data;
         uint32 m_currentIndex;
 
         static void Compress(void* dst, uint32* dst_size, void* src, int src_size);
+
+        static std::atomic<int> s_compressionLevel;
 };
 #endif
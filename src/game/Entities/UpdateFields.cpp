@@ -442,6 +442,27 @@ static std::array<uint16, GAMEOBJECT_END> const g_gameObjectUpdateFieldFlags = S
 static std::array<uint16, DYNAMICOBJECT_END> const g_dynamicObjectUpdateFieldFlags = SetupUpdateFieldFlagsArray<DYNAMICOBJECT_END>(TYPEMASK_OBJECT | TYPEMASK_DYNAMICOBJECT);
 static std::array<uint16, CORPSE_END> const g_corpseUpdateFieldFlags = SetupUpdateFieldFlagsArray<CORPSE_END>(TYPEMASK_OBJECT | TYPEMASK_CORPSE);
 
+template<std::size_t SIZE>
+static UpdateFieldFlagBlocks SetupUpdateFieldFlagBlocks(std::array<uint16, SIZE> const& flagsArray)
+{
+    UpdateFieldFlagBlocks blocks;
+    for (auto& flagBlocks : blocks.flagBlocks)
+        flagBlocks.resize((SIZE + 31) / 32, 0);
+
+    for (uint32 index = 0; index < SIZE; ++index)
+        for (uint32 bit = 0; bit < MAX_UPDATE_FIELD_FLAG_BITS; ++bit)
+            if (flagsArray[index] & (1 << bit))
+                blocks.flagBlocks[bit][index >> 5] |= 1u << (index & 0x1F);
+
+    return blocks;
+}
+
+static UpdateFieldFlagBlocks const g_containerUpdateFieldFlagBlocks = SetupUpdateFieldFlagBlocks(g_containerUpdateFieldFlags);
+static UpdateFieldFlagBlocks const g_playerUpdateFieldFlagBlocks = SetupUpdateFieldFlagBlocks(g_playerUpdateFieldFlags);
+static UpdateFieldFlagBlocks const g_gameObjectUpdateFieldFlagBlocks = SetupUpdateFieldFlagBlocks(g_gameObjectUpdateFieldFlags);
+static UpdateFieldFlagBlocks const g_dynamicObjectUpdateFieldFlagBlocks = SetupUpdateFieldFlagBlocks(g_dynamicObjectUpdateFieldFlags);
+static UpdateFieldFlagBlocks const g_corpseUpdateFieldFlagBlocks = SetupUpdateFieldFlagBlocks(g_corpseUpdateFieldFlags);
+
 uint16 const* UpdateFields::GetUpdateFieldFlagsArray(uint8 objectTypeId)
 {
     switch (objectTypeId)
@@ -473,6 +494,27 @@ uint16 const* UpdateFields::GetUpdateFieldFlagsArray(uint8 objectTypeId)
     return 0;
 }
 
+UpdateFieldFlagBlocks const* UpdateFields::GetUpdateFieldFlagBlocks(uint8 objectTypeId)
+{
+    switch (objectTypeId)
+    {
+        case TYPEID_ITEM:
+        case TYPEID_CONTAINER:
+            return &g_containerUpdateFieldFlagBlocks;
+        case TYPEID_UNIT:
+        case TYPEID_PLAYER:
+            return &g_playerUpdateFieldFlagBlocks;
+        case TYPEID_GAMEOBJECT:
+            return &g_gameObjectUpdateFieldFlagBlocks;
+        case TYPEID_DYNAMICOBJECT:
+            return &g_dynamicObjectUpdateFieldFlagBlocks;
+        case TYPEID_CORPSE:
+            return &g_corpseUpdateFieldFlagBlocks;
+    }
+    sLog.outError("Unhandled object type id (%hhu) in GetUpdateFieldFlagBlocks!", objectTypeId);
+    return nullptr;
+}
+
 UpdateFieldData const* UpdateFields::GetUpdateFieldDataByName(char const* name)
 {
     for (const auto& itr : g_updateFieldsData)
@@ -18,6 +18,8 @@
 
 #include "Platform/Define.h"
 
+#include <vector>
+
 #ifndef _UPDATEFIELDS_AUTO_H
 #define _UPDATEFIELDS_AUTO_H
 
@@ -458,6 +460,24 @@ enum UpdateFieldFlags : uint16
 	UF_FLAG_DYNAMIC      = 0x100,   // visible to everyone, but different values can be sent to different observers
 };
 
+#define MAX_UPDATE_FIELD_FLAG_BITS 9                        // UF_FLAG_PUBLIC .. UF_FLAG_DYNAMIC
+
+// fields of one object type carrying each UF_FLAG_* bit, 32 fields per block in UpdateMask layout
+struct UpdateFieldFlagBlocks
+{
+    std::vector<uint32> flagBlocks[MAX_UPDATE_FIELD_FLAG_BITS];
+
+    // fields of the block visible to an observer with visibleFlag, bit 0 is the first field of the block
+    uint32 GetVisibleBlock(uint16 visibleFlag, uint32 block) const
+    {
+        uint32 visible = 0;
+        for (uint32 bit = 0; bit < MAX_UPDATE_FIELD_FLAG_BITS; ++bit)
+            if (visibleFlag & (1 << bit))
+                visible |= flagBlocks[bit][block];
+        return visible;
+    }
+};
+
 struct UpdateFieldData
 {
     UpdateFieldData() = default;
@@ -474,6 +494,7 @@ struct UpdateFieldData
 namespace UpdateFields
 {
     uint16 const* GetUpdateFieldFlagsArray(uint8 objectTypeId);
+    UpdateFieldFlagBlocks const* GetUpdateFieldFlagBlocks(uint8 objectTypeId);
     UpdateFieldData const* GetUpdateFieldDataByName(char const* name);
     UpdateFieldData const* GetUpdateFieldDataByTypeMaskAndOffset(uint8 objectTypeMask, uint16 offset);
 };
@@ -20,16 +20,24 @@
 #define __UPDATEMASK_H
 
 #include "Errors.h"
+#include "Utilities/ByteConverter.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
 
 class UpdateMask
 {
     public:
-        UpdateMask() : mHasData(false), mCount(0), mBlocks(0), mUpdateMask(nullptr) { }
-        UpdateMask(const UpdateMask& mask) : mUpdateMask(nullptr) { *this = mask; }
+        // enough for every object type (players have the most fields), larger masks fall back to the heap
+        static uint32 const INLINE_BLOCKS = 48;
+
+        UpdateMask() : mHasData(false), mCount(0), mBlocks(0), mUpdateMask(mInlineMask) { }
+        UpdateMask(const UpdateMask& mask) : mHasData(false), mCount(0), mBlocks(0), mUpdateMask(mInlineMask) { *this = mask; }
 
         ~UpdateMask()
         {
-            delete[] mUpdateMask;
+            FreeMask();
         }
 
         void SetBit(uint32 index)
@@ -48,6 +56,59 @@ class UpdateMask
             return (((uint8*)mUpdateMask)[ index >> 3 ] & (1 << (index & 0x7))) != 0;
         }
 
+        // 32 fields at once, bit 0 is the first field of the block (the mask is sent byte wise, lowest bit first)
+        void SetBlock(uint32 block, uint32 bits)
+        {
+            EndianConvert(bits);
+            mUpdateMask[block] |= bits;
+            mHasData = true;
+        }
+
+        uint32 GetBlock(uint32 block) const
+        {
+            uint32 bits = mUpdateMask[block];
+            EndianConvert(bits);
+            return bits;
+        }
+
+        // first set bit at or after index skipping empty blocks, GetCount() if there is none
+        uint32 FindNextBit(uint32 index) const
+        {
+            uint32 block = index >> 5;
+            if (block >= mBlocks)
+                return mCount;
+
+            uint32 bits = GetBlock(block) & (~uint32(0) << (index & 0x1F));
+            while (!bits)
+            {
+                if (++block >= mBlocks)
+                    return mCount;
+                bits = GetBlock(block);
+            }
+
+            return (block << 5) + LowestSetBit(bits);
+        }
+
+        // bits must not be 0
+        static uint32 LowestSetBit(uint32 bits)
+        {
+#if defined(__GNUC__)
+            return uint32(__builtin_ctz(bits));
+#elif defined(_MSC_VER)
+            unsigned long index;
+            _BitScanForward(&index, bits);
+            return uint32(index);
+#else
+            uint32 index = 0;
+            while (!(bits & 1))
+            {
+                bits >>= 1;
+                ++index;
+            }
+            return index;
+#endif
+        }
+
         uint32 GetBlockCount() const { return mBlocks; }
         uint32 GetLength() const { return mBlocks << 2; }
         uint32 GetCount() const { return mCount; }
@@ -56,26 +117,30 @@ class UpdateMask
 
         void SetCount(uint32 valuesCount)
         {
-            delete[] mUpdateMask;
+            FreeMask();
 
             mCount = valuesCount;
             mBlocks = (valuesCount + 31) / 32;
 
-            mUpdateMask = new uint32[mBlocks];
+            if (mBlocks > INLINE_BLOCKS)
+                mUpdateMask = new uint32[mBlocks];
             memset(mUpdateMask, 0, mBlocks << 2);
         }
 
         void Clear()
         {
-            if (mUpdateMask)
-                memset(mUpdateMask, 0, mBlocks << 2);
+            memset(mUpdateMask, 0, mBlocks << 2);
             mHasData = false;
         }
 
         UpdateMask& operator = (const UpdateMask& mask)
         {
+            if (this == &mask)
+                return *this;
+
             SetCount(mask.mCount);
             memcpy(mUpdateMask, mask.mUpdateMask, mBlocks << 2);
+            mHasData = mask.mHasData;
 
             return *this;
         }
@@ -115,9 +180,17 @@ class UpdateMask
         }
 
     private:
+        void FreeMask()
+        {
+            if (mUpdateMask != mInlineMask)
+                delete[] mUpdateMask;
+            mUpdateMask = mInlineMask;
+        }
+
         bool mHasData;
         uint32 mCount;
         uint32 mBlocks;
         uint32* mUpdateMask;
+        uint32 mInlineMask[INLINE_BLOCKS];
 };
 #endif
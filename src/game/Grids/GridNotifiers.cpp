@@ -38,6 +38,37 @@ void VisibleChangesNotifier::Visit(CameraMapType& m)
     }
 }
 
+// for an alive player outside GM mode these objects are visible whenever they are in range, state changes
+// that hide them (stealth, invisibility, phases, death) update the players around them on their own
+static bool IsVisibleByDistanceOnly(WorldObject const* obj)
+{
+    if (obj->GetVisibilityData().IsVisibilityOverridden() || obj->GetVisibilityData().GetInvisibilityMask())
+        return false;
+
+    switch (obj->GetTypeId())
+    {
+        case TYPEID_UNIT:
+            if (static_cast<Creature const*>(obj)->IsInvisible())
+                return false;
+        // [[fallthrough]]
+        case TYPEID_PLAYER:
+        {
+            Unit const* unit = static_cast<Unit const*>(obj);
+            return unit->GetVisibility() == VISIBILITY_ON && unit->IsAlive() && !unit->isInvisibleForAlive();
+        }
+        case TYPEID_GAMEOBJECT:
+        {
+            GameObject const* go = static_cast<GameObject const*>(obj);
+            return go->GetGOInfo()->type != GAMEOBJECT_TYPE_TRAP && !go->GetVisibilityData().GetStealthMask();
+        }
+        case TYPEID_CORPSE:
+        case TYPEID_DYNAMICOBJECT:
+            return true;
+        default:
+            return false;
+    }
+}
+
 void VisibleNotifier::Notify()
 {
     Player& player = *i_camera.GetOwner();
@@ -82,6 +113,31 @@ void VisibleNotifier::Notify()
         ++itr;
     }
 
+    // objects in the skipped cells are still in range, those whose visibility depends on more than the distance are checked
+    if (i_skippedCells)
+    {
+        for (GuidSet::iterator itr = i_clientGUIDs.begin(); itr != i_clientGUIDs.end();)
+        {
+            WorldObject* obj = player.GetMap()->GetWorldObject(*itr);
+            if (!obj)
+            {
+                ++itr;
+                continue;
+            }
+
+            CellPair cell = MaNGOS::ComputeCellPair(obj->GetPositionX(), obj->GetPositionY());
+            if (!std::binary_search(i_skippedCells->begin(), i_skippedCells->end(), cell.y_coord * TOTAL_NUMBER_OF_CELLS_PER_MAP + cell.x_coord))
+            {
+                ++itr;
+                continue;
+            }
+
+            if (!IsVisibleByDistanceOnly(obj))
+                player.UpdateVisibilityOf(i_camera.GetBody(), obj, i_data, i_visibleNow);
+            itr = i_clientGUIDs.erase(itr);
+        }
+    }
+
     // generate outOfRange for not iterate objects
     i_data.AddOutOfRangeGUID(i_clientGUIDs);
     for (GuidSet::iterator itr = i_clientGUIDs.begin(); itr != i_clientGUIDs.end(); ++itr)
@@ -39,8 +39,10 @@ namespace MaNGOS
         UpdateData i_data;
         GuidSet i_clientGUIDs;
         WorldObjectSet i_visibleNow;
+        std::vector<uint32> const* i_skippedCells;          // cells entirely in range before and after a move, not visited
 
-        explicit VisibleNotifier(Camera& c) : i_camera(c), i_clientGUIDs(c.GetOwner()->GetClientGuids()) {}
+        explicit VisibleNotifier(Camera& c, std::vector<uint32> const* skippedCells = nullptr) :
+            i_camera(c), i_clientGUIDs(c.GetOwner()->GetClientGuids()), i_skippedCells(skippedCells) {}
         template<class T> void Visit(GridRefManager<T>& m);
         void Visit(CameraMapType& /*m*/) {}
         void Notify(void);
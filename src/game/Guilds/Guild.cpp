@@ -1998,6 +1998,7 @@ void Guild::SendGuildBankTabText(WorldSession* session, uint8 TabId)
         BroadcastPacket(data);
 }
 
+// bank transactions stay unkeyed: the bank rows are shared by all members, so they are ordered against every character's saves
 void Guild::SwapItems(Player* pl, uint8 BankTab, uint8 BankTabSlot, uint8 BankTabDst, uint8 BankTabSlotDst, uint32 SplitedAmount)
 {
     // empty operation
@@ -40,7 +40,7 @@ char const* MAP_LIQUID_MAGIC  = "MLIQ";
 static uint16 const holetab_h[4] = { 0x1111, 0x2222, 0x4444, 0x8888 };
 static uint16 const holetab_v[4] = { 0x000F, 0x00F0, 0x0F00, 0xF000 };
 
-GridMap::GridMap() : m_gridIntHeightMultiplier(0.0f)
+GridMap::GridMap() : m_fileData(nullptr), m_fileSize(0), m_gridIntHeightMultiplier(0.0f)
 {
     m_flags = 0;
 
@@ -82,20 +82,19 @@ bool GridMap::loadData(char const* filename)
     // Unload old data if exist
     unloadData();
 
-    GridMapFileHeader header;
     // Not return error if file not found
-    FILE* in = fopen(filename, "rb");
-    if (!in)
+    if (!loadFile(filename))
     {
         DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "Failled to found %s", filename);
         // its a valid error only in case of no vmap files are available too
         return true;
     }
 
-    if (fread(&header, sizeof(header), 1, in) != 1)
+    GridMapFileHeader header;
+    if (!readHeader(header, 0))
     {
         sLog.outError("Error loading GridMapFileHeader\n");
-        fclose(in);
+        unloadData();
         return false;
     }
 
@@ -104,65 +103,133 @@ bool GridMap::loadData(char const* filename)
             IsAcceptableClientBuild(header.buildMagic))
     {
         // loadup area data
-        if (header.areaMapOffset && !loadAreaData(in, header.areaMapOffset, header.areaMapSize))
+        if (header.areaMapOffset && !loadAreaData(header.areaMapOffset, header.areaMapSize))
         {
             sLog.outError("Error loading map area data\n");
-            fclose(in);
+            unloadData();
             return false;
         }
 
         // loadup height data
-        if (header.heightMapOffset && !loadHeightData(in, header.heightMapOffset, header.heightMapSize))
+        if (header.heightMapOffset && !loadHeightData(header.heightMapOffset, header.heightMapSize))
         {
             sLog.outError("Error loading map height data\n");
-            fclose(in);
+            unloadData();
             return false;
         }
 
         // loadup liquid data
-        if (header.liquidMapOffset && !loadGridMapLiquidData(in, header.liquidMapOffset, header.liquidMapSize))
+        if (header.liquidMapOffset && !loadGridMapLiquidData(header.liquidMapOffset, header.liquidMapSize))
         {
             sLog.outError("Error loading map liquids data\n");
-            fclose(in);
+            unloadData();
             return false;
         }
 
         // loadup holes data (if any. check header.holesOffset)
-        if (header.holesOffset && !loadHolesData(in, header.holesOffset, header.holesSize))
+        if (header.holesOffset && !loadHolesData(header.holesOffset, header.holesSize))
         {
             sLog.outError("Error loading map holes data\n");
-            fclose(in);
+            unloadData();
             return false;
         }
 
-        fclose(in);
         return true;
     }
 
     sLog.outError("Map file '%s' is non-compatible version (outdated?). Please, create new using ad.exe program.", filename);
-    fclose(in);
+    unloadData();
     return false;
 }
 
 void GridMap::unloadData()
 {
-    if (m_area_map)    { delete[] m_area_map;    m_area_map = nullptr; }
-    if (m_V9)          { delete[] m_V9;          m_V9 = nullptr; }
-    if (m_V8)          { delete[] m_V8;          m_V8 = nullptr; }
-    if (m_liquidEntry) { delete[] m_liquidEntry; m_liquidEntry = nullptr; }
-    if (m_liquidFlags) { delete[] m_liquidFlags; m_liquidFlags = nullptr; }
-    if (m_liquid_map)  { delete[] m_liquid_map;  m_liquid_map = nullptr; }
-    if (m_holes)       { delete[] m_holes;       m_holes = nullptr; }
+    m_area_map = nullptr;
+    m_V9 = nullptr;
+    m_V8 = nullptr;
+    m_liquidEntry = nullptr;
+    m_liquidFlags = nullptr;
+    m_liquid_map = nullptr;
+    m_holes = nullptr;
+
+    // with a mapped file nothing was copied, the pages stay in the page cache for the next user
+    m_mappedFile.Close();
+    std::vector<uint8>().swap(m_fileBuffer);
+    m_unalignedArrays.clear();
+    m_fileData = nullptr;
+    m_fileSize = 0;
 
     m_gridGetHeight = &GridMap::getHeightFromFlat;
 }
 
-bool GridMap::loadAreaData(FILE* in, uint32 offset, uint32 /*size*/)
+bool GridMap::loadFile(char const* filename)
 {
-    GridMapAreaHeader header;
-    if (fseek(in, offset, SEEK_SET) != 0)
+    if (sWorld.getConfig(CONFIG_BOOL_MAP_FILES_MEMORY_MAPPED))
+    {
+        if (!m_mappedFile.Open(filename))
+            return false;
+
+        m_fileData = m_mappedFile.GetData();
+        m_fileSize = m_mappedFile.GetSize();
+        return true;
+    }
+
+    FILE* in = fopen(filename, "rb");
+    if (!in)
         return false;
-    if (fread(&header, sizeof(header), 1, in) != 1)
+
+    fseek(in, 0, SEEK_END);
+    long size = ftell(in);
+    fseek(in, 0, SEEK_SET);
+    if (size <= 0)
+    {
+        fclose(in);
+        return false;
+    }
+
+    m_fileBuffer.resize(size_t(size));
+    bool read = fread(m_fileBuffer.data(), 1, m_fileBuffer.size(), in) == m_fileBuffer.size();
+    fclose(in);
+    if (!read)
+    {
+        std::vector<uint8>().swap(m_fileBuffer);
+        return false;
+    }
+
+    m_fileData = m_fileBuffer.data();
+    m_fileSize = m_fileBuffer.size();
+    return true;
+}
+
+template<typename T>
+bool GridMap::readHeader(T& header, uint32 offset) const
+{
+    if (offset > m_fileSize || m_fileSize - offset < sizeof(T))
+        return false;
+
+    memcpy(&header, m_fileData + offset, sizeof(T));
+    return true;
+}
+
+template<typename T>
+T const* GridMap::getArray(uint32 offset, size_t count)
+{
+    if (offset > m_fileSize || (m_fileSize - offset) / sizeof(T) < count)
+        return nullptr;
+
+    uint8 const* data = m_fileData + offset;
+    if (reinterpret_cast<uintptr_t>(data) % alignof(T) == 0)
+        return reinterpret_cast<T const*>(data);
+
+    // sections following 8 bit height data are not aligned in the file
+    m_unalignedArrays.emplace_back(data, data + count * sizeof(T));
+    return reinterpret_cast<T const*>(m_unalignedArrays.back().data());
+}
+
+bool GridMap::loadAreaData(uint32 offset, uint32 /*size*/)
+{
+    GridMapAreaHeader header;
+    if (!readHeader(header, offset))
         return false;
     if (header.fourcc != *((uint32 const*)(MAP_AREA_MAGIC)))
         return false;
@@ -170,53 +237,50 @@ bool GridMap::loadAreaData(FILE* in, uint32 offset, uint32 /*size*/)
     m_gridArea = header.gridArea;
     if (!(header.flags & MAP_AREA_NO_AREA))
     {
-        m_area_map = new uint16 [16 * 16];
-        if (fread(m_area_map, sizeof(uint16), 16 * 16, in) != 16 * 16)
+        m_area_map = getArray<uint16>(offset + sizeof(header), 16 * 16);
+        if (!m_area_map)
             return false;
     }
 
     return true;
 }
 
-bool GridMap::loadHeightData(FILE* in, uint32 offset, uint32 /*size*/)
+bool GridMap::loadHeightData(uint32 offset, uint32 /*size*/)
 {
     GridMapHeightHeader header;
-    if (fseek(in, offset, SEEK_SET) != 0)
-        return false;
-    if (fread(&header, sizeof(header), 1, in) != 1)
+    if (!readHeader(header, offset))
         return false;
     if (header.fourcc != *((uint32 const*)(MAP_HEIGHT_MAGIC)))
         return false;
 
+    offset += sizeof(header);
+
     m_gridHeight = header.gridHeight;
     if (!(header.flags & MAP_HEIGHT_NO_HEIGHT))
     {
         if ((header.flags & MAP_HEIGHT_AS_INT16))
         {
-            m_uint16_V9 = new uint16[129 * 129];
-            m_uint16_V8 = new uint16[128 * 128];
-            if (fread(m_uint16_V9, sizeof(uint16), 129 * 129, in) != 129 * 129 ||
-                    fread(m_uint16_V8, sizeof(uint16), 128 * 128, in) != 128 * 128)
+            m_uint16_V9 = getArray<uint16>(offset, 129 * 129);
+            m_uint16_V8 = getArray<uint16>(offset + sizeof(uint16) * 129 * 129, 128 * 128);
+            if (!m_uint16_V9 || !m_uint16_V8)
                 return false;
             m_gridIntHeightMultiplier = (header.gridMaxHeight - header.gridHeight) / 65535;
             m_gridGetHeight = &GridMap::getHeightFromUint16;
         }
         else if ((header.flags & MAP_HEIGHT_AS_INT8))
         {
-            m_uint8_V9 = new uint8[129 * 129];
-            m_uint8_V8 = new uint8[128 * 128];
-            if (fread(m_uint8_V9, sizeof(uint8), 129 * 129, in) != 129 * 129 ||
-                    fread(m_uint8_V8, sizeof(uint8), 128 * 128, in) != 128 * 128)
+            m_uint8_V9 = getArray<uint8>(offset, 129 * 129);
+            m_uint8_V8 = getArray<uint8>(offset + sizeof(uint8) * 129 * 129, 128 * 128);
+            if (!m_uint8_V9 || !m_uint8_V8)
                 return false;
             m_gridIntHeightMultiplier = (header.gridMaxHeight - header.gridHeight) / 255;
             m_gridGetHeight = &GridMap::getHeightFromUint8;
         }
         else
         {
-            m_V9 = new float[129 * 129];
-            m_V8 = new float[128 * 128];
-            if (fread(m_V9, sizeof(float), 129 * 129, in) != 129 * 129 ||
-                    fread(m_V8, sizeof(float), 128 * 128, in) != 128 * 128)
+            m_V9 = getArray<float>(offset, 129 * 129);
+            m_V8 = getArray<float>(offset + sizeof(float) * 129 * 129, 128 * 128);
+            if (!m_V9 || !m_V8)
                 return false;
             m_gridGetHeight = &GridMap::getHeightFromFloat;
         }
@@ -227,24 +291,22 @@ bool GridMap::loadHeightData(FILE* in, uint32 offset, uint32 /*size*/)
     return true;
 }
 
-bool GridMap::loadHolesData(FILE* in, uint32 offset, uint32 /*size*/)
+bool GridMap::loadHolesData(uint32 offset, uint32 /*size*/)
 {
-    if (fseek(in, offset, SEEK_SET) != 0)
-        return false;
-    m_holes = new uint16[16 * 16];
-    return fread(m_holes, sizeof(uint16), 16 * 16, in) == 16 * 16;
+    m_holes = getArray<uint16>(offset, 16 * 16);
+    return m_holes != nullptr;
 }
 
-bool GridMap::loadGridMapLiquidData(FILE* in, uint32 offset, uint32 /*size*/)
+bool GridMap::loadGridMapLiquidData(uint32 offset, uint32 /*size*/)
 {
     GridMapLiquidHeader header;
-    if (fseek(in, offset, SEEK_SET) != 0)
-        return false;
-    if (fread(&header, sizeof(header), 1, in) != 1)
+    if (!readHeader(header, offset))
         return false;
     if (header.fourcc != *((uint32 const*)(MAP_LIQUID_MAGIC)))
         return false;
 
+    offset += sizeof(header);
+
     m_liquidGlobalEntry = header.liquidType;
     m_liquidGlobalFlags = header.liquidFlags;
     m_liquid_offX   = header.offsetX;
@@ -255,19 +317,21 @@ bool GridMap::loadGridMapLiquidData(FILE* in, uint32 offset, uint32 /*size*/)
 
     if (!(header.flags & MAP_LIQUID_NO_TYPE))
     {
-        m_liquidEntry = new uint16[16 * 16];
-        if (fread(m_liquidEntry, sizeof(uint16), 16 * 16, in) != 16 * 16)
+        m_liquidEntry = getArray<uint16>(offset, 16 * 16);
+        if (!m_liquidEntry)
             return false;
+        offset += sizeof(uint16) * 16 * 16;
 
-        m_liquidFlags = new uint8[16 * 16];
-        if (fread(m_liquidFlags, sizeof(uint8), 16 * 16, in) != 16 * 16)
+        m_liquidFlags = getArray<uint8>(offset, 16 * 16);
+        if (!m_liquidFlags)
             return false;
+        offset += sizeof(uint8) * 16 * 16;
     }
 
     if (!(header.flags & MAP_LIQUID_NO_HEIGHT))
     {
-        m_liquid_map = new float[m_liquid_width * m_liquid_height];
-        if (fread(m_liquid_map, sizeof(float), m_liquid_width * m_liquid_height, in) != size_t(m_liquid_width * m_liquid_height))
+        m_liquid_map = getArray<float>(offset, m_liquid_width * m_liquid_height);
+        if (!m_liquid_map)
             return false;
     }
 
@@ -407,7 +471,7 @@ float GridMap::getHeightFromUint8(float x, float y) const
     y_int &= (MAP_RESOLUTION - 1);
 
     int32 a, b, c;
-    uint8* V9_h1_ptr = &m_uint8_V9[x_int * 128 + x_int + y_int];
+    uint8 const* V9_h1_ptr = &m_uint8_V9[x_int * 128 + x_int + y_int];
     if (x + y < 1)
     {
         if (x > y)
@@ -475,7 +539,7 @@ float GridMap::getHeightFromUint16(float x, float y) const
     y_int &= (MAP_RESOLUTION - 1);
 
     int32 a, b, c;
-    uint16* V9_h1_ptr = &m_uint16_V9[x_int * 128 + x_int + y_int];
+    uint16 const* V9_h1_ptr = &m_uint16_V9[x_int * 128 + x_int + y_int];
     if (x + y < 1)
     {
         if (x > y)
@@ -710,7 +774,7 @@ bool GridMap::ExistVMap(uint32 mapid, int gx, int gy)
 }
 
 //////////////////////////////////////////////////////////////////////////
-TerrainInfo::TerrainInfo(uint32 mapid) : m_mapId(mapid)
+TerrainInfo::TerrainInfo(uint32 mapid) : m_mapId(mapid), m_navMeshQueryPool(nullptr)
 {
     for (int k = 0; k < MAX_NUMBER_OF_GRIDS; ++k)
     {
@@ -718,6 +782,8 @@ TerrainInfo::TerrainInfo(uint32 mapid) : m_mapId(mapid)
         {
             m_GridMaps[i][k] = nullptr;
             m_GridRef[i][k] = 0;
+            m_prefetched[i][k] = nullptr;
+            m_prefetchQueued[i][k] = false;
         }
     }
 
@@ -736,6 +802,10 @@ TerrainInfo::~TerrainInfo()
         for (auto& m_GridMap : m_GridMaps)
             delete m_GridMap[k];
 
+    for (auto& row : m_prefetched)
+        for (PrefetchedGrid* prefetched : row)
+            DeletePrefetched(prefetched);
+
     VMAP::VMapFactory::createOrGetVMapManager()->unloadMap(m_mapId);
     MMAP::MMapFactory::createOrGetMMapManager()->unloadMap(m_mapId);
 }
@@ -803,9 +873,93 @@ void TerrainInfo::CleanUpGrids(const uint32 diff)
         }
     }
 
+    // drop prefetched grids nobody walked into
+    {
+        LOCK_GUARD lock(m_prefetchMutex);
+        uint32 now = WorldTimer::getMSTime();
+        for (auto& row : m_prefetched)
+        {
+            for (PrefetchedGrid*& prefetched : row)
+            {
+                if (prefetched && WorldTimer::getMSTimeDiff(prefetched->readTime, now) >= i_timer.GetInterval())
+                {
+                    DeletePrefetched(prefetched);
+                    prefetched = nullptr;
+                }
+            }
+        }
+    }
+
     i_timer.Reset();
 }
 
+void TerrainInfo::QueuePrefetch(const uint32 x, const uint32 y)
+{
+    MANGOS_ASSERT(x < MAX_NUMBER_OF_GRIDS);
+    MANGOS_ASSERT(y < MAX_NUMBER_OF_GRIDS);
+
+    {
+        LOCK_GUARD lock(m_prefetchMutex);
+        if (m_prefetchQueued[x][y] || m_prefetched[x][y])
+            return;
+
+        LOCK_GUARD mapLock(m_mutex);
+        if (m_GridMaps[x][y])
+            return;
+
+        m_prefetchQueued[x][y] = true;
+    }
+
+    // keeps the terrain from being unloaded until the request is done
+    AddRef();
+    sTerrainMgr.QueuePrefetch(this, x, y);
+}
+
+void TerrainInfo::Prefetch(const uint32 x, const uint32 y)
+{
+    PrefetchedGrid* prefetched = new PrefetchedGrid;
+
+    prefetched->map = new GridMap();
+
+    int len = sWorld.GetDataPath().length() + strlen("maps/%03u%02u%02u.map") + 1;
+    char* tmp = new char[len];
+    snprintf(tmp, len, (char*)(sWorld.GetDataPath() + "maps/%03u%02u%02u.map").c_str(), m_mapId, x, y);
+    if (!prefetched->map->loadData(tmp))
+        sLog.outError("Error load map file: %s", tmp);
+    delete[] tmp;
+
+    prefetched->navSize = 0;
+    prefetched->navData = MMAP::MMapManager::readTile(m_mapId, x, y, prefetched->navSize);
+    prefetched->readTime = WorldTimer::getMSTime();
+
+    {
+        LOCK_GUARD lock(m_prefetchMutex);
+        m_prefetchQueued[x][y] = false;
+        std::swap(m_prefetched[x][y], prefetched);
+    }
+
+    DeletePrefetched(prefetched);
+    Release();
+}
+
+TerrainInfo::PrefetchedGrid* TerrainInfo::TakePrefetched(const uint32 x, const uint32 y)
+{
+    LOCK_GUARD lock(m_prefetchMutex);
+    PrefetchedGrid* prefetched = m_prefetched[x][y];
+    m_prefetched[x][y] = nullptr;
+    return prefetched;
+}
+
+void TerrainInfo::DeletePrefetched(PrefetchedGrid* prefetched)
+{
+    if (!prefetched)
+        return;
+
+    delete prefetched->map;
+    dtFree(prefetched->navData);
+    delete prefetched;
+}
+
 int TerrainInfo::RefGrid(const uint32& x, const uint32& y)
 {
     MANGOS_ASSERT(x < MAX_NUMBER_OF_GRIDS);
@@ -1252,10 +1406,18 @@ GridMap* TerrainInfo::LoadMapAndVMap(const uint32 x, const uint32 y, bool mapOnl
         return m_GridMaps[x][y];
     }
 
+    // files read ahead by the prefetch thread, only map threads publish them
+    PrefetchedGrid* prefetched = mapOnly ? nullptr : TakePrefetched(x, y);
+
     {
         LOCK_GUARD lock(m_mutex);
         // double checked lock pattern
-        if (!m_GridMaps[x][y])
+        if (!m_GridMaps[x][y] && prefetched)
+        {
+            m_GridMaps[x][y] = prefetched->map;
+            prefetched->map = nullptr;
+        }
+        else if (!m_GridMaps[x][y])
         {
             GridMap* map = new GridMap();
 
@@ -1303,10 +1465,21 @@ GridMap* TerrainInfo::LoadMapAndVMap(const uint32 x, const uint32 y, bool mapOnl
 
     if (!MMAP::MMapFactory::createOrGetMMapManager()->IsMMapIsLoaded(m_mapId, x, y))
     {
-        // load navmesh
-        MMAP::MMapFactory::createOrGetMMapManager()->loadMap(m_mapId, x, y);
+        // load navmesh, loadMap takes over the prefetched tile data
+        if (prefetched && prefetched->navData)
+        {
+            MMAP::MMapFactory::createOrGetMMapManager()->loadMap(m_mapId, x, y, prefetched->navData, prefetched->navSize);
+            prefetched->navData = nullptr;
+        }
+        else
+            MMAP::MMapFactory::createOrGetMMapManager()->loadMap(m_mapId, x, y);
     }
 
+    if (!m_navMeshQueryPool)
+        m_navMeshQueryPool = MMAP::MMapFactory::createOrGetMMapManager()->GetNavMeshQueryPool(m_mapId);
+
+    DeletePrefetched(prefetched);
+
     if (m_GridMaps[x][y])
         m_GridMaps[x][y]->SetFullyLoaded();
 
@@ -1393,12 +1566,54 @@ void TerrainManager::Update(const uint32 diff)
 
 void TerrainManager::UnloadAll()
 {
+    StopPrefetchThread();
+
     for (auto& it : i_TerrainMap)
         delete it.second;
 
     i_TerrainMap.clear();
 }
 
+void TerrainManager::StartPrefetchThread()
+{
+    std::lock_guard<std::mutex> guard(m_prefetchThreadLock);
+    if (m_prefetchThread.joinable())
+        return;
+
+    m_prefetchThread = std::thread(&TerrainManager::PrefetchThread, this);
+}
+
+void TerrainManager::StopPrefetchThread()
+{
+    std::lock_guard<std::mutex> guard(m_prefetchThreadLock);
+    if (!m_prefetchThread.joinable())
+        return;
+
+    // requests still queued are dropped, the terrains are about to be unloaded anyway
+    m_prefetchQueue.Cancel();
+    m_prefetchThread.join();
+}
+
+void TerrainManager::QueuePrefetch(TerrainInfo* terrain, uint32 x, uint32 y)
+{
+    // started on first use, GridPrefetch.Lookahead may have been turned on by a config reload
+    StartPrefetchThread();
+    m_prefetchQueue.Push({ terrain, x, y });
+}
+
+void TerrainManager::PrefetchThread()
+{
+    while (true)
+    {
+        PrefetchRequest request = { nullptr, 0, 0 };
+        m_prefetchQueue.WaitAndPop(request);
+        if (!request.terrain)                               // canceled
+            break;
+
+        request.terrain->Prefetch(request.x, request.y);
+    }
+}
+
 uint32 TerrainManager::GetAreaIdByAreaFlag(uint16 areaflag, uint32 map_id)
 {
     AreaTableEntry const* entry = GetAreaEntryByAreaFlagAndMap(areaflag, map_id);
@@ -25,9 +25,13 @@
 #include "Entities/ObjectDefines.h"
 
 #include "Maps/GridMapDefines.h"
+#include "MappedFile.h"
+#include "ProducerConsumerQueue.h"
 
 #include <atomic>
 #include <mutex>
+#include <thread>
+#include <vector>
 
 class Creature;
 class Unit;
@@ -37,29 +41,41 @@ class Group;
 class BattleGround;
 class Map;
 
+namespace MMAP
+{
+    class NavMeshQueryPool;
+}
+
 class GridMap
 {
     private:
         uint32 m_flags;
 
+        // the whole .map file, mapped or read into m_fileBuffer; all data arrays below point into it
+        MappedFile m_mappedFile;
+        std::vector<uint8> m_fileBuffer;
+        uint8 const* m_fileData;
+        size_t m_fileSize;
+        std::vector<std::vector<uint8>> m_unalignedArrays;
+
         // Area data
         uint16 m_gridArea;
-        uint16* m_area_map;
+        uint16 const* m_area_map;
 
         // Height level data
         float m_gridHeight;
         float m_gridIntHeightMultiplier;
         union
         {
-            float* m_V9;
-            uint16* m_uint16_V9;
-            uint8* m_uint8_V9;
+            float const* m_V9;
+            uint16 const* m_uint16_V9;
+            uint8 const* m_uint8_V9;
         };
         union
         {
-            float* m_V8;
-            uint16* m_uint16_V8;
-            uint8* m_uint8_V8;
+            float const* m_V8;
+            uint16 const* m_uint16_V8;
+            uint8 const* m_uint8_V8;
         };
 
         // Liquid data
@@ -70,19 +86,23 @@ class GridMap
         uint8 m_liquid_width;
         uint8 m_liquid_height;
         float m_liquidLevel;
-        uint16* m_liquidEntry;
-        uint8* m_liquidFlags;
-        float* m_liquid_map;
+        uint16 const* m_liquidEntry;
+        uint8 const* m_liquidFlags;
+        float const* m_liquid_map;
 
-        uint16* m_holes;
+        uint16 const* m_holes;
 
         // For fast check
         bool m_fullyLoaded;
 
-        bool loadAreaData(FILE* in, uint32 offset, uint32 size);
-        bool loadHeightData(FILE* in, uint32 offset, uint32 size);
-        bool loadGridMapLiquidData(FILE* in, uint32 offset, uint32 size);
-        bool loadHolesData(FILE* in, uint32 offset, uint32 size);
+        bool loadFile(char const* filename);
+        template<typename T> bool readHeader(T& header, uint32 offset) const;
+        template<typename T> T const* getArray(uint32 offset, size_t count);
+
+        bool loadAreaData(uint32 offset, uint32 size);
+        bool loadHeightData(uint32 offset, uint32 size);
+        bool loadGridMapLiquidData(uint32 offset, uint32 size);
+        bool loadHolesData(uint32 offset, uint32 size);
         bool isHole(int row, int col) const;
 
         // Get height functions and pointers
@@ -161,12 +181,20 @@ class TerrainInfo : public Referencable<std::atomic_long>
         bool GetAreaInfo(float x, float y, float z, uint32& flags, int32& adtId, int32& rootId, int32& groupId) const;
         bool IsOutdoors(float x, float y, float z) const;
 
+        // navmesh queries of the map, nullptr until its first navmesh tile is loaded
+        MMAP::NavMeshQueryPool* GetNavMeshQueryPool() const { return m_navMeshQueryPool; }
+
         // this method should be used only by TerrainManager
         // to cleanup unreferenced GridMap objects - they are too heavy
         // to destroy them dynamically, especially on highly populated servers
         // THIS METHOD IS NOT THREAD-SAFE!!!! AND IT SHOULDN'T BE THREAD-SAFE!!!!
         void CleanUpGrids(const uint32 diff);
 
+        // queue reading the terrain and navmesh files of a grid on the prefetch thread, if not loaded or queued yet
+        void QueuePrefetch(const uint32 x, const uint32 y);
+        // prefetch thread only: read the files, the map threads take them over in LoadMapAndVMap
+        void Prefetch(const uint32 x, const uint32 y);
+
     protected:
         friend class Map;
         friend class ObjectMgr;
@@ -184,6 +212,18 @@ class TerrainInfo : public Referencable<std::atomic_long>
         int RefGrid(const uint32& x, const uint32& y);
         int UnrefGrid(const uint32& x, const uint32& y);
 
+        // files of a grid read ahead by the prefetch thread, not yet part of the terrain
+        struct PrefetchedGrid
+        {
+            GridMap* map;
+            unsigned char* navData;                         // dtAlloc'ed mmtile, nullptr if there is none
+            uint32 navSize;
+            uint32 readTime;
+        };
+
+        PrefetchedGrid* TakePrefetched(const uint32 x, const uint32 y);
+        static void DeletePrefetched(PrefetchedGrid* prefetched);
+
         const uint32 m_mapId;
 
         GridMap* m_GridMaps[MAX_NUMBER_OF_GRIDS][MAX_NUMBER_OF_GRIDS];
@@ -196,6 +236,13 @@ class TerrainInfo : public Referencable<std::atomic_long>
         typedef std::lock_guard<LOCK_TYPE> LOCK_GUARD;
         LOCK_TYPE m_mutex;
         LOCK_TYPE m_refMutex;
+
+        PrefetchedGrid* m_prefetched[MAX_NUMBER_OF_GRIDS][MAX_NUMBER_OF_GRIDS];
+        bool m_prefetchQueued[MAX_NUMBER_OF_GRIDS][MAX_NUMBER_OF_GRIDS];
+        LOCK_TYPE m_prefetchMutex;
+
+        // the map's navmesh is only unloaded with the terrain
+        std::atomic<MMAP::NavMeshQueryPool*> m_navMeshQueryPool;
 };
 
 // class for managing TerrainData object and all sort of geometry querying operations
@@ -211,6 +258,11 @@ class TerrainManager : public MaNGOS::Singleton<TerrainManager, MaNGOS::ClassLev
         void Update(const uint32 diff);
         void UnloadAll();
 
+        // background thread reading grid files ahead of moving players, see Map::PrefetchGridsAhead.
+        // It is started by the first request
+        void StopPrefetchThread();
+        void QueuePrefetch(TerrainInfo* terrain, uint32 x, uint32 y);
+
         uint16 GetAreaFlag(uint32 mapid, float x, float y, float z) const
         {
             TerrainInfo* pData = const_cast<TerrainManager*>(this)->LoadTerrain(mapid);
@@ -242,6 +294,20 @@ class TerrainManager : public MaNGOS::Singleton<TerrainManager, MaNGOS::ClassLev
 
         typedef MaNGOS::ClassLevelLockable<TerrainManager, std::mutex>::Lock Guard;
         TerrainDataMap i_TerrainMap;
+
+        struct PrefetchRequest
+        {
+            TerrainInfo* terrain;
+            uint32 x;
+            uint32 y;
+        };
+
+        void StartPrefetchThread();
+        void PrefetchThread();
+
+        ProducerConsumerQueue<PrefetchRequest> m_prefetchQueue;
+        std::mutex m_prefetchThreadLock;
+        std::thread m_prefetchThread;
 };
 
 #define sTerrainMgr TerrainManager::Instance()
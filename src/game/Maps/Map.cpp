@@ -41,6 +41,7 @@
 #include "Chat/Chat.h"
 #include "Weather/Weather.h"
 #include "Grids/ObjectGridLoader.h"
+#include "Movement/MoveSpline.h"
 
 #ifdef BUILD_METRICS
  #include "Metric/Metric.h"
@@ -59,9 +60,6 @@ Map::~Map()
     delete i_data;
     i_data = nullptr;
 
-    // unload instance specific navigation data
-    MMAP::MMapFactory::createOrGetMMapManager()->unloadMapInstance(m_TerrainData->GetMapId(), GetInstanceId());
-
     // release reference count
     if (m_TerrainData->Release())
         sTerrainMgr.UnloadTerrain(m_TerrainData->GetMapId());
@@ -158,7 +156,7 @@ Map::Map(uint32 id, time_t expiry, uint32 InstanceId, uint8 SpawnMode)
       m_activeNonPlayersIter(m_activeNonPlayers.end()), m_onEventNotifiedIter(m_onEventNotifiedObjects.end()),
       i_gridExpiry(expiry), m_TerrainData(sTerrainMgr.LoadTerrain(id)),
       i_data(nullptr), i_script_id(0), m_transportsIterator(m_transports.begin()), i_defaultLight(GetDefaultMapLight(id)), m_spawnManager(*this),
-      m_variableManager(this)
+      m_variableManager(this), m_pendingUpdateDiff(0)
 {
     m_weatherSystem = new WeatherSystem(this);
 }
@@ -667,6 +665,16 @@ void Map::VisitNearbyCellsOf(WorldObject* obj, TypeContainerVisitor<MaNGOS::Obje
     }
 }
 
+uint32 Map::GetUpdateInterval() const
+{
+    // maps with players tick at their configured rate, 0 meaning every MapManager tick, empty ones may tick slower
+    uint32 interval = sWorld.GetMapUpdateInterval(GetId());
+    if (HavePlayers())
+        return interval;
+
+    return std::max(interval, sWorld.getConfig(CONFIG_UINT32_INTERVAL_MAPUPDATE_IDLE));
+}
+
 void Map::Update(const uint32& t_diff)
 {
 
@@ -802,7 +810,12 @@ void Map::Update(const uint32& t_diff)
     meas.add_field("count", std::to_string(static_cast<int32>(count)));
 #endif
 
-    // Send world objects and item update field changes
+    // create and out of range blocks of everything that moved this tick
+    ProcessVisibilityUpdates();
+
+    // Queue world objects and item update field changes, MapManager builds and sends them once all maps are done.
+    // Packets sent directly from here on (ScriptsProcess, i_data->Update, weather) are held back by the sessions
+    // and follow this tick's update blocks, as when SendObjectUpdates sent them right away.
     SendObjectUpdates();
 
     // Don't unload grids if it's battleground, since we may have manually added GOs,creatures, those doesn't load from DB at grid re-load !
@@ -939,8 +952,14 @@ void Map::PlayerRelocation(Player* player, float x, float y, float z, float orie
     Cell new_cell(new_val);
     bool same_cell = (new_cell == old_cell);
 
+    float oldX = player->GetPositionX();
+    float oldY = player->GetPositionY();
+
     player->Relocate(x, y, z, orientation);
 
+    if (!same_cell)
+        PrefetchGridsAhead(player, oldX, oldY);
+
     if (old_cell.DiffGrid(new_cell) || old_cell.DiffCell(new_cell))
     {
         DEBUG_FILTER_LOG(LOG_FILTER_PLAYER_MOVES, "Player %s relocation grid[%u,%u]cell[%u,%u]->grid[%u,%u]cell[%u,%u]", player->GetName(), old_cell.GridX(), old_cell.GridY(), old_cell.CellX(), old_cell.CellY(), new_cell.GridX(), new_cell.GridY(), new_cell.CellX(), new_cell.CellY());
@@ -966,6 +985,43 @@ void Map::PlayerRelocation(Player* player, float x, float y, float z, float orie
     }
 }
 
+// have the terrain files of the grids the player is heading to read in the background before they are entered
+void Map::PrefetchGridsAhead(Player const* player, float oldX, float oldY)
+{
+    uint32 lookahead = sWorld.getConfig(CONFIG_UINT32_GRID_PREFETCH_LOOKAHEAD);
+    if (!lookahead)
+        return;
+
+    float dx = player->GetPositionX() - oldX;
+    float dy = player->GetPositionY() - oldY;
+    float moved = sqrt(dx * dx + dy * dy);
+    if (moved < 1.0f)
+        return;
+
+    float speed = player->IsTaxiFlying() && !player->movespline->Finalized() ? player->movespline->Speed() : player->GetSpeed(player->IsFlying() ? MOVE_FLIGHT : MOVE_RUN);
+    float distance = std::min(speed * lookahead, float(MAX_NUMBER_OF_GRIDS * SIZE_OF_GRIDS / 4));
+
+    // sample the line often enough not to step over a grid
+    for (float step = SIZE_OF_GRIDS / 2; step <= distance; step += SIZE_OF_GRIDS / 2)
+    {
+        float px = player->GetPositionX() + dx / moved * step;
+        float py = player->GetPositionY() + dy / moved * step;
+        if (!MaNGOS::IsValidMapCoord(px, py))
+            break;
+
+        GridPair p = MaNGOS::ComputeGridPair(px, py);
+        if (p.x_coord >= MAX_NUMBER_OF_GRIDS || p.y_coord >= MAX_NUMBER_OF_GRIDS)
+            break;
+
+        // z coord
+        int gx = (MAX_NUMBER_OF_GRIDS - 1) - p.x_coord;
+        int gy = (MAX_NUMBER_OF_GRIDS - 1) - p.y_coord;
+
+        if (!m_bLoadedGrids[gx][gy])
+            m_TerrainData->QueuePrefetch(gx, gy);
+    }
+}
+
 void Map::CreatureRelocation(Creature* creature, float x, float y, float z, float ang)
 {
     Cell new_cell(MaNGOS::ComputeCellPair(x, y));
@@ -1216,6 +1272,32 @@ void Map::UpdateObjectVisibility(WorldObject* obj, Cell cell, const CellPair& ce
             player->UpdateVisibilityOf(player->GetCamera().GetBody(), obj);
 }
 
+void Map::ScheduleVisibilityUpdate(Unit* unit)
+{
+    if (unit->IsVisibilityUpdateScheduled())
+        return;
+
+    unit->SetVisibilityUpdateScheduled(true);
+    m_visibilityUpdates.push_back(unit->GetObjectGuid());
+}
+
+void Map::ProcessVisibilityUpdates()
+{
+    // a unit moving several times per tick (client movement packets, splines) pays one evaluation
+    for (size_t i = 0; i < m_visibilityUpdates.size(); ++i)
+    {
+        Unit* unit = GetUnit(m_visibilityUpdates[i]);
+        if (!unit || !unit->IsInWorld() || !unit->IsVisibilityUpdateScheduled())
+            continue;
+
+        unit->SetVisibilityUpdateScheduled(false);
+        unit->GetViewPoint().Call_UpdateVisibilityForMovedOwner();
+        unit->UpdateObjectVisibility();
+    }
+
+    m_visibilityUpdates.clear();
+}
+
 void Map::SendInitSelf(Player* player) const
 {
     DETAIL_LOG("Creating player data for himself %u", player->GetGUIDLow());
@@ -2255,20 +2337,111 @@ void Map::SendObjectUpdates()
 {
     UpdateDataMapType update_players;
 
-    while (!i_objectsToClientUpdate.empty())
-    {
-        Object* obj = *i_objectsToClientUpdate.begin();
-        i_objectsToClientUpdate.erase(i_objectsToClientUpdate.begin());
+    while (Object* obj = i_objectsToClientUpdate.PopFront())
         obj->BuildUpdateData(update_players);
-    }
 
+    // packets are built later by MapManager, sessions without updates are queued too so their socket gets flushed
     for (auto& update_player : update_players)
+        m_pendingClientUpdates.emplace_back(update_player.first->GetSession(), std::move(update_player.second));
+
+    for (m_mapRefIter = m_mapRefManager.begin(); m_mapRefIter != m_mapRefManager.end(); ++m_mapRefIter)
+        if (Player* player = m_mapRefIter->getSource())
+            if (update_players.find(player) == update_players.end())
+                m_pendingClientUpdates.emplace_back(player->GetSession(), UpdateData());
+
+    // anything sent directly for the rest of the tick must not overtake the queued update blocks
+    for (auto& pending : m_pendingClientUpdates)
+        pending.first->DeferPackets();
+}
+
+void Map::QueuePathRequest(Unit const& owner, PathRequestPtr const& request)
+{
+    if (m_pathCache.Find(owner, request->key, request->start, request->end, request->forceDest, request->path, request->type))
+    {
+        request->ready = true;
+        return;
+    }
+
+    std::lock_guard<std::mutex> guard(m_pathRequestsLock);
+    m_pathRequests.push_back(request);
+}
+
+void Map::PreparePathRequests()
+{
+    // the generator or its owner may be gone since the request was queued
+    for (auto itr = m_pathRequests.begin(); itr != m_pathRequests.end();)
+    {
+        PathRequest& request = **itr;
+        Unit* owner = itr->use_count() > 1 ? GetUnit(request.ownerGuid) : nullptr;
+        if (owner && owner->IsInWorld() && owner->GetMap() == this)
+        {
+            request.owner = owner;
+            ++itr;
+        }
+        else
+        {
+            request.path = { request.start, request.end };
+            request.type = PATHFIND_NOPATH;
+            request.ready = true;
+            itr = m_pathRequests.erase(itr);
+        }
+    }
+}
+
+void Map::CalculatePathRequests(size_t begin, size_t end)
+{
+    for (size_t i = begin; i < end; ++i)
+    {
+        PathRequest& request = *m_pathRequests[i];
+        auto start = std::chrono::steady_clock::now();
+
+        PathFinder path(request.owner);
+        if (request.pathLength != 0.0f)
+            path.setPathLengthLimit(request.pathLength);
+        path.calculate(request.start, request.end, request.forceDest);
+
+        request.path = path.getPath();
+        request.type = path.getPathType();
+        request.duration = uint32(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+    }
+}
+
+void Map::FinishPathRequests(std::vector<uint32>& durations)
+{
+    for (PathRequestPtr const& request : m_pathRequests)
+    {
+        m_pathCache.Insert(request->key, request->path, request->type);
+        durations.push_back(request->duration);
+        request->owner = nullptr;
+        request->ready = true;
+    }
+    m_pathRequests.clear();
+
+    m_pathCache.Update(WorldTimer::getMSTime());
+}
+
+void Map::SendPendingClientUpdates(size_t begin, size_t end, uint32& packets, uint32& bytes)
+{
+    for (size_t i = begin; i < end; ++i)
     {
-        for (size_t i = 0; i < update_player.second.GetPacketCount(); ++i)
+        WorldSession* session = m_pendingClientUpdates[i].first;
+        UpdateData& data = m_pendingClientUpdates[i].second;
+
+        if (data.HasData())
         {
-            WorldPacket packet = update_player.second.BuildPacket(i);
-            update_player.first->GetSession()->SendPacket(packet);
+            for (size_t j = 0; j < data.GetPacketCount(); ++j)
+            {
+                WorldPacket packet = data.BuildPacket(j);
+                session->SendPacket(packet);
+                bytes += packet.size();
+                ++packets;
+            }
         }
+
+        session->SendDeferredPackets();
+
+        // everything of this tick is queued now, send it out as one write per client instead of waiting for the socket timer
+        session->FlushPackets();
     }
 }
 
@@ -2440,6 +2613,15 @@ bool Map::IsInLineOfSight(float srcX, float srcY, float srcZ, float destX, float
            && m_dyn_tree.isInLineOfSight(srcX, srcY, srcZ, destX, destY, destZ, phasemask, ignoreM2Model);
 }
 
+/**
+ * Line of sight check for a list of point pairs at once, the static rays are traversed in packets
+ */
+void Map::IsInLineOfSight(VMAP::LineOfSightQuery* queries, uint32 count, bool ignoreM2Model) const
+{
+    VMAP::VMapFactory::createOrGetVMapManager()->isInLineOfSight(GetId(), queries, count, ignoreM2Model);
+    m_dyn_tree.isInLineOfSight(queries, count, ignoreM2Model);
+}
+
 /**
  * get the hit position and return true if we hit something (in this case the dest position will hold the hit-position)
  * otherwise the result pos will be the dest pos
@@ -39,6 +39,7 @@
 #include "Maps/SpawnManager.h"
 #include "Maps/MapDataContainer.h"
 #include "World/WorldStateVariableManager.h"
+#include "MotionGenerators/PathRequest.h"
 
 #include <bitset>
 #include <functional>
@@ -147,6 +148,35 @@ class Map : public GridRefManager<NGridType>
         void VisitNearbyCellsOf(WorldObject* obj, TypeContainerVisitor<MaNGOS::ObjectUpdater, GridTypeMapContainer> &gridVisitor, TypeContainerVisitor<MaNGOS::ObjectUpdater, WorldTypeMapContainer> &worldVisitor);
         virtual void Update(const uint32&);
 
+        // every map ticks on its own interval, MapManager hands the time skipped meanwhile to the next update
+        bool IsUpdateDue(uint32 diff)
+        {
+            m_pendingUpdateDiff += diff;
+            return m_pendingUpdateDiff >= GetUpdateInterval();
+        }
+        uint32 TakePendingUpdateDiff()
+        {
+            uint32 diff = m_pendingUpdateDiff;
+            m_pendingUpdateDiff = 0;
+            return diff;
+        }
+        uint32 GetUpdateInterval() const;
+
+        // update blocks collected at the end of Update(), MapManager builds and compresses the packets
+        // in parallel for all maps once every map finished its tick, each session belongs to one entry only
+        size_t GetPendingClientUpdateCount() const { return m_pendingClientUpdates.size(); }
+        void SendPendingClientUpdates(size_t begin, size_t end, uint32& packets, uint32& bytes);
+        void ClearPendingClientUpdates() { m_pendingClientUpdates.clear(); }
+
+        // movement generators queue their paths during Update(), MapManager calculates them on the map
+        // workers after all maps finished their tick and the generators pick them up on a later tick
+        void QueuePathRequest(Unit const& owner, PathRequestPtr const& request);
+        void PreparePathRequests();
+        size_t GetPendingPathRequestCount() const { return m_pathRequests.size(); }
+        void CalculatePathRequests(size_t begin, size_t end);
+        void FinishPathRequests(std::vector<uint32>& durations);
+        PathCache& GetPathCache() { return m_pathCache; }
+
         void MessageBroadcast(Player const*, WorldPacket const&, bool to_self);
         void MessageBroadcast(WorldObject const*, WorldPacket const&);
         void MessageDistBroadcast(Player const*, WorldPacket const&, float dist, bool to_self, bool own_team_only = false);
@@ -241,6 +271,8 @@ class Map : public GridRefManager<NGridType>
         void AddObjectToRemoveList(WorldObject* obj);
 
         void UpdateObjectVisibility(WorldObject* obj, Cell cell, const CellPair& cellpair);
+        // units that moved far enough to change what they see or who sees them, evaluated once per tick
+        void ScheduleVisibilityUpdate(Unit* unit);
 
         void resetMarkedCells() { marked_cells.reset(); }
         bool isCellMarked(uint32 pCellId) const { return marked_cells.test(pCellId); }
@@ -305,12 +337,12 @@ class Map : public GridRefManager<NGridType>
 
         void AddUpdateObject(Object* obj)
         {
-            i_objectsToClientUpdate.insert(obj);
+            i_objectsToClientUpdate.Add(obj);
         }
 
         void RemoveUpdateObject(Object* obj)
         {
-            i_objectsToClientUpdate.erase(obj);
+            i_objectsToClientUpdate.Remove(obj);
         }
 
         // DynObjects currently
@@ -331,6 +363,7 @@ class Map : public GridRefManager<NGridType>
         float GetHeight(uint32 phasemask, float x, float y, float z, bool swim = false) const;
         bool GetHeightInRange(uint32 phasemask, float x, float y, float& z, float maxSearchDist = 4.0f) const;
         bool IsInLineOfSight(float srcX, float srcY, float srcZ, float destX, float destY, float destZ, uint32 phasemask, bool ignoreM2Model) const;
+        void IsInLineOfSight(VMAP::LineOfSightQuery* queries, uint32 count, bool ignoreM2Model) const;
         bool GetHitPosition(float srcX, float srcY, float srcZ, float& destX, float& destY, float& destZ, uint32 phasemask, float modifyDist) const;
 
         // Object Model insertion/remove/test for dynamic vmaps use
@@ -418,6 +451,7 @@ class Map : public GridRefManager<NGridType>
         void EnsureGridCreated(const GridPair&);
         bool EnsureGridLoaded(Cell const&);
         void EnsureGridLoadedAtEnter(Cell const&, Player* player = nullptr);
+        void PrefetchGridsAhead(Player const* player, float oldX, float oldY);
 
         void buildNGridLinkage(NGridType* pNGridType) { pNGridType->link(this); }
 
@@ -434,8 +468,16 @@ class Map : public GridRefManager<NGridType>
         void setNGrid(NGridType* grid, uint32 x, uint32 y);
         void ScriptsProcess();
 
+        void ProcessVisibilityUpdates();
+        std::vector<ObjectGuid> m_visibilityUpdates;
+
         void SendObjectUpdates();
-        std::set<Object*> i_objectsToClientUpdate;
+        ClientUpdateList i_objectsToClientUpdate;
+        std::vector<std::pair<WorldSession*, UpdateData> > m_pendingClientUpdates;
+
+        std::mutex m_pathRequestsLock;
+        std::vector<PathRequestPtr> m_pathRequests;
+        PathCache m_pathCache;
 
     protected:
         MapEntry const* i_mapEntry;
@@ -523,6 +565,8 @@ class Map : public GridRefManager<NGridType>
         uint32 i_defaultLight;
 
         TimePoint m_dynamicDifficultyCooldown;
+
+        uint32 m_pendingUpdateDiff;
 };
 
 class WorldMap : public Map
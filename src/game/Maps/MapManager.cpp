@@ -28,13 +28,19 @@
 #include "Globals/ObjectMgr.h"
 #include "Maps/MapWorkers.h"
 #include <future>
+#include <algorithm>
+
+#ifdef BUILD_METRICS
+ #include "Metric/Metric.h"
+#endif
 
 #define CLASS_LOCK MaNGOS::ClassLevelLockable<MapManager, std::recursive_mutex>
 INSTANTIATE_SINGLETON_2(MapManager, CLASS_LOCK);
 INSTANTIATE_CLASS_MUTEX(MapManager, std::recursive_mutex);
 
 MapManager::MapManager()
-    : i_gridCleanUpDelay(sWorld.getConfig(CONFIG_UINT32_INTERVAL_GRIDCLEAN))
+    : i_gridCleanUpDelay(sWorld.getConfig(CONFIG_UINT32_INTERVAL_GRIDCLEAN)), m_pathLatencyIndex(0), m_pathRequests(0), m_pathCacheLookups(0), m_pathCacheHits(0),
+      m_tickPathCacheLookups(0), m_tickPathCacheHits(0), m_predictedMakespan(0), m_actualMakespan(0)
 {
     i_timer.SetInterval(sWorld.getConfig(CONFIG_UINT32_INTERVAL_MAPUPDATE));
 }
@@ -182,6 +188,7 @@ void MapManager::DeleteInstance(uint32 mapid, uint32 instanceId)
         if (pMap->Instanceable())
         {
             i_maps.erase(iter);
+            m_mapUpdateCost.erase(pMap);
 
             pMap->UnloadAll(true);
             delete pMap;
@@ -195,17 +202,26 @@ void MapManager::Update(uint32 diff)
     if (!i_timer.Passed())
         return;
 
-    for (auto& map : i_maps)
+    if (m_updater.activated())
+        ScheduleMapUpdates((uint32)i_timer.GetCurrent());
+    else
     {
-        if (m_updater.activated())
-            m_updater.schedule_update(new MapUpdateWorker(*map.second, (uint32)i_timer.GetCurrent(), m_updater));
-        else
-            map.second->Update((uint32)i_timer.GetCurrent());
+        for (auto& map : i_maps)
+        {
+            if (map.second->IsUpdateDue((uint32)i_timer.GetCurrent()))
+            {
+                uint32 packets = 0, bytes = 0;
+                map.second->Update(map.second->TakePendingUpdateDiff());
+                map.second->PreparePathRequests();
+                map.second->CalculatePathRequests(0, map.second->GetPendingPathRequestCount());
+                FinishPathRequests(map.second);
+                map.second->SendPendingClientUpdates(0, map.second->GetPendingClientUpdateCount(), packets, bytes);
+                map.second->ClearPendingClientUpdates();
+            }
+        }
+        RecordPathRequestDurations();
     }
 
-    if (m_updater.activated())
-        m_updater.wait();
-
     // remove all maps which can be unloaded
     MapMapType::iterator iter = i_maps.begin();
     while (iter != i_maps.end())
@@ -214,6 +230,7 @@ void MapManager::Update(uint32 diff)
         // check if map can be unloaded
         if (pMap->CanUnload((uint32)i_timer.GetCurrent()))
         {
+            m_mapUpdateCost.erase(pMap);
             pMap->UnloadAll(true);
             delete pMap;
 
@@ -226,6 +243,225 @@ void MapManager::Update(uint32 diff)
     i_timer.SetCurrent(0);
 }
 
+void MapManager::ScheduleMapUpdates(uint32 diff)
+{
+    // longest job first: the most expensive maps of the previous ticks start right away
+    // so a heavy raid scheduled last can not stretch the whole tick
+    m_scheduleOrder.clear();
+    for (auto& map : i_maps)
+    {
+        // maps running on a slower interval sit this tick out and do not hold the barrier below
+        if (!map.second->IsUpdateDue(diff))
+            continue;
+
+        auto cost = m_mapUpdateCost.find(map.second);
+        m_scheduleOrder.emplace_back(cost != m_mapUpdateCost.end() ? cost->second : 0, map.second);
+    }
+
+    std::stable_sort(m_scheduleOrder.begin(), m_scheduleOrder.end(), [](std::pair<uint32, Map*> const& a, std::pair<uint32, Map*> const& b)
+    {
+        return a.first > b.first;
+    });
+
+    m_predictedMakespan = PredictMakespan();
+
+    auto start = std::chrono::steady_clock::now();
+
+    while (m_updateWorkers.size() < m_scheduleOrder.size())
+        m_updateWorkers.emplace_back(new MapUpdateWorker(m_updater));
+
+    for (size_t i = 0; i < m_scheduleOrder.size(); ++i)
+    {
+        m_updateWorkers[i]->SetMap(*m_scheduleOrder[i].second, m_scheduleOrder[i].second->TakePendingUpdateDiff());
+        m_updater.schedule_update(m_updateWorkers[i].get());
+    }
+
+    m_updater.wait();
+
+    m_actualMakespan = uint32(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+
+    SchedulePathRequests();
+    ScheduleClientUpdates();
+
+    // exponential moving average over roughly the last 8 ticks
+    for (size_t i = 0; i < m_scheduleOrder.size(); ++i)
+    {
+        MapUpdateWorker const* worker = m_updateWorkers[i].get();
+        auto cost = m_mapUpdateCost.find(worker->GetMap());
+        if (cost == m_mapUpdateCost.end())
+            m_mapUpdateCost.emplace(worker->GetMap(), worker->GetDuration());
+        else
+            cost->second = uint32(int64(cost->second) + (int64(worker->GetDuration()) - int64(cost->second)) / 8);
+    }
+
+#ifdef BUILD_METRICS
+    metric::measurement meas("map.makespan");
+    meas.add_field("predicted", std::to_string(m_predictedMakespan));
+    meas.add_field("actual", std::to_string(m_actualMakespan));
+    meas.add_field("maps", std::to_string(m_scheduleOrder.size()));
+#endif
+}
+
+void MapManager::ScheduleClientUpdates()
+{
+    // packet building and compression of all maps runs as one stage after the map ticks,
+    // sessions are cut in chunks so a single crowded map still spreads over all threads.
+    // Packets a map sent directly after queuing its updates are held back by the sessions and sent behind them
+    size_t const chunkSize = 16;
+
+#ifdef BUILD_METRICS
+    auto start = std::chrono::steady_clock::now();
+#endif
+
+    size_t workers = 0;
+    for (auto const& entry : m_scheduleOrder)
+    {
+        Map* map = entry.second;
+        size_t count = map->GetPendingClientUpdateCount();
+        for (size_t begin = 0; begin < count; begin += chunkSize)
+        {
+            if (workers == m_clientUpdateWorkers.size())
+                m_clientUpdateWorkers.emplace_back(new ClientUpdateWorker(m_updater));
+
+            m_clientUpdateWorkers[workers]->SetRange(*map, begin, std::min(begin + chunkSize, count));
+            m_updater.schedule_update(m_clientUpdateWorkers[workers].get());
+            ++workers;
+        }
+    }
+
+    if (workers)
+        m_updater.wait();
+
+    for (auto const& entry : m_scheduleOrder)
+        entry.second->ClearPendingClientUpdates();
+
+#ifdef BUILD_METRICS
+    uint32 packets = 0, bytes = 0, cpu = 0;
+    for (size_t i = 0; i < workers; ++i)
+    {
+        packets += m_clientUpdateWorkers[i]->GetPackets();
+        bytes += m_clientUpdateWorkers[i]->GetBytes();
+        cpu += m_clientUpdateWorkers[i]->GetDuration();
+    }
+
+    // cpu / packets and bytes / wall give the cost of a login or raid pull burst
+    metric::measurement meas("map.client_updates");
+    meas.add_field("wall", std::to_string(uint32(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count())));
+    meas.add_field("cpu", std::to_string(cpu));
+    meas.add_field("packets", std::to_string(packets));
+    meas.add_field("bytes", std::to_string(bytes));
+    meas.add_field("chunks", std::to_string(uint32(workers)));
+#endif
+}
+
+void MapManager::SchedulePathRequests()
+{
+    // paths queued by the movement generators of all maps, chunked like the client updates
+    // so the A* searches of one crowded continent spread over all threads
+    size_t const chunkSize = 8;
+
+    size_t workers = 0;
+    for (auto const& entry : m_scheduleOrder)
+    {
+        Map* map = entry.second;
+        map->PreparePathRequests();
+        size_t count = map->GetPendingPathRequestCount();
+        for (size_t begin = 0; begin < count; begin += chunkSize)
+        {
+            if (workers == m_pathRequestWorkers.size())
+                m_pathRequestWorkers.emplace_back(new PathRequestWorker(m_updater));
+
+            m_pathRequestWorkers[workers]->SetRange(*map, begin, std::min(begin + chunkSize, count));
+            m_updater.schedule_update(m_pathRequestWorkers[workers].get());
+            ++workers;
+        }
+    }
+
+    if (workers)
+        m_updater.wait();
+
+    for (auto const& entry : m_scheduleOrder)
+        FinishPathRequests(entry.second);
+
+    RecordPathRequestDurations();
+}
+
+void MapManager::FinishPathRequests(Map* map)
+{
+    map->FinishPathRequests(m_pathDurations);
+
+    uint32 lookups, hits;
+    map->GetPathCache().TakeCounters(lookups, hits);
+    m_pathCacheLookups += lookups;
+    m_pathCacheHits += hits;
+    m_tickPathCacheLookups += lookups;
+    m_tickPathCacheHits += hits;
+}
+
+void MapManager::RecordPathRequestDurations()
+{
+#ifdef BUILD_METRICS
+    // all fields are of this tick only
+    if (!m_pathDurations.empty() || m_tickPathCacheLookups)
+    {
+        metric::measurement meas("map.paths");
+        meas.add_field("requests", std::to_string(uint32(m_pathDurations.size())));
+        if (!m_pathDurations.empty())
+        {
+            std::vector<uint32> sorted(m_pathDurations);
+            std::sort(sorted.begin(), sorted.end());
+            meas.add_field("p50", std::to_string(sorted[sorted.size() / 2]));
+            meas.add_field("p99", std::to_string(sorted[sorted.size() * 99 / 100]));
+        }
+        meas.add_field("cache_lookups", std::to_string(m_tickPathCacheLookups));
+        meas.add_field("cache_hits", std::to_string(m_tickPathCacheHits));
+    }
+#endif
+
+    m_tickPathCacheLookups = 0;
+    m_tickPathCacheHits = 0;
+
+    m_pathRequests += m_pathDurations.size();
+    for (uint32 duration : m_pathDurations)
+    {
+        if (m_pathLatencies.size() < PATH_LATENCY_SAMPLES)
+            m_pathLatencies.push_back(duration);
+        else
+            m_pathLatencies[m_pathLatencyIndex] = duration;
+        m_pathLatencyIndex = (m_pathLatencyIndex + 1) % PATH_LATENCY_SAMPLES;
+    }
+
+    m_pathDurations.clear();
+}
+
+void MapManager::GetPathRequestStats(uint64& requests, uint64& cacheLookups, uint64& cacheHits, uint32& p50, uint32& p99) const
+{
+    requests = m_pathRequests;
+    cacheLookups = m_pathCacheLookups;
+    cacheHits = m_pathCacheHits;
+    p50 = 0;
+    p99 = 0;
+
+    if (m_pathLatencies.empty())
+        return;
+
+    std::vector<uint32> sorted(m_pathLatencies);
+    std::sort(sorted.begin(), sorted.end());
+    p50 = sorted[sorted.size() / 2];
+    p99 = sorted[sorted.size() * 99 / 100];
+}
+
+uint32 MapManager::PredictMakespan() const
+{
+    // replay the greedy assignment the updater threads do (plus the waiting thread that helps out)
+    // over the sorted costs, the busiest thread is the expected tick length
+    std::vector<uint32> threadLoad(m_updater.thread_count() + 1, 0);
+    for (auto const& entry : m_scheduleOrder)
+        *std::min_element(threadLoad.begin(), threadLoad.end()) += entry.first;
+
+    return *std::max_element(threadLoad.begin(), threadLoad.end());
+}
+
 void MapManager::RemoveAllObjectsInRemoveList()
 {
     for (auto& i_map : i_maps)
@@ -260,6 +496,8 @@ void MapManager::UnloadAll()
         i_maps.erase(i_maps.begin());
     }
 
+    m_mapUpdateCost.clear();
+
     if (m_updater.activated())
         m_updater.deactivate();
 
@@ -31,8 +31,13 @@
 
 class Transport;
 class BattleGround;
+class MapUpdateWorker;
+class ClientUpdateWorker;
+class PathRequestWorker;
 struct TransportTemplate;
 
+#define PATH_LATENCY_SAMPLES 4096
+
 struct MapID
 {
     explicit MapID(uint32 id) : nMapId(id), nInstanceId(0) {}
@@ -145,6 +150,12 @@ class MapManager : public MaNGOS::Singleton<MapManager, MaNGOS::ClassLevelLockab
         /* statistics */
         uint32 GetNumInstances();
         uint32 GetNumPlayersInInstances();
+        // makespan of the last threaded map update tick as predicted from past costs and as measured, in microseconds
+        uint32 GetPredictedUpdateMakespan() const { return m_predictedMakespan; }
+        uint32 GetUpdateMakespan() const { return m_actualMakespan; }
+
+        // totals of the queued path requests, latency percentiles in microseconds over the last PATH_LATENCY_SAMPLES paths
+        void GetPathRequestStats(uint64& requests, uint64& cacheLookups, uint64& cacheHits, uint32& p50, uint32& p99) const;
 
         // get list of all maps
         const MapMapType& Maps() const { return i_maps; }
@@ -187,7 +198,32 @@ class MapManager : public MaNGOS::Singleton<MapManager, MaNGOS::ClassLevelLockab
         MapMapType i_maps;
         IntervalTimer i_timer;
 
+        void ScheduleMapUpdates(uint32 diff);
+        void ScheduleClientUpdates();
+        void SchedulePathRequests();
+        void FinishPathRequests(Map* map);
+        void RecordPathRequestDurations();
+        uint32 PredictMakespan() const;
+
         MapUpdater m_updater;
+        std::vector<std::unique_ptr<MapUpdateWorker>> m_updateWorkers;     // reused every tick, one per scheduled map
+        std::vector<std::unique_ptr<ClientUpdateWorker>> m_clientUpdateWorkers; // reused every tick, one per chunk of sessions
+        std::vector<std::unique_ptr<PathRequestWorker>> m_pathRequestWorkers;   // reused every tick, one per chunk of path requests
+
+        std::vector<uint32> m_pathDurations;                // of the current tick
+        std::vector<uint32> m_pathLatencies;                // ring of the last PATH_LATENCY_SAMPLES durations
+        size_t m_pathLatencyIndex;
+        uint64 m_pathRequests;
+        uint64 m_pathCacheLookups;
+        uint64 m_pathCacheHits;
+        uint32 m_tickPathCacheLookups;                      // of the current tick
+        uint32 m_tickPathCacheHits;
+
+        // moving average of Map::Update wall time per map in microseconds, used to schedule the most expensive maps first
+        std::unordered_map<Map const*, uint32> m_mapUpdateCost;
+        std::vector<std::pair<uint32, Map*>> m_scheduleOrder;
+        uint32 m_predictedMakespan;
+        uint32 m_actualMakespan;
 };
 
 template<typename Do>
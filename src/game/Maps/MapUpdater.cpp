@@ -17,12 +17,14 @@
  */
 
 #include "MapUpdater.h"
-#include "MapWorkers.h"
 
-MapUpdater::MapUpdater(size_t num_threads) : _cancelationToken(false), pending_requests(0)
+// idle rounds a thread spins through before it parks on the condition variable
+static uint32 const MAP_UPDATER_SPIN_COUNT = 64;
+static size_t const MAP_UPDATER_QUEUE_SIZE = 1024;
+
+MapUpdater::MapUpdater(size_t num_threads) : _cancelationToken(false), pending_requests(0), _queued(0), _sleepers(0), _nextQueue(0)
 {
-    for (size_t i = 0; i < num_threads; ++i)
-        _workerThreads.push_back(std::thread(&MapUpdater::WorkerThread, this));
+    activate(num_threads);
 }
 
 void MapUpdater::activate(size_t num_threads)
@@ -30,26 +32,57 @@ void MapUpdater::activate(size_t num_threads)
     if (activated())
         return;
 
+    _cancelationToken = false;
+
     for (size_t i = 0; i < num_threads; ++i)
-        _workerThreads.push_back(std::thread(&MapUpdater::WorkerThread, this));
+        _queues.emplace_back(new WorkerQueue(MAP_UPDATER_QUEUE_SIZE));
+
+    for (size_t i = 0; i < num_threads; ++i)
+        _workerThreads.push_back(std::thread(&MapUpdater::WorkerThread, this, i));
 }
 
 void MapUpdater::deactivate()
 {
     _cancelationToken = true;
 
-    _queue.Cancel();
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        _workCondition.notify_all();
+    }
 
     for (auto& thread : _workerThreads)
         thread.join();
+
+    _workerThreads.clear();
+    _queues.clear();
+    _queued = 0;
 }
 
 void MapUpdater::wait()
 {
-    std::unique_lock<std::mutex> lock(_lock);
-
+    // the waiting thread helps draining the queues instead of idling, then parks until the last task is finished
+    uint32 spins = 0;
     while (pending_requests > 0)
-        _condition.wait(lock);
+    {
+        Worker* request = nullptr;
+        if (pop_task(0, request))
+        {
+            request->execute();
+            spins = 0;
+            continue;
+        }
+
+        if (++spins < MAP_UPDATER_SPIN_COUNT)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(_lock);
+        while (pending_requests > 0 && _queued == 0)
+            _doneCondition.wait(lock);
+        spins = 0;
+    }
 }
 
 void MapUpdater::join()
@@ -65,36 +98,92 @@ bool MapUpdater::activated()
 
 void MapUpdater::update_finished()
 {
-    std::lock_guard<std::mutex> lock(_lock);
-
-    --pending_requests;
-    _condition.notify_all();
+    if (--pending_requests == 0)
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        _doneCondition.notify_all();
+    }
 }
 
 void MapUpdater::schedule_update(Worker* worker)
 {
-    std::lock_guard<std::mutex> lock(_lock);
-
     ++pending_requests;
-    _queue.Push(std::move(worker));
+
+    // not activated (yet or any more), there is nobody to hand the task to
+    if (_queues.empty())
+    {
+        worker->execute();
+        return;
+    }
+
+    ++_queued;
+
+    // round robin over the thread queues, a full queue passes the task on to the next one
+    bool pushed = false;
+    for (size_t i = 0; i < _queues.size() && !pushed; ++i)
+        pushed = _queues[(_nextQueue + i) % _queues.size()]->Push(worker);
+
+    _nextQueue = (_nextQueue + 1) % _queues.size();
+
+    if (!pushed)
+    {
+        // all queues are full, rather run it here than block the caller
+        --_queued;
+        worker->execute();
+        return;
+    }
+
+    if (_sleepers > 0)
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        _workCondition.notify_one();
+    }
 }
 
-void MapUpdater::WorkerThread()
+bool MapUpdater::pop_task(size_t index, Worker*& worker)
 {
-    while (true)
+    if (_queues.empty())
+        return false;
+
+    // own queue first, then steal from the others
+    for (size_t i = 0; i < _queues.size(); ++i)
     {
-        Worker* request = nullptr;
+        if (_queues[(index + i) % _queues.size()]->Pop(worker))
+        {
+            --_queued;
+            return true;
+        }
+    }
 
-        _queue.WaitAndPop(request);
+    return false;
+}
 
-        if (_cancelationToken)
+void MapUpdater::WorkerThread(size_t index)
+{
+    uint32 spins = 0;
+    while (!_cancelationToken)
+    {
+        Worker* request = nullptr;
+        if (pop_task(index, request))
         {
-            delete request;
-            return;
+            request->execute();
+            spins = 0;
+            continue;
         }
 
-        request->execute();
+        if (++spins < MAP_UPDATER_SPIN_COUNT)
+        {
+            std::this_thread::yield();
+            continue;
+        }
 
-        delete request;
+        // _sleepers is raised before _queued is checked and schedule_update does it the other way round,
+        // so either this thread sees the new task or the producer sees a sleeper to wake
+        std::unique_lock<std::mutex> lock(_lock);
+        ++_sleepers;
+        while (_queued == 0 && !_cancelationToken)
+            _workCondition.wait(lock);
+        --_sleepers;
+        spins = 0;
     }
-}
\ No newline at end of file
+}
@@ -20,42 +20,73 @@
 #define _MAP_UPDATER_H_INCLUDED
 
 #include "Platform/Define.h"
-#include "ProducerConsumerQueue.h"
+#include "Multithreading/LockFreeQueue.h"
 
 #include <mutex>
 #include <thread>
 #include <atomic>
+#include <memory>
 #include <vector>
 #include <condition_variable>
 
 class Worker;
 
+/**
+ * Runs Worker tasks on a fixed set of threads.
+ * Every thread owns a lock free queue and steals from the others when its own runs dry,
+ * idle threads spin for a while before parking so a burst of tasks does not pay a wakeup each.
+ * Workers are owned by the caller and are never deleted here, they only have to stay alive until wait() returns.
+ * schedule_update and wait are expected to be called from a single thread.
+ */
 class MapUpdater
 {
     public:
-        MapUpdater() : _cancelationToken(false), pending_requests(0) {}
+        MapUpdater() : _cancelationToken(false), pending_requests(0), _queued(0), _sleepers(0), _nextQueue(0) {}
         MapUpdater(size_t num_threads);
         MapUpdater(const MapUpdater&) = delete;
-        
+
         void activate(size_t num_threads);
         void deactivate();
         void wait();
         void join();
         bool activated();
+        size_t thread_count() const { return _workerThreads.size(); }
         void update_finished();
         void schedule_update(Worker* worker);
 
     private:
-        ProducerConsumerQueue<Worker *> _queue;
+        typedef LockFreeQueue<Worker*> WorkerQueue;
 
+        std::vector<std::unique_ptr<WorkerQueue>> _queues;
         std::vector<std::thread> _workerThreads;
         std::atomic<bool> _cancelationToken;
 
+        std::atomic<size_t> pending_requests;               // scheduled but not finished
+        std::atomic<size_t> _queued;                        // scheduled but not picked up yet
+        std::atomic<size_t> _sleepers;
+        size_t _nextQueue;
+
+        // only taken to park and wake idle threads, never on the task path
         std::mutex _lock;
-        std::condition_variable _condition;
-        size_t pending_requests;
+        std::condition_variable _workCondition;
+        std::condition_variable _doneCondition;
+
+        bool pop_task(size_t index, Worker*& worker);
+        void WorkerThread(size_t index);
+};
 
-        void WorkerThread();
+class Worker
+{
+    public:
+        Worker(MapUpdater& updater) : m_updater(updater) {}
+        virtual ~Worker() = default;
+        virtual void execute() {};
+
+    protected:
+        MapUpdater& GetWorker() { return m_updater; }
+
+    private:
+        MapUpdater& m_updater;
 };
 
 #endif //_MAP_UPDATER_H_INCLUDED
\ No newline at end of file
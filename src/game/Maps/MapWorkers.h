@@ -26,36 +26,104 @@
 #include "Entities/Object.h"
 #include "Platform/Define.h"
 
-class Worker
+#include <chrono>
+
+class MapUpdateWorker : public Worker
 {
     public:
-        Worker(MapUpdater& updater) : m_updater(updater) {}
-        virtual ~Worker() = default;
-        virtual void execute() {};
+        MapUpdateWorker(MapUpdater& updater) :
+            Worker(updater), m_map(nullptr), m_diff(0), m_duration(0)
+        {}
 
-    protected:
-        MapUpdater& GetWorker() { return m_updater; }
+        // workers are reused between ticks, set up the next run before scheduling
+        void SetMap(Map& map, uint32 diff)
+        {
+            m_map = &map;
+            m_diff = diff;
+        }
+
+        Map* GetMap() const { return m_map; }
+        // wall time of the last Map::Update run by this worker, in microseconds
+        uint32 GetDuration() const { return m_duration; }
+
+        void execute() override
+        {
+            auto start = std::chrono::steady_clock::now();
+            m_map->Update(m_diff);
+            m_duration = uint32(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+            GetWorker().update_finished();
+        }
 
     private:
-        MapUpdater& m_updater;
+        Map* m_map;
+        uint32 m_diff;
+        uint32 m_duration;
 };
 
-class MapUpdateWorker : public Worker
+class ClientUpdateWorker : public Worker
+{
+    public:
+        ClientUpdateWorker(MapUpdater& updater) :
+            Worker(updater), m_map(nullptr), m_begin(0), m_end(0), m_packets(0), m_bytes(0), m_duration(0)
+        {}
+
+        // workers are reused between ticks, set up the next run before scheduling
+        void SetRange(Map& map, size_t begin, size_t end)
+        {
+            m_map = &map;
+            m_begin = begin;
+            m_end = end;
+        }
+
+        uint32 GetPackets() const { return m_packets; }
+        uint32 GetBytes() const { return m_bytes; }
+        // wall time of the last run, in microseconds
+        uint32 GetDuration() const { return m_duration; }
+
+        void execute() override
+        {
+            auto start = std::chrono::steady_clock::now();
+            m_packets = 0;
+            m_bytes = 0;
+            m_map->SendPendingClientUpdates(m_begin, m_end, m_packets, m_bytes);
+            m_duration = uint32(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+            GetWorker().update_finished();
+        }
+
+    private:
+        Map* m_map;
+        size_t m_begin;
+        size_t m_end;
+        uint32 m_packets;
+        uint32 m_bytes;
+        uint32 m_duration;
+};
+
+class PathRequestWorker : public Worker
 {
     public:
-        MapUpdateWorker(Map& map, uint32 diff, MapUpdater& updater) :
-            Worker(updater), m_map(map), m_diff(diff)
+        PathRequestWorker(MapUpdater& updater) :
+            Worker(updater), m_map(nullptr), m_begin(0), m_end(0)
         {}
 
+        // workers are reused between ticks, set up the next run before scheduling
+        void SetRange(Map& map, size_t begin, size_t end)
+        {
+            m_map = &map;
+            m_begin = begin;
+            m_end = end;
+        }
+
         void execute() override
         {
-            m_map.Update(m_diff);
+            m_map->CalculatePathRequests(m_begin, m_end);
             GetWorker().update_finished();
         }
 
     private:
-        Map& m_map;
-        uint32 m_diff;
+        Map* m_map;
+        size_t m_begin;
+        size_t m_end;
 };
 
 class GridCrawler : public Worker
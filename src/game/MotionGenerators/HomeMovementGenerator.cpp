@@ -61,26 +61,56 @@ void HomeMovementGenerator<Creature>::_setTargetLocation(Creature& owner)
         }
     }
 
-    PathFinder path(&owner);
+    homeOrientation = pos.GetPositionO();
+    arrived = false;
+    owner.clearUnitState(static_cast<uint32>(UNIT_STAT_ALL_DYN_STATES));
 
     Position curPos = owner.GetPosition(owner.GetTransport());
     // source and target pos must be local coords
-    path.calculate(G3D::Vector3(curPos.GetPositionX(), curPos.GetPositionY(), curPos.GetPositionZ()), G3D::Vector3(pos.GetPositionX(), pos.GetPositionY(), pos.GetPositionZ()), true);
+    G3D::Vector3 start(curPos.GetPositionX(), curPos.GetPositionY(), curPos.GetPositionZ());
+    G3D::Vector3 end(pos.GetPositionX(), pos.GetPositionY(), pos.GetPositionZ());
+
+    if (PathRequest::CanQueue(owner))
+    {
+        pathRequest = std::make_shared<PathRequest>(owner, start, end, true);
+        owner.GetMap()->QueuePathRequest(owner, pathRequest);
+        if (pathRequest->IsReady())
+        {
+            PathRequestPtr request = std::move(pathRequest);
+            _launchPath(owner, request->type, request->path);
+        }
+        return;
+    }
+
+    PathFinder path(&owner);
+    path.calculate(start, end, true);
 
+    _launchPath(owner, path.getPathType(), path.getPath());
+}
+
+void HomeMovementGenerator<Creature>::_launchPath(Creature& owner, PathType type, PointsArray& path)
+{
     Movement::MoveSplineInit init(owner);
-    init.MovebyPath(path.getPath());
+    init.MovebyPath(path);
     init.SetWalk(!runHome);
-    init.SetFacing(pos.GetPositionO());
-    if (path.getPathType() & (PATHFIND_NOPATH | PATHFIND_SHORTCUT))
+    init.SetFacing(homeOrientation);
+    if (type & (PATHFIND_NOPATH | PATHFIND_SHORTCUT))
         init.SetVelocity(400.f);
     init.Launch();
-
-    arrived = false;
-    owner.clearUnitState(static_cast<uint32>(UNIT_STAT_ALL_DYN_STATES));
 }
 
 bool HomeMovementGenerator<Creature>::Update(Creature& owner, const uint32& /*time_diff*/)
 {
+    if (pathRequest)
+    {
+        if (pathRequest->IsReady())
+        {
+            PathRequestPtr request = std::move(pathRequest);
+            _launchPath(owner, request->type, request->path);
+        }
+        return true;
+    }
+
     arrived = owner.movespline->Finalized();
     return !arrived;
 }
@@ -20,6 +20,7 @@
 #define MANGOS_HOMEMOVEMENTGENERATOR_H
 
 #include "MotionGenerators/MovementGenerator.h"
+#include "MotionGenerators/PathRequest.h"
 
 class Creature;
 
@@ -32,7 +33,7 @@ class HomeMovementGenerator<Creature>
 {
     public:
 
-        HomeMovementGenerator(bool _runHome = true) : arrived(false), runHome(_runHome), wasActive(false)
+        HomeMovementGenerator(bool _runHome = true) : homeOrientation(0.0f), arrived(false), runHome(_runHome), wasActive(false)
         {
         }
 
@@ -47,6 +48,9 @@ class HomeMovementGenerator<Creature>
 
     private:
         void _setTargetLocation(Creature&);
+        void _launchPath(Creature&, PathType type, PointsArray& path);
+        PathRequestPtr pathRequest;         // queued by _setTargetLocation, launched once the map calculated it
+        float homeOrientation;
         bool arrived;
         bool runHome;
         bool wasActive;
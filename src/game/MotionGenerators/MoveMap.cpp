@@ -195,10 +195,18 @@ namespace MMAP
     }
 
     bool MMapManager::loadMap(uint32 mapId, int32 x, int32 y)
+    {
+        return loadMap(mapId, x, y, nullptr, 0);
+    }
+
+    bool MMapManager::loadMap(uint32 mapId, int32 x, int32 y, unsigned char* data, uint32 size)
     {
         // make sure the mmap is loaded and ready to load tiles
         if (!loadMapData(mapId))
+        {
+            dtFree(data);
             return false;
+        }
 
         // get this mmap data
         MMapData* mmap = loadedMMaps[mapId];
@@ -209,9 +217,37 @@ namespace MMAP
         if (mmap->mmapLoadedTiles.find(packedGridPos) != mmap->mmapLoadedTiles.end())
         {
             sLog.outError("MMAP:loadMap: Asked to load already loaded navmesh tile. %03u%02i%02i.mmtile", mapId, x, y);
+            dtFree(data);
+            return false;
+        }
+
+        if (!data)
+        {
+            data = readTile(mapId, x, y, size);
+            if (!data)
+                return false;
+        }
+
+        dtMeshHeader* header = (dtMeshHeader*)data;
+        dtTileRef tileRef = 0;
+
+        // memory allocated for data is now managed by detour, and will be deallocated when the tile is removed
+        dtStatus dtResult = mmap->navMesh->addTile(data, size, DT_TILE_FREE_DATA, 0, &tileRef);
+        if (dtStatusFailed(dtResult))
+        {
+            sLog.outError("MMAP:loadMap: Could not load %03u%02i%02i.mmtile into navmesh", mapId, x, y);
+            dtFree(data);
             return false;
         }
 
+        mmap->mmapLoadedTiles.insert(std::pair<uint32, dtTileRef>(packedGridPos, tileRef));
+        ++loadedTiles;
+        DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:loadMap: Loaded mmtile %03i[%02i,%02i] into %03i[%02i,%02i]", mapId, x, y, mapId, header->x, header->y);
+        return true;
+    }
+
+    unsigned char* MMapManager::readTile(uint32 mapId, int32 x, int32 y, uint32& size)
+    {
         // load this tile :: mmaps/MMMXXYY.mmtile
         uint32 pathLen = sWorld.GetDataPath().length() + strlen("mmaps/%03i%02i%02i.mmtile") + 1;
         char* fileName = new char[pathLen];
@@ -222,7 +258,7 @@ namespace MMAP
         {
             DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "ERROR: MMAP:loadMap: Could not open mmtile file '%s'", fileName);
             delete[] fileName;
-            return false;
+            return nullptr;
         }
         delete[] fileName;
 
@@ -234,7 +270,7 @@ namespace MMAP
         {
             sLog.outError("MMAP:loadMap: Bad header in mmap %03u%02i%02i.mmtile", mapId, x, y);
             fclose(file);
-            return false;
+            return nullptr;
         }
 
         if (fileHeader.mmapVersion != MMAP_VERSION)
@@ -242,7 +278,7 @@ namespace MMAP
             sLog.outError("MMAP:loadMap: %03u%02i%02i.mmtile was built with generator v%i, expected v%i",
                           mapId, x, y, fileHeader.mmapVersion, MMAP_VERSION);
             fclose(file);
-            return false;
+            return nullptr;
         }
 
         unsigned char* data = (unsigned char*)dtAlloc(fileHeader.size, DT_ALLOC_PERM);
@@ -253,27 +289,14 @@ namespace MMAP
         {
             sLog.outError("MMAP:loadMap: Bad header or data in mmap %03u%02i%02i.mmtile", mapId, x, y);
             fclose(file);
-            return false;
+            dtFree(data);
+            return nullptr;
         }
 
         fclose(file);
 
-        dtMeshHeader* header = (dtMeshHeader*)data;
-        dtTileRef tileRef = 0;
-
-        // memory allocated for data is now managed by detour, and will be deallocated when the tile is removed
-        dtStatus dtResult = mmap->navMesh->addTile(data, fileHeader.size, DT_TILE_FREE_DATA, 0, &tileRef);
-        if (dtStatusFailed(dtResult))
-        {
-            sLog.outError("MMAP:loadMap: Could not load %03u%02i%02i.mmtile into navmesh", mapId, x, y);
-            dtFree(data);
-            return false;
-        }
-
-        mmap->mmapLoadedTiles.insert(std::pair<uint32, dtTileRef>(packedGridPos, tileRef));
-        ++loadedTiles;
-        DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:loadMap: Loaded mmtile %03i[%02i,%02i] into %03i[%02i,%02i]", mapId, x, y, mapId, header->x, header->y);
-        return true;
+        size = fileHeader.size;
+        return data;
     }
 
     void MMapManager::loadAllGameObjectModels(std::vector<uint32> const& displayIds)
@@ -425,32 +448,6 @@ namespace MMAP
         return true;
     }
 
-    bool MMapManager::unloadMapInstance(uint32 mapId, uint32 instanceId)
-    {
-        // check if we have this map loaded
-        if (loadedMMaps.find(mapId) == loadedMMaps.end())
-        {
-            // file may not exist, therefore not loaded
-            DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:unloadMapInstance: Asked to unload not loaded navmesh map %03u", mapId);
-            return false;
-        }
-
-        MMapData* mmap = loadedMMaps[mapId];
-        if (mmap->navMeshQueries.find(instanceId) == mmap->navMeshQueries.end())
-        {
-            DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:unloadMapInstance: Asked to unload not loaded dtNavMeshQuery mapId %03u instanceId %u", mapId, instanceId);
-            return false;
-        }
-
-        dtNavMeshQuery* query = mmap->navMeshQueries[instanceId];
-
-        dtFreeNavMeshQuery(query);
-        mmap->navMeshQueries.erase(instanceId);
-        DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:unloadMapInstance: Unloaded mapId %03u instanceId %u", mapId, instanceId);
-
-        return true;
-    }
-
     dtNavMesh const* MMapManager::GetNavMesh(uint32 mapId)
     {
         if (loadedMMaps.find(mapId) == loadedMMaps.end())
@@ -467,61 +464,107 @@ namespace MMAP
         return m_loadedModels[mapId]->navMesh;
     }
 
-    dtNavMeshQuery const* MMapManager::GetNavMeshQuery(uint32 mapId, uint32 instanceId)
+    dtNavMeshQuery const* MMapManager::GetNavMeshQuery(uint32 mapId)
     {
-        if (loadedMMaps.find(mapId) == loadedMMaps.end())
+        NavMeshQueryPool* pool = GetNavMeshQueryPool(mapId);
+        return pool ? pool->GetQuery() : nullptr;
+    }
+
+    dtNavMeshQuery const* MMapManager::GetModelNavMeshQuery(uint32 displayId)
+    {
+        NavMeshQueryPool* pool = GetModelNavMeshQueryPool(displayId);
+        return pool ? pool->GetQuery() : nullptr;
+    }
+
+    NavMeshQueryPool* MMapManager::GetNavMeshQueryPool(uint32 mapId)
+    {
+        auto itr = loadedMMaps.find(mapId);
+        if (itr == loadedMMaps.end())
             return nullptr;
 
-        MMapData* mmap = loadedMMaps[mapId];
-        if (mmap->navMeshQueries.find(instanceId) == mmap->navMeshQueries.end())
+        return &itr->second->navMeshQueries;
+    }
+
+    NavMeshQueryPool* MMapManager::GetModelNavMeshQueryPool(uint32 displayId)
+    {
+        auto itr = m_loadedModels.find(displayId);
+        if (itr == m_loadedModels.end())
+            return nullptr;
+
+        return &itr->second->navMeshGOQueries;
+    }
+
+    // ######################## NavMeshQueryPool ########################
+    namespace
+    {
+        struct ThreadNavMeshQuery
         {
-            // allocate mesh query
-            dtNavMeshQuery* query = dtAllocNavMeshQuery();
-            MANGOS_ASSERT(query);
-            dtStatus dtResult = query->init(mmap->navMesh, 1024);
-            if (dtStatusFailed(dtResult))
-            {
-                dtFreeNavMeshQuery(query);
-                sLog.outError("MMAP:GetNavMeshQuery: Failed to initialize dtNavMeshQuery for mapId %03u instanceId %u", mapId, instanceId);
-                return nullptr;
-            }
+            uint64 poolId;
+            dtNavMeshQuery const* query;
+        };
 
-            DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:GetNavMeshQuery: created dtNavMeshQuery for mapId %03u instanceId %u", mapId, instanceId);
-            mmap->navMeshQueries.insert(std::pair<uint32, dtNavMeshQuery*>(instanceId, query));
+        // per thread, indexed by NavMeshQueryPool slot
+        thread_local std::vector<ThreadNavMeshQuery> t_navMeshQueries;
+
+        std::mutex g_querySlotsMutex;
+        std::vector<uint32> g_freeQuerySlots;
+        uint32 g_querySlotCount = 0;
+        uint64 g_queryPoolCount = 0;
+    }
+
+    NavMeshQueryPool::NavMeshQueryPool(dtNavMesh const* navMesh, int maxNodes) : m_navMesh(navMesh), m_maxNodes(maxNodes)
+    {
+        std::lock_guard<std::mutex> guard(g_querySlotsMutex);
+        if (g_freeQuerySlots.empty())
+            m_slot = g_querySlotCount++;
+        else
+        {
+            m_slot = g_freeQuerySlots.back();
+            g_freeQuerySlots.pop_back();
         }
+        m_id = ++g_queryPoolCount;
+    }
+
+    NavMeshQueryPool::~NavMeshQueryPool()
+    {
+        for (dtNavMeshQuery* query : m_queries)
+            dtFreeNavMeshQuery(query);
 
-        return mmap->navMeshQueries[instanceId];
+        std::lock_guard<std::mutex> guard(g_querySlotsMutex);
+        g_freeQuerySlots.push_back(m_slot);
     }
 
-    dtNavMeshQuery const* MMapManager::GetModelNavMeshQuery(uint32 displayId)
+    dtNavMeshQuery const* NavMeshQueryPool::GetQuery()
+    {
+        if (m_slot < t_navMeshQueries.size() && t_navMeshQueries[m_slot].poolId == m_id)
+            return t_navMeshQueries[m_slot].query;
+
+        return CreateQuery();
+    }
+
+    dtNavMeshQuery const* NavMeshQueryPool::CreateQuery()
     {
-        if (m_loadedModels.find(displayId) == m_loadedModels.end())
+        dtNavMeshQuery* query = dtAllocNavMeshQuery();
+        MANGOS_ASSERT(query);
+        if (dtStatusFailed(query->init(m_navMesh, m_maxNodes)))
+        {
+            dtFreeNavMeshQuery(query);
+            sLog.outError("MMAP:NavMeshQueryPool: Failed to initialize dtNavMeshQuery");
             return nullptr;
+        }
 
-        auto threadId = std::this_thread::get_id();
-        MMapGOData* mmap = m_loadedModels[displayId];
-        if (mmap->navMeshGOQueries.find(threadId) == mmap->navMeshGOQueries.end())
+        uint32 threadCount;
         {
-            std::lock_guard<std::mutex> guard(m_modelsMutex);
-            if (mmap->navMeshGOQueries.find(threadId) == mmap->navMeshGOQueries.end())
-            {
-                // allocate mesh query
-                std::stringstream ss;
-                ss << threadId;
-                dtNavMeshQuery* query = dtAllocNavMeshQuery();
-                MANGOS_ASSERT(query);
-                if (dtStatusFailed(query->init(mmap->navMesh, 2048)))
-                {
-                    dtFreeNavMeshQuery(query);
-                    sLog.outError("MMAP:GetNavMeshQuery: Failed to initialize dtNavMeshQuery for displayid %03u tid %s", displayId, ss.str().data());
-                    return nullptr;
-                }
-
-                DETAIL_LOG("MMAP:GetNavMeshQuery: created dtNavMeshQuery for displayid %03u tid %s", displayId, ss.str().data());
-                mmap->navMeshGOQueries.insert(std::pair<std::thread::id, dtNavMeshQuery*>(threadId, query));
-            }
+            std::lock_guard<std::mutex> guard(m_mutex);
+            m_queries.push_back(query);
+            threadCount = m_queries.size();
         }
 
-        return mmap->navMeshGOQueries[threadId];
+        if (t_navMeshQueries.size() <= m_slot)
+            t_navMeshQueries.resize(m_slot + 1, { 0, nullptr });
+        t_navMeshQueries[m_slot] = { m_id, query };
+
+        DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:NavMeshQueryPool: created dtNavMeshQuery for pool " UI64FMTD ", %u threads", m_id, threadCount);
+        return query;
     }
 }
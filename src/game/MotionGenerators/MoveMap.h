@@ -24,6 +24,7 @@
 #include <Detour/Include/DetourNavMesh.h>
 #include <Detour/Include/DetourNavMeshQuery.h>
 #include <mutex>
+#include <vector>
 
 class Unit;
 
@@ -42,45 +43,60 @@ inline void dtCustomFree(void* ptr)
 namespace MMAP
 {
     typedef std::unordered_map<uint32, dtTileRef> MMapTileSet;
-    typedef std::unordered_map<uint32, dtNavMeshQuery*> NavMeshQuerySet;
-    typedef std::unordered_map<std::thread::id, dtNavMeshQuery*> NavMeshGOQuerySet;
+
+    // dtNavMeshQuery objects are not thread safe, so every thread gets its own query of a navmesh.
+    // A thread finds its query in a thread local slot array, the mutex is only taken to create one.
+    class NavMeshQueryPool
+    {
+        public:
+            NavMeshQueryPool(dtNavMesh const* navMesh, int maxNodes);
+            ~NavMeshQueryPool();
+
+            NavMeshQueryPool(NavMeshQueryPool const&) = delete;
+            NavMeshQueryPool& operator=(NavMeshQueryPool const&) = delete;
+
+            dtNavMeshQuery const* GetQuery();
+
+        private:
+            dtNavMeshQuery const* CreateQuery();
+
+            dtNavMesh const* m_navMesh;
+            int m_maxNodes;
+            uint32 m_slot;                      // index in the thread local arrays, reused by later pools
+            uint64 m_id;                        // never reused, tells stale thread local entries apart
+
+            std::mutex m_mutex;
+            std::vector<dtNavMeshQuery*> m_queries;
+    };
 
     // dummy struct to hold map's mmap data
     struct MMapData
     {
-        MMapData(dtNavMesh* mesh) : navMesh(mesh) {}
+        MMapData(dtNavMesh* mesh) : navMesh(mesh), navMeshQueries(mesh, 1024) {}
         ~MMapData()
         {
-            for (auto& navMeshQuerie : navMeshQueries)
-                dtFreeNavMeshQuery(navMeshQuerie.second);
-
             if (navMesh)
                 dtFreeNavMesh(navMesh);
         }
 
         dtNavMesh* navMesh;
 
-        // we have to use single dtNavMeshQuery for every instance, since those are not thread safe
-        NavMeshQuerySet navMeshQueries;     // instanceId to query
+        NavMeshQueryPool navMeshQueries;    // shared by all instances of the map
         MMapTileSet mmapLoadedTiles;        // maps [map grid coords] to [dtTile]
     };
 
     struct MMapGOData
     {
-        MMapGOData(dtNavMesh* mesh) : navMesh(mesh) {}
+        MMapGOData(dtNavMesh* mesh) : navMesh(mesh), navMeshGOQueries(mesh, 2048) {}
         ~MMapGOData()
         {
-            for (auto& navMeshQuerie : navMeshGOQueries)
-                dtFreeNavMeshQuery(navMeshQuerie.second);
-
             if (navMesh)
                 dtFreeNavMesh(navMesh);
         }
 
         dtNavMesh* navMesh;
 
-        // we have to use single dtNavMeshQuery for every instance, since those are not thread safe
-        NavMeshGOQuerySet navMeshGOQueries;  // instanceId to query
+        NavMeshQueryPool navMeshGOQueries;
     };
 
 
@@ -95,16 +111,22 @@ namespace MMAP
             ~MMapManager();
 
             bool loadMap(uint32 mapId, int32 x, int32 y);
+            // adds a tile read before by readTile, takes ownership of data
+            bool loadMap(uint32 mapId, int32 x, int32 y, unsigned char* data, uint32 size);
+            // only reads the tile file, safe to call from any thread, returns dtAlloc'ed data or nullptr
+            static unsigned char* readTile(uint32 mapId, int32 x, int32 y, uint32& size);
             void loadAllGameObjectModels(std::vector<uint32> const& displayIds);
             bool loadGameObject(uint32 displayId);
             bool unloadMap(uint32 mapId, int32 x, int32 y);
             bool unloadMap(uint32 mapId);
-            bool unloadMapInstance(uint32 mapId, uint32 instanceId);
             bool IsMMapIsLoaded(uint32 mapId, uint32 x, uint32 y) const;
 
-            // the returned [dtNavMeshQuery const*] is NOT threadsafe
-            dtNavMeshQuery const* GetNavMeshQuery(uint32 mapId, uint32 instanceId);
+            // the returned [dtNavMeshQuery const*] belongs to the calling thread, do not hand it to another one
+            dtNavMeshQuery const* GetNavMeshQuery(uint32 mapId);
             dtNavMeshQuery const* GetModelNavMeshQuery(uint32 displayId);
+            // pools live until the map's navmesh or the model is unloaded, callers may keep them that long
+            NavMeshQueryPool* GetNavMeshQueryPool(uint32 mapId);
+            NavMeshQueryPool* GetModelNavMeshQueryPool(uint32 displayId);
             dtNavMesh const* GetNavMesh(uint32 mapId);
             dtNavMesh const* GetGONavMesh(uint32 displayId);
 
@@ -118,7 +140,6 @@ namespace MMAP
             uint32 loadedTiles;
 
             std::unordered_map<uint32, MMapGOData*> m_loadedModels;
-            std::mutex m_modelsMutex;
     };
 
     // static class
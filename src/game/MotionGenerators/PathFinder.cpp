@@ -35,16 +35,10 @@
 PathFinder::PathFinder(const Unit* owner, bool ignoreNormalization) :
     m_polyLength(0), m_type(PATHFIND_BLANK),
     m_useStraightPath(false), m_forceDestination(false), m_straightLine(false), m_pointPathLimit(MAX_POINT_PATH_LENGTH), // TODO: Fix legitimate long paths
-    m_sourceUnit(owner), m_navMesh(nullptr), m_navMeshQuery(nullptr), m_cachedPoints(m_pointPathLimit * VERTEX_SIZE), m_pathPolyRefs(m_pointPathLimit), m_smoothPathPolyRefs(m_pointPathLimit), m_defaultMapId(m_sourceUnit->GetMapId()), m_ignoreNormalization(ignoreNormalization)
+    m_sourceUnit(owner), m_navMesh(nullptr), m_navMeshQuery(nullptr), m_cachedPoints(m_pointPathLimit * VERTEX_SIZE), m_pathPolyRefs(m_pointPathLimit), m_smoothPathPolyRefs(m_pointPathLimit), m_ignoreNormalization(ignoreNormalization)
 {
     DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ PathFinder::PathInfo for %u \n", m_sourceUnit->GetGUIDLow());
 
-    if (MMAP::MMapFactory::IsPathfindingEnabled(m_sourceUnit->GetMapId(), m_sourceUnit))
-    {
-        MMAP::MMapManager* mmap = MMAP::MMapFactory::createOrGetMMapManager();
-        m_defaultNavMeshQuery = mmap->GetNavMeshQuery(m_sourceUnit->GetMapId(), m_sourceUnit->GetInstanceId());
-    }
-
     createFilter();
 }
 
@@ -57,16 +51,14 @@ void PathFinder::SetCurrentNavMesh()
 {
     if (MMAP::MMapFactory::IsPathfindingEnabled(m_sourceUnit->GetMapId(), m_sourceUnit))
     {
-        MMAP::MMapManager* mmap = MMAP::MMapFactory::createOrGetMMapManager();
+        // queries are per thread, so fetch them on every path calculation
+        MMAP::NavMeshQueryPool* queryPool;
         if (GenericTransport* transport = m_sourceUnit->GetTransport())
-            m_navMeshQuery = mmap->GetModelNavMeshQuery(transport->GetDisplayId());
+            queryPool = transport->GetNavMeshQueryPool();
         else
-        {
-            if (m_defaultMapId != m_sourceUnit->GetMapId())
-                m_defaultNavMeshQuery = mmap->GetNavMeshQuery(m_sourceUnit->GetMapId(), m_sourceUnit->GetInstanceId());
+            queryPool = m_sourceUnit->GetMap()->GetTerrain()->GetNavMeshQueryPool();
 
-            m_navMeshQuery = m_defaultNavMeshQuery;
-        }
+        m_navMeshQuery = queryPool ? queryPool->GetQuery() : nullptr;
 
         if (m_navMeshQuery)
             m_navMesh = m_navMeshQuery->getAttachedNavMesh();
@@ -131,6 +123,29 @@ bool PathFinder::calculate(Vector3 const& start, Vector3 const& dest, bool force
     return true;
 }
 
+bool PathFinder::IsDirectlyWalkable(Vector3 const& start, Vector3 const& dest)
+{
+    SetCurrentNavMesh();
+    if (!m_navMesh || !m_navMeshQuery || !HaveTile(start) || !HaveTile(dest))
+        return false;
+
+    updateFilter();
+
+    float startPoint[VERTEX_SIZE] = {start.y, start.z, start.x};
+    float endPoint[VERTEX_SIZE] = {dest.y, dest.z, dest.x};
+    float distToStartPoly;
+    dtPolyRef startPoly = getPolyByLocation(startPoint, &distToStartPoly);
+    if (startPoly == INVALID_POLYREF)
+        return false;
+
+    float hit = 0.0f;
+    float hitNormal[VERTEX_SIZE] = {0.0f, 0.0f, 0.0f};
+    dtStatus dtResult = m_navMeshQuery->raycast(startPoly, startPoint, endPoint, &m_filter, &hit, hitNormal, nullptr, nullptr, 0);
+
+    // raycast() sets hit to FLT_MAX if there is a ray between start and end
+    return dtStatusSucceed(dtResult) && hit == FLT_MAX;
+}
+
 dtPolyRef PathFinder::getPathPolyByPosition(const dtPolyRef* polyPath, uint32 polyPathSize, const float* point, float* distance) const
 {
     if (!polyPath || !polyPathSize)
@@ -70,6 +70,8 @@ class PathFinder
         // return: true if new path was calculated, false otherwise (no change needed)
         bool calculate(float destX, float destY, float destZ, bool forceDest = false, bool straightLine = false); // transfers coorddinates from global to local space if on transport - use other func if coords are already in transport space
         bool calculate(Vector3 const& start, Vector3 const& dest, bool forceDest = false, bool straightLine = false);
+        // true if the owner can walk in a straight line from start to dest on the navmesh
+        bool IsDirectlyWalkable(Vector3 const& start, Vector3 const& dest);
 
         // option setters - use optional
         void setUseStrightPath(bool useStraightPath) { m_useStraightPath = useStraightPath; };
@@ -106,8 +108,6 @@ class PathFinder
         const dtNavMesh*        m_navMesh;          // the nav mesh
         const dtNavMeshQuery*   m_navMeshQuery;     // the nav mesh query used to find the path
 
-        const dtNavMeshQuery*   m_defaultNavMeshQuery;     // the nav mesh query used to find the path
-        uint32                  m_defaultMapId;
 
         bool                    m_ignoreNormalization;
 
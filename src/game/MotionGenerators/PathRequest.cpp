@@ -0,0 +1,117 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "MotionGenerators/PathRequest.h"
+#include "Entities/Unit.h"
+#include "World/World.h"
+
+#include <cmath>
+
+size_t PathCache::KeyHash::operator()(Key const& key) const
+{
+    size_t hash = key.entry * 31 + key.options;
+    for (int i = 0; i < 3; ++i)
+        hash = (hash * 1000003) ^ size_t(uint32(key.start[i])) ^ (size_t(uint32(key.end[i])) << 16);
+    return hash;
+}
+
+PathCache::Key PathCache::MakeKey(Unit const& owner, Vector3 const& start, Vector3 const& end, bool forceDest, bool ignoreNormalization, float pathLength)
+{
+    Key key;
+    memset(&key, 0, sizeof(Key));                           // compared bytewise
+    key.entry = owner.GetEntry();
+    key.options = (forceDest ? 0x1 : 0) | (ignoreNormalization ? 0x2 : 0) | (uint32(pathLength) << 2);
+    for (int i = 0; i < 3; ++i)
+    {
+        key.start[i] = int32(std::floor(start[i] / PATH_CACHE_CELL_SIZE));
+        key.end[i] = int32(std::floor(end[i] / PATH_CACHE_CELL_SIZE));
+    }
+    return key;
+}
+
+bool PathCache::Find(Unit const& owner, Key const& key, Vector3 const& start, Vector3 const& end, bool forceDest, PointsArray& path, PathType& type)
+{
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        ++m_lookups;
+
+        auto itr = m_paths.find(key);
+        if (itr == m_paths.end())
+            return false;
+
+        path = itr->second.path;
+        type = itr->second.type;
+    }
+
+    if (!path.empty())
+    {
+        // the cached path may begin up to a cell diagonal away from start, a wall may lie in between
+        if (path.size() > 1 && (type & PATHFIND_NORMAL) && !(type & PATHFIND_NOT_USING_PATH) &&
+                (path.front() - start).squaredLength() > 0.01f && !PathFinder(&owner).IsDirectlyWalkable(start, path[1]))
+            return false;
+
+        path.front() = start;
+        if (forceDest)
+            path.back() = end;
+    }
+
+    std::lock_guard<std::mutex> guard(m_mutex);
+    ++m_hits;
+    return true;
+}
+
+void PathCache::Insert(Key const& key, PointsArray const& path, PathType type)
+{
+    std::lock_guard<std::mutex> guard(m_mutex);
+    Entry& entry = m_paths[key];
+    entry.path = path;
+    entry.type = type;
+    entry.time = WorldTimer::getMSTime();
+}
+
+void PathCache::Update(uint32 now)
+{
+    std::lock_guard<std::mutex> guard(m_mutex);
+    for (auto itr = m_paths.begin(); itr != m_paths.end();)
+    {
+        if (WorldTimer::getMSTimeDiff(itr->second.time, now) >= PATH_CACHE_EXPIRE_TIME)
+            itr = m_paths.erase(itr);
+        else
+            ++itr;
+    }
+}
+
+void PathCache::TakeCounters(uint32& lookups, uint32& hits)
+{
+    std::lock_guard<std::mutex> guard(m_mutex);
+    lookups = m_lookups;
+    hits = m_hits;
+    m_lookups = 0;
+    m_hits = 0;
+}
+
+PathRequest::PathRequest(Unit const& owner, Vector3 const& start, Vector3 const& end, bool forceDest, float pathLength) :
+    ownerGuid(owner.GetObjectGuid()), owner(nullptr), key(PathCache::MakeKey(owner, start, end, forceDest, false, pathLength)),
+    start(start), end(end), forceDest(forceDest), pathLength(pathLength), ready(false), type(PATHFIND_BLANK), duration(0)
+{
+}
+
+bool PathRequest::CanQueue(Unit const& owner)
+{
+    return sWorld.getConfig(CONFIG_BOOL_PATH_FIND_ASYNC) && owner.IsInWorld() && !owner.GetTransport();
+}
@@ -0,0 +1,109 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_PATH_REQUEST_H
+#define MANGOS_PATH_REQUEST_H
+
+#include "Common.h"
+#include "Entities/ObjectGuid.h"
+#include "MotionGenerators/PathFinder.h"
+
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+class Unit;
+
+#define PATH_CACHE_CELL_SIZE    1.0f        // start and end points closer than this share cached paths
+#define PATH_CACHE_EXPIRE_TIME  30000       // ms a cached path is reused
+
+// Paths calculated before for near identical start and end points of creatures of the same entry.
+// Looked up from parallel object updates, so it is locked.
+class PathCache
+{
+    public:
+        struct Key
+        {
+            uint32 entry;
+            uint32 options;
+            int32 start[3];
+            int32 end[3];
+
+            bool operator==(Key const& other) const { return memcmp(this, &other, sizeof(Key)) == 0; }
+        };
+
+        struct KeyHash
+        {
+            size_t operator()(Key const& key) const;
+        };
+
+        PathCache() : m_lookups(0), m_hits(0) {}
+
+        static Key MakeKey(Unit const& owner, Vector3 const& start, Vector3 const& end, bool forceDest, bool ignoreNormalization, float pathLength);
+
+        // on a hit the path is adjusted to begin at start (and end at end with forceDest), a cached path whose
+        // first segment owner cannot walk from start counts as a miss
+        bool Find(Unit const& owner, Key const& key, Vector3 const& start, Vector3 const& end, bool forceDest, PointsArray& path, PathType& type);
+        void Insert(Key const& key, PointsArray const& path, PathType type);
+        void Update(uint32 now);
+
+        // counters since the last call
+        void TakeCounters(uint32& lookups, uint32& hits);
+
+    private:
+        struct Entry
+        {
+            PointsArray path;
+            PathType type;
+            uint32 time;
+        };
+
+        std::mutex m_mutex;
+        std::unordered_map<Key, Entry, KeyHash> m_paths;
+        uint32 m_lookups;
+        uint32 m_hits;
+};
+
+// A path calculated on a map worker after the map update, see Map::QueuePathRequest.
+// The movement generator holding the request picks the result up on a later tick.
+struct PathRequest
+{
+    PathRequest(Unit const& owner, Vector3 const& start, Vector3 const& end, bool forceDest, float pathLength = 0.0f);
+
+    // async requests are off on transports, their paths use the transport navmesh in local coords
+    static bool CanQueue(Unit const& owner);
+
+    bool IsReady() const { return ready; }
+
+    ObjectGuid ownerGuid;
+    Unit const* owner;                      // resolved by the map before the path stage, nullptr if gone
+    PathCache::Key key;
+    Vector3 start;
+    Vector3 end;
+    bool forceDest;
+    float pathLength;
+
+    bool ready;
+    PointsArray path;
+    PathType type;
+    uint32 duration;                        // us spent in the PathFinder, 0 if served from the cache
+};
+
+typedef std::shared_ptr<PathRequest> PathRequestPtr;
+
+#endif
@@ -66,6 +66,7 @@ void AbstractRandomMovementGenerator::Finalize(Unit& owner)
 
 void AbstractRandomMovementGenerator::Interrupt(Unit& owner)
 {
+    i_pathRequest.reset();
     owner.InterruptMoving();
 
     owner.clearUnitState(i_stateMotion);
@@ -73,6 +74,7 @@ void AbstractRandomMovementGenerator::Interrupt(Unit& owner)
 
 void AbstractRandomMovementGenerator::Reset(Unit& owner)
 {
+    i_pathRequest.reset();
     i_nextMoveTimer.Reset(0);
 
     Initialize(owner);
@@ -85,6 +87,7 @@ bool AbstractRandomMovementGenerator::Update(Unit& owner, const uint32& diff)
 
     if (owner.hasUnitState(UNIT_STAT_NO_FREE_MOVE & ~i_stateActive))
     {
+        i_pathRequest.reset();
         i_nextMoveTimer.Update(diff);
         owner.clearUnitState(i_stateMotion);
         return true;
@@ -92,28 +95,45 @@ bool AbstractRandomMovementGenerator::Update(Unit& owner, const uint32& diff)
 
     if (owner.movespline->Finalized())
     {
+        if (i_pathRequest)
+        {
+            if (i_pathRequest->IsReady())
+            {
+                PathRequestPtr request = std::move(i_pathRequest);
+                _onMoveLaunched(owner, _launchPath(owner, request->type, request->path));
+            }
+            return true;
+        }
+
         i_nextMoveTimer.Update(diff);
 
         if (i_nextMoveTimer.Passed())
         {
-            if (_setLocation(owner))
-            {
-                if (i_nextMoveCount > 1)
-                    --i_nextMoveCount;
-                else
-                {
-                    i_nextMoveCount = urand(1, i_nextMoveCountMax);
-                    i_nextMoveTimer.Reset(urand(i_nextMoveDelayMin, i_nextMoveDelayMax));
-                }
-            }
-            else
-                i_nextMoveTimer.Reset(owner.HasFlag(UNIT_FIELD_FLAGS, UNIT_FLAG_PLAYER_CONTROLLED) ? 100 : 500);
+            int32 duration = _setLocation(owner);
+            if (!i_pathRequest)
+                _onMoveLaunched(owner, duration);
         }
     }
 
     return true;
 }
 
+void AbstractRandomMovementGenerator::_onMoveLaunched(Unit& owner, int32 duration)
+{
+    if (duration)
+    {
+        if (i_nextMoveCount > 1)
+            --i_nextMoveCount;
+        else
+        {
+            i_nextMoveCount = urand(1, i_nextMoveCountMax);
+            i_nextMoveTimer.Reset(urand(i_nextMoveDelayMin, i_nextMoveDelayMax));
+        }
+    }
+    else
+        i_nextMoveTimer.Reset(owner.HasFlag(UNIT_FIELD_FLAGS, UNIT_FLAG_PLAYER_CONTROLLED) ? 100 : 500);
+}
+
 bool AbstractRandomMovementGenerator::_getLocation(Unit& owner, float& x, float& y, float& z)
 {
     return owner.GetMap()->GetReachableRandomPosition(&owner, x, y, z, i_radius);
@@ -127,6 +147,19 @@ int32 AbstractRandomMovementGenerator::_setLocation(Unit& owner)
     if (!_getLocation(owner, x, y, z))
         return 0;
 
+    if (PathRequest::CanQueue(owner))
+    {
+        i_pathRequest = std::make_shared<PathRequest>(owner, Vector3(owner.GetPositionX(), owner.GetPositionY(), owner.GetPositionZ()), Vector3(x, y, z), false, i_pathLength);
+        owner.GetMap()->QueuePathRequest(owner, i_pathRequest);
+        // answered from the path cache
+        if (i_pathRequest->IsReady())
+        {
+            PathRequestPtr request = std::move(i_pathRequest);
+            return _launchPath(owner, request->type, request->path);
+        }
+        return 0;
+    }
+
     PathFinder pf(&owner);
 
     if (i_pathLength != 0.0f)
@@ -134,11 +167,16 @@ int32 AbstractRandomMovementGenerator::_setLocation(Unit& owner)
 
     pf.calculate(x, y, z);
 
-    if (pf.getPathType() & PATHFIND_NOPATH)
+    return _launchPath(owner, pf.getPathType(), pf.getPath());
+}
+
+int32 AbstractRandomMovementGenerator::_launchPath(Unit& owner, PathType type, PointsArray& path)
+{
+    if (type & PATHFIND_NOPATH)
         return 0;
 
     Movement::MoveSplineInit init(owner);
-    init.MovebyPath(pf.getPath());
+    init.MovebyPath(path);
     init.SetWalk(i_walk);
 
     int32 duration = init.Launch();
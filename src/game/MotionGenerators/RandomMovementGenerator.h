@@ -20,6 +20,7 @@
 #define MANGOS_RANDOMMOTIONGENERATOR_H
 
 #include "MotionGenerators/MovementGenerator.h"
+#include "MotionGenerators/PathRequest.h"
 #include "Entities/ObjectGuid.h"
 
 class AbstractRandomMovementGenerator : public MovementGenerator
@@ -42,6 +43,8 @@ class AbstractRandomMovementGenerator : public MovementGenerator
     protected:
         virtual bool _getLocation(Unit& owner, float& x, float& y, float& z);
         virtual int32 _setLocation(Unit& owner);
+        int32 _launchPath(Unit& owner, PathType type, PointsArray& path);
+        void _onMoveLaunched(Unit& owner, int32 duration);
 
         float i_x, i_y, i_z;
         float i_radius;
@@ -52,6 +55,7 @@ class AbstractRandomMovementGenerator : public MovementGenerator
         uint32 i_nextMoveCount, i_nextMoveCountMax;
         uint32 i_nextMoveDelayMin, i_nextMoveDelayMax;
         uint32 i_stateActive, i_stateMotion;
+        PathRequestPtr i_pathRequest;           // queued by _setLocation, launched once the map calculated it
 };
 
 class ConfusedMovementGenerator : public AbstractRandomMovementGenerator
@@ -227,7 +227,7 @@ void WaypointMovementGenerator<Creature>::OnArrived(Creature& creature)
     m_scriptTime = 0;
 }
 
-// return added travel time - TODO: implement caching of path
+// return added travel time
 uint32 WaypointMovementGenerator<Creature>::BuildIntPath(PointsArray& path, Creature& creature, Vector3 const& endPos)
 {
     Vector3 startPos = path.back();
@@ -235,9 +235,19 @@ uint32 WaypointMovementGenerator<Creature>::BuildIntPath(PointsArray& path, Crea
     auto speedType = MovementInfo::GetSpeedType(creature.m_movementInfo.GetMovementFlags());
     float creatureSpeed = creature.GetSpeed(speedType);
 
-    PathFinder pathfinder(&creature, true);
-    pathfinder.calculate(startPos, endPos, true);
-    auto genPath = pathfinder.getPath();
+    // segments between two nodes are the same every round and for every creature of the entry on the path
+    PointsArray genPath;
+    PathType genPathType;
+    bool useCache = PathRequest::CanQueue(creature);
+    PathCache::Key key = PathCache::MakeKey(creature, startPos, endPos, true, true, 0.0f);
+    if (!useCache || !creature.GetMap()->GetPathCache().Find(creature, key, startPos, endPos, true, genPath, genPathType))
+    {
+        PathFinder pathfinder(&creature, true);
+        pathfinder.calculate(startPos, endPos, true);
+        genPath = pathfinder.getPath();
+        if (useCache)
+            creature.GetMap()->GetPathCache().Insert(key, genPath, pathfinder.getPathType());
+    }
 
     Vector3 firstPoint = startPos;
     bool first = true;
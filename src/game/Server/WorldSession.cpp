@@ -93,6 +93,11 @@ bool WorldSessionFilter::Process(WorldPacket const& packet) const
     return !MapSessionFilterHelper(m_pSession, opHandle);
 }
 
+// lock free part of the receive queues, a burst past this between two updates waits in the locked overflow list
+static size_t const RECV_QUEUE_SIZE = 256;
+static size_t const RECV_QUEUE_MAP_SIZE = 512;
+static size_t const RECV_PACKET_POOL_SIZE = 64;
+
 /// WorldSession constructor
 WorldSession::WorldSession(uint32 id, WorldSocket* sock, AccountTypes sec, uint8 expansion, time_t mute_time, LocaleConstant locale, std::string accountName, uint32 accountFlags, uint32 recruitingFriend, bool isARecruiter) :
     m_muteTime(mute_time), m_GUIDLow(0), _player(nullptr), m_Socket(sock ? sock->shared<WorldSocket>() : nullptr), _security(sec), _accountId(id), m_expansion(expansion), m_orderCounter(0),
@@ -101,7 +106,9 @@ WorldSession::WorldSession(uint32 id, WorldSocket* sock, AccountTypes sec, uint8
     m_sessionDbcLocale(sWorld.GetAvailableDbcLocale(locale)), m_sessionDbLocaleIndex(sObjectMgr.GetStorageLocaleIndexFor(locale)),
     m_latency(0), m_clientTimeDelay(0), m_tutorialState(TUTORIALDATA_UNCHANGED), m_sessionState(WORLD_SESSION_STATE_CREATED),
     m_timeSyncClockDeltaQueue(6), m_timeSyncClockDelta(0), m_pendingTimeSyncRequests(), m_timeSyncNextCounter(0), m_timeSyncTimer(0),
-    m_requestSocket(nullptr), m_recruitingFriendId(recruitingFriend), m_isRecruiter(isARecruiter) {}
+    m_requestSocket(nullptr), m_recruitingFriendId(recruitingFriend), m_isRecruiter(isARecruiter),
+    m_recvQueue(RECV_QUEUE_SIZE), m_recvQueueMap(RECV_QUEUE_MAP_SIZE), m_packetPool(RECV_PACKET_POOL_SIZE),
+    m_overflowedPackets(0), m_recvQueueMapPushed(0), m_dropMovementBefore(0), m_recvQueueMapPopped(0), m_deferPackets(false) {}
 
 /// WorldSession destructor
 WorldSession::~WorldSession()
@@ -119,6 +126,13 @@ WorldSession::~WorldSession()
 
         m_Socket->FinalizeSession();
     }
+
+    ///- free packets still waiting in the queues
+    while (PopPacket(m_recvQueue)) {}
+    while (PopPacket(m_recvQueueMap)) {}
+    WorldPacket* packet;
+    while (m_packetPool.Pop(packet))
+        delete packet;
 }
 
 void WorldSession::SetOffline()
@@ -161,7 +175,7 @@ void WorldSession::SetInCharSelection()
 
 bool WorldSession::RequestNewSocket(WorldSocket* socket)
 {
-    std::lock_guard<std::mutex> guard(m_recvQueueLock);
+    std::lock_guard<std::mutex> guard(m_requestSocketLock);
     if (m_requestSocket)
         return false;
 
@@ -215,6 +229,16 @@ void WorldSession::SendPacket(WorldPacket const& packet) const
     if (!m_Socket || m_Socket->IsClosed())
         return;
 
+    if (m_deferPackets)
+    {
+        std::lock_guard<std::mutex> guard(m_deferredPacketsLock);
+        if (m_deferPackets)
+        {
+            m_deferredPackets.push_back(packet);
+            return;
+        }
+    }
+
 #ifdef MANGOS_DEBUG
 
     // Code for network use statistic
@@ -254,6 +278,26 @@ void WorldSession::SendPacket(WorldPacket const& packet) const
     m_Socket->SendPacket(packet);
 }
 
+/// Push everything sent so far to the client without waiting for the socket flush timer
+void WorldSession::FlushPackets() const
+{
+    if (m_Socket && !m_Socket->IsClosed())
+        m_Socket->Flush();
+}
+
+/// Send the packets held back since DeferPackets(), the lock keeps packets from other threads behind them
+void WorldSession::SendDeferredPackets()
+{
+    std::lock_guard<std::mutex> guard(m_deferredPacketsLock);
+    m_deferPackets = false;
+
+    if (m_Socket && !m_Socket->IsClosed())
+        for (WorldPacket const& packet : m_deferredPackets)
+            m_Socket->SendPacket(packet);
+
+    m_deferredPackets.clear();
+}
+
 /// Add an incoming packet to the queue
 void WorldSession::QueuePacket(std::unique_ptr<WorldPacket> new_packet)
 {
@@ -269,34 +313,72 @@ void WorldSession::QueuePacket(std::unique_ptr<WorldPacket> new_packet)
 
     if (opHandle.packetProcessing == PROCESS_MAP_THREAD)
     {
-        std::lock_guard<std::mutex> guard(m_recvQueueMapLock);
-        m_recvQueueMap.push_back(std::move(new_packet));
+        // counted before it is queued, a DeleteMovementPackets() in between must already cover it
+        ++m_recvQueueMapPushed;
+        PushPacket(m_recvQueueMap, std::move(new_packet));
     }
     else
+        PushPacket(m_recvQueue, std::move(new_packet));
+}
+
+void WorldSession::PushPacket(ReceiveQueue& queue, std::unique_ptr<WorldPacket> packet)
+{
+    ++queue.size;
+    if (queue.overflowSize == 0 && queue.ring.Push(packet.get()))
     {
-        std::lock_guard<std::mutex> guard(m_recvQueueLock);
-        m_recvQueue.push_back(std::move(new_packet));
+        packet.release();
+        return;
     }
+
+    std::lock_guard<std::mutex> guard(queue.overflowLock);
+    if (queue.overflow.empty())
+        sLog.outError("WorldSession::QueuePacket: receive queue full for account %u at %s (0x%.4X), holding packets in the overflow list",
+                      GetAccountId(), packet->GetOpcodeName(), packet->GetOpcode());
+    queue.overflow.push_back(packet.release());
+    ++queue.overflowSize;
+    ++m_overflowedPackets;
 }
 
-void WorldSession::DeleteMovementPackets()
+std::unique_ptr<WorldPacket> WorldSession::AcquirePacket(uint16 opcode, size_t size)
 {
-    std::lock_guard<std::mutex> guard(m_recvQueueMapLock);
-    for (auto itr = m_recvQueueMap.begin(); itr != m_recvQueueMap.end();)
+    WorldPacket* packet;
+    if (!m_packetPool.Pop(packet))
+        return std::unique_ptr<WorldPacket>(new WorldPacket(Opcodes(opcode), size));
+
+    packet->Initialize(Opcodes(opcode), size);
+    packet->SetReceivedTime(std::chrono::steady_clock::time_point());
+    return std::unique_ptr<WorldPacket>(packet);
+}
+
+std::unique_ptr<WorldPacket> WorldSession::PopPacket(ReceiveQueue& queue)
+{
+    // the ring holds the older packets, the overflow list is only drained once the ring is empty
+    WorldPacket* packet;
+    if (!queue.ring.Pop(packet))
     {
-        switch ((*itr)->GetOpcode())
-        {
-            case MSG_MOVE_SET_FACING:
-            case MSG_MOVE_HEARTBEAT:
-            {
-                itr = m_recvQueueMap.erase(itr);
-                break;
-            }
-            default:
-                ++itr;
-                break;
-        }
+        if (queue.overflowSize == 0)
+            return nullptr;
+
+        std::lock_guard<std::mutex> guard(queue.overflowLock);
+        packet = queue.overflow.front();
+        queue.overflow.pop_front();
+        --queue.overflowSize;
     }
+
+    --queue.size;
+    return std::unique_ptr<WorldPacket>(packet);
+}
+
+void WorldSession::RecyclePacket(std::unique_ptr<WorldPacket> packet)
+{
+    if (m_packetPool.Push(packet.get()))
+        packet.release();
+}
+
+void WorldSession::DeleteMovementPackets()
+{
+    // queued packets can not be removed from the ring, mark them so the map thread skips stale movement instead
+    m_dropMovementBefore = m_recvQueueMapPushed.load();
 }
 
 /// Logging helper for unexpected opcodes
@@ -345,11 +427,8 @@ bool WorldSession::Update(uint32 diff)
 {
     GetMessager().Execute(this);
 
-    std::deque<std::unique_ptr<WorldPacket>> recvQueueCopy;
-    {
-        std::lock_guard<std::mutex> guard(m_recvQueueLock);
-        std::swap(recvQueueCopy, m_recvQueue);
-    }
+    // only handle what is queued now, packets arriving meanwhile wait for the next update
+    uint32 queued = m_recvQueue.size;
 
     if (m_Socket && !m_Socket->IsClosed() && m_anticheat)
     {
@@ -360,12 +439,13 @@ bool WorldSession::Update(uint32 diff)
 
     ///- Retrieve packets from the receive queue and call the appropriate handlers
     /// not process packets if socket already closed
-    while (m_Socket && !m_Socket->IsClosed() && !recvQueueCopy.empty())
+    while (m_Socket && !m_Socket->IsClosed() && queued-- > 0)
     {
         // sLog.outError("MOEP: %s (0x%.4X)", packet->GetOpcodeName(), packet->GetOpcode());
 
-        auto const packet = std::move(recvQueueCopy.front());
-        recvQueueCopy.pop_front();
+        std::unique_ptr<WorldPacket> packet = PopPacket(m_recvQueue);
+        if (!packet)
+            break;
 
         OpcodeHandler const& opHandle = opcodeTable[packet->GetOpcode()];
         try
@@ -442,6 +522,8 @@ bool WorldSession::Update(uint32 diff)
         {
             ProcessByteBufferException(*packet);
         }
+
+        RecyclePacket(std::move(packet));
     }
 
 #ifdef BUILD_PLAYERBOT
@@ -456,10 +538,8 @@ bool WorldSession::Update(uint32 diff)
         {
             Player* const botPlayer = itr->second;
             WorldSession* const pBotWorldSession = botPlayer->GetSession();
-            while(!pBotWorldSession->m_recvQueue.empty())
+            while (std::unique_ptr<WorldPacket> botpacket = pBotWorldSession->PopPacket(pBotWorldSession->m_recvQueue))
             {
-                auto const botpacket = std::move(pBotWorldSession->m_recvQueue.front());
-                pBotWorldSession->m_recvQueue.pop_front();
 
                 OpcodeHandler const& opHandle = opcodeTable[botpacket->GetOpcode()];
                 pBotWorldSession->ExecuteOpcode(opHandle, *botpacket);
@@ -552,19 +632,31 @@ bool WorldSession::Update(uint32 diff)
 
 void WorldSession::UpdateMap(uint32 diff)
 {
-    std::deque<std::unique_ptr<WorldPacket>> recvQueueMapCopy;
-    {
-        std::lock_guard<std::mutex> guard(m_recvQueueMapLock);
-        std::swap(recvQueueMapCopy, m_recvQueueMap);
-    }
+    // only handle what is queued now, packets arriving meanwhile wait for the next update
+    uint32 queued = m_recvQueueMap.size;
 
-    for (size_t i = 0; m_Socket && !m_Socket->IsClosed() && i < recvQueueMapCopy.size(); ++i)
+    while (m_Socket && !m_Socket->IsClosed() && queued-- > 0)
     {
-        auto const packet = std::move(recvQueueMapCopy.front());
-        recvQueueMapCopy.pop_front();
+        std::unique_ptr<WorldPacket> packet = PopPacket(m_recvQueueMap);
+        if (!packet)
+            break;
+
+        // movement sent before a teleport no longer applies
+        if (m_recvQueueMapPopped++ < m_dropMovementBefore)
+        {
+            switch (packet->GetOpcode())
+            {
+                case MSG_MOVE_SET_FACING:
+                case MSG_MOVE_HEARTBEAT:
+                    RecyclePacket(std::move(packet));
+                    continue;
+                default:
+                    break;
+            }
+        }
 
         OpcodeHandler const& opHandle = opcodeTable[packet->GetOpcode()];
-        
+
         try
         {
             if (opHandle.status == STATUS_LOGGEDIN)
@@ -576,6 +668,8 @@ void WorldSession::UpdateMap(uint32 diff)
         {
             ProcessByteBufferException(*packet);
         }
+
+        RecyclePacket(std::move(packet));
     }
 }
 
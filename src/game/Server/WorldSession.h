@@ -31,8 +31,10 @@
 #include "Entities/Item.h"
 #include "Server/WorldSocket.h"
 #include "Multithreading/Messager.h"
+#include "Multithreading/LockFreeQueue.h"
 #include "LFG/LFGDefines.h"
 
+#include <atomic>
 #include <deque>
 #include <mutex>
 #include <memory>
@@ -284,6 +286,9 @@ class WorldSession
         void SizeError(WorldPacket const& packet, uint32 size) const;
 
         void SendPacket(WorldPacket const& packet) const;
+        void FlushPackets() const;
+        void DeferPackets() { m_deferPackets = true; }
+        void SendDeferredPackets();
         void SendExpectedSpamRecords();
         void SendMotd();
         void SendOfflineNameQueryResponses();
@@ -364,9 +369,16 @@ class WorldSession
         void KickPlayer(bool save = false, bool inPlace = false); // inplace variable needed for shutdown
 
         void QueuePacket(std::unique_ptr<WorldPacket> new_packet);
+        // hands out a recycled packet when one is available, network thread side of the receive pool
+        std::unique_ptr<WorldPacket> AcquirePacket(uint16 opcode, size_t size);
 
         void DeleteMovementPackets();
 
+        // receive queue statistics, safe to read from any thread
+        uint32 GetRecvQueueDepth() const { return m_recvQueue.size; }
+        uint32 GetRecvQueueMapDepth() const { return m_recvQueueMap.size; }
+        uint32 GetOverflowedPacketCount() const { return m_overflowedPackets; }
+
         bool Update(uint32 diff);
         void UpdateMap(uint32 diff);
 
@@ -1099,11 +1111,38 @@ class WorldSession
         uint32 m_recruitingFriendId;
         bool m_isRecruiter;
 
+        // a lock free ring, and behind it a locked overflow list for bursts the ring can not hold.
+        // once a packet went to the overflow list all following ones do too until it is drained, so the order is kept
+        struct ReceiveQueue
+        {
+            explicit ReceiveQueue(size_t capacity) : ring(capacity), size(0), overflowSize(0) {}
+
+            LockFreeQueue<WorldPacket*> ring;
+            std::mutex overflowLock;
+            std::deque<WorldPacket*> overflow;
+            std::atomic<uint32> size;
+            std::atomic<uint32> overflowSize;
+        };
+
+        void PushPacket(ReceiveQueue& queue, std::unique_ptr<WorldPacket> packet);
+        std::unique_ptr<WorldPacket> PopPacket(ReceiveQueue& queue);
+        void RecyclePacket(std::unique_ptr<WorldPacket> packet);
+
         // Thread safety mechanisms
-        std::mutex m_recvQueueLock;
-        std::mutex m_recvQueueMapLock;
-        std::deque<std::unique_ptr<WorldPacket>> m_recvQueue;
-        std::deque<std::unique_ptr<WorldPacket>> m_recvQueueMap;
+        // receive queues are written by the network thread (and playerbot AI) and drained by the world/map thread
+        std::mutex m_requestSocketLock;
+        ReceiveQueue m_recvQueue;
+        ReceiveQueue m_recvQueueMap;
+        LockFreeQueue<WorldPacket*> m_packetPool;
+        std::atomic<uint32> m_overflowedPackets;
+        // DeleteMovementPackets() marks every map packet pushed so far, the map thread skips stale movement below the mark
+        std::atomic<uint64> m_recvQueueMapPushed;
+        std::atomic<uint64> m_dropMovementBefore;
+        uint64 m_recvQueueMapPopped;
+        // between Map::SendObjectUpdates and the client update stage directly sent packets wait behind the update blocks
+        mutable std::mutex m_deferredPacketsLock;
+        mutable std::vector<WorldPacket> m_deferredPackets;
+        std::atomic<bool> m_deferPackets;
 
         Messager<WorldSession> m_messager;
 
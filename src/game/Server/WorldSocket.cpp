@@ -229,7 +229,8 @@ bool WorldSocket::ProcessIncomingData()
     if (IsClosed())
         return false;
 
-    std::unique_ptr<WorldPacket> pct(new WorldPacket(opcode, validBytesRemaining));
+    // reuse a packet the session already processed when possible
+    std::unique_ptr<WorldPacket> pct = m_session ? m_session->AcquirePacket(opcode, validBytesRemaining) : std::unique_ptr<WorldPacket>(new WorldPacket(opcode, validBytesRemaining));
 
     if (validBytesRemaining)
     {
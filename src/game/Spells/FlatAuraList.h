@@ -0,0 +1,124 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_FLATAURALIST_H
+#define MANGOS_FLATAURALIST_H
+
+#include "Common.h"
+
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+class Aura;
+
+/**
+ * Contiguous list of the auras of one aura type on a unit.
+ *
+ * Iterators are an index into the list, so they stay valid when auras are added or removed while
+ * the list is walked, like std::list iterators did. Removal only clears the slot and iteration skips
+ * cleared slots; the owner calls Compact() at a point where no iteration can be in progress.
+ */
+class FlatAuraList
+{
+    public:
+        class const_iterator
+        {
+            public:
+                typedef std::bidirectional_iterator_tag iterator_category;
+                typedef Aura* value_type;
+                typedef std::ptrdiff_t difference_type;
+                typedef Aura* const* pointer;
+                typedef Aura* const& reference;
+
+                const_iterator() : m_list(nullptr), m_index(0) {}
+                const_iterator(FlatAuraList const* list, size_t index) : m_list(list), m_index(index) { SkipHoles(); }
+
+                reference operator*() const { return m_list->m_slots[m_index]; }
+                pointer operator->() const { return &m_list->m_slots[m_index]; }
+
+                const_iterator& operator++() { ++m_index; SkipHoles(); return *this; }
+                const_iterator operator++(int) { const_iterator tmp(*this); ++*this; return tmp; }
+                const_iterator& operator--() { do --m_index; while (!m_list->m_slots[m_index]); return *this; }
+                const_iterator operator--(int) { const_iterator tmp(*this); --*this; return tmp; }
+
+                bool operator==(const_iterator const& other) const { return m_index == other.m_index; }
+                bool operator!=(const_iterator const& other) const { return m_index != other.m_index; }
+
+            private:
+                friend class FlatAuraList;
+
+                void SkipHoles()
+                {
+                    while (m_index < m_list->m_slots.size() && !m_list->m_slots[m_index])
+                        ++m_index;
+                }
+
+                FlatAuraList const* m_list;
+                size_t m_index;
+        };
+        typedef const_iterator iterator;                    // auras are only changed through the list
+        typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+        typedef const_reverse_iterator reverse_iterator;
+
+        FlatAuraList() : m_holes(0) {}
+
+        const_iterator begin() const { return const_iterator(this, 0); }
+        const_iterator end() const { return const_iterator(this, m_slots.size()); }
+        const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+        const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+        bool empty() const { return m_slots.size() == m_holes; }
+        size_t size() const { return m_slots.size() - m_holes; }
+
+        Aura* front() const { return *begin(); }
+        Aura* back() const { return *rbegin(); }
+
+        void push_back(Aura* aura) { m_slots.push_back(aura); }
+
+        // both return true if the list had no holes before, so the owner knows to schedule a Compact()
+        bool remove(Aura* aura)
+        {
+            auto itr = std::find(m_slots.begin(), m_slots.end(), aura);
+            if (itr == m_slots.end())
+                return false;
+
+            *itr = nullptr;
+            return ++m_holes == 1;
+        }
+        bool erase(const_iterator itr)
+        {
+            m_slots[itr.m_index] = nullptr;
+            return ++m_holes == 1;
+        }
+
+        void Compact()
+        {
+            if (!m_holes)
+                return;
+
+            m_slots.erase(std::remove(m_slots.begin(), m_slots.end(), nullptr), m_slots.end());
+            m_holes = 0;
+        }
+
+    private:
+        std::vector<Aura*> m_slots;
+        size_t m_holes;
+};
+
+#endif
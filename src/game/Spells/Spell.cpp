@@ -736,13 +736,15 @@ bool Spell::FillUnitTargets(TempTargetingData& targetingData, SpellTargetingData
         SpellTargetImplicitType type = SpellTargetInfoTable[target].type;
         if (!unitTargetList.empty()) // Unit case
         {
+            // the cheap checks first, line of sight is then asked in one batch for the targets passing them
             for (auto itr = unitTargetList.begin(); itr != unitTargetList.end();)
             {
-                if (!CheckTarget(*itr, SpellEffectIndex(i), bool(rightTarget), CheckException(targetingData.magnet)))
+                if (!CheckTarget(*itr, SpellEffectIndex(i), bool(rightTarget), CheckException(targetingData.magnet), true))
                     itr = unitTargetList.erase(itr);
                 else
                     ++itr;
             }
+            CheckTargetsLineOfSight(unitTargetList, SpellEffectIndex(i), bool(rightTarget), CheckException(targetingData.magnet));
 
             // Special target filter before adding targets to list
             FilterTargetMap(unitTargetList, scheme, targetingData.chainTargetCount[i]);
@@ -782,6 +784,95 @@ bool Spell::FillUnitTargets(TempTargetingData& targetingData, SpellTargetingData
     return true;
 }
 
+/**
+ * Does the normal line of sight check of CheckTarget for a whole target list in one batched map query
+ * and removes the targets out of sight. The targets must have passed CheckTarget with losChecked set.
+ */
+void Spell::CheckTargetsLineOfSight(UnitList& targets, SpellEffectIndex eff, bool targetB, CheckException exception) const
+{
+    if (targets.empty())
+        return;
+
+    SpellTargetInfo const& info = SpellTargetInfoTable[targetB ? m_spellInfo->EffectImplicitTargetB[eff] : m_spellInfo->EffectImplicitTargetA[eff]];
+    if (info.type == TARGET_TYPE_UNIT && info.filter == TARGET_SCRIPT)
+        return;
+
+    // these effects do their own check in CheckTarget
+    switch (m_spellInfo->Effect[eff])
+    {
+        case SPELL_EFFECT_SUMMON_PLAYER:
+        case SPELL_EFFECT_RESURRECT_NEW:
+            return;
+        default:
+            break;
+    }
+
+    if (exception == EXCEPTION_MAGNET || IsIgnoreLosSpellEffect(m_spellInfo, eff))
+        return;
+
+    WorldObject const* losObject = nullptr;
+    float x, y, z;
+    switch (info.los)
+    {
+        case TARGET_LOS_DEST:
+            m_targets.getDestination(x, y, z);
+            break;
+        case TARGET_LOS_SRC:
+            m_targets.getSource(x, y, z);
+            break;
+        case TARGET_LOS_CASTER:
+            if (m_spellInfo->EffectImplicitTargetA[eff] == TARGET_LOCATION_DYNOBJ_POSITION)
+                losObject = m_caster->GetDynObject(m_triggeredByAuraSpell ? m_triggeredByAuraSpell->Id : m_spellInfo->Id);
+            else
+                losObject = GetCastingObject();
+            if (!losObject)
+                return;
+            losObject->GetPosition(x, y, z);
+            z += losObject->GetCollisionHeight();
+            break;
+        default:
+            return;
+    }
+
+    std::vector<VMAP::LineOfSightQuery> queries;
+    std::vector<Unit*> queried;
+    queries.reserve(targets.size());
+    queried.reserve(targets.size());
+    std::set<Unit*> blocked;
+    for (Unit* target : targets)
+    {
+        float height = target->GetCollisionHeight();
+        if (losObject)
+        {
+            if (target == m_trueCaster)
+                continue;
+            if (!target->IsInMap(losObject))
+            {
+                blocked.insert(target);
+                continue;
+            }
+        }
+
+        VMAP::LineOfSightQuery query;
+        target->GetPosition(query.x1, query.y1, query.z1);
+        query.z1 += height;
+        query.x2 = x;
+        query.y2 = y;
+        query.z2 = losObject ? z : z + height;
+        query.phaseMask = target->GetPhaseMask();
+        queries.push_back(query);
+        queried.push_back(target);
+    }
+
+    m_trueCaster->GetMap()->IsInLineOfSight(queries.data(), queries.size(), true);
+    for (uint32 i = 0; i < queries.size(); ++i)
+        if (!queries[i].result)
+            blocked.insert(queried[i]);
+
+    if (!blocked.empty())
+        targets.remove_if([&blocked](Unit* target) { return blocked.find(target) != blocked.end(); });
+}
+
 void Spell::prepareDataForTriggerSystem()
 {
     //==========================================================================================
@@ -7937,7 +8028,7 @@ CurrentSpellTypes Spell::GetCurrentContainer() const
     return (CURRENT_GENERIC_SPELL);
 }
 
-bool Spell::CheckTarget(Unit* target, SpellEffectIndex eff, bool targetB, CheckException exception) const
+bool Spell::CheckTarget(Unit* target, SpellEffectIndex eff, bool targetB, CheckException exception, bool losChecked) const
 {
     // Check targets for creature type mask and remove not appropriate (skip explicit self target case, maybe need other explicit targets)
     if (exception != EXCEPTION_MAGNET && m_spellInfo->EffectImplicitTargetA[eff] != TARGET_UNIT_CASTER)
@@ -8017,7 +8108,7 @@ bool Spell::CheckTarget(Unit* target, SpellEffectIndex eff, bool targetB, CheckE
                 // all ok by some way or another, skip normal check
                 break;
             default:                                            // normal case
-                if (exception != EXCEPTION_MAGNET && !IsIgnoreLosSpellEffect(m_spellInfo, eff))
+                if (!losChecked && exception != EXCEPTION_MAGNET && !IsIgnoreLosSpellEffect(m_spellInfo, eff))
                 {
                     float x, y, z;
                     switch (info.los)
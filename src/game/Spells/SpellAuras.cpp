@@ -10270,6 +10270,8 @@ SpellAuraHolder::SpellAuraHolder(SpellEntry const* spellproto, Unit* target, Wor
     m_trackedAuraType = sSpellMgr.IsSingleTargetSpell(spellproto) ? TRACK_AURA_TYPE_SINGLE_TARGET : IsSpellHaveAura(spellproto, SPELL_AURA_CONTROL_VEHICLE) ? TRACK_AURA_TYPE_CONTROL_VEHICLE : TRACK_AURA_TYPE_NOT_TRACKED;
     m_procCharges    = spellproto->procCharges;
 
+    UpdateProcEventFlags();
+
     m_isRemovedOnShapeLost = IsRemovedOnShapeshiftLost(m_spellProto, GetCasterGuid(), target->GetObjectGuid());
 
     Unit* unitCaster = caster && caster->isType(TYPEMASK_UNIT) ? (Unit*)caster : nullptr;
@@ -10317,6 +10319,12 @@ SpellAuraHolder::SpellAuraHolder(SpellEntry const* spellproto, Unit* target, Wor
     OnHolderInit(caster);
 }
 
+void SpellAuraHolder::UpdateProcEventFlags()
+{
+    SpellProcEventEntry const* spellProcEvent = sSpellMgr.GetSpellProcEvent(m_spellProto->Id);
+    m_procEventFlags = spellProcEvent && spellProcEvent->procFlags ? spellProcEvent->procFlags : m_spellProto->procFlags;
+}
+
 void SpellAuraHolder::AddAura(Aura* aura, SpellEffectIndex index)
 {
     m_auras[index] = aura;
@@ -203,6 +203,9 @@ class SpellAuraHolder
 
         void SetCreationDelayFlag();
 
+        uint32 GetProcEventFlags() const { return m_procEventFlags; }
+        void UpdateProcEventFlags();
+
         bool IsReducedProcChancePast60() { return m_reducedProcChancePast60; }
         void SetReducedProcChancePast60() { m_reducedProcChancePast60 = true; }
 
@@ -229,6 +232,7 @@ class SpellAuraHolder
         uint8 m_auraFlags;                                  // Aura info flag (for send data to client)
         uint8 m_auraLevel;                                  // Aura level (store caster level for correct show level dep amount)
         uint32 m_procCharges;                               // Aura charges (0 for infinite)
+        uint32 m_procEventFlags;                            // procFlags of spell_proc_event or else of the spell
         uint32 m_stackAmount;                               // Aura stack amount
         int32 m_maxDuration;                                // Max aura duration
         int32 m_duration;                                   // Current time
@@ -536,6 +536,13 @@ void Unit::ProcDamageAndSpellFor(ProcSystemArguments& argData, bool isVictim)
 {
     ProcExecutionData execData(argData, isVictim);
 
+    if (m_holderProcGeneration != sSpellMgr.GetSpellProcEventGeneration())
+        RebuildHolderProcSummary();
+
+    // no holder can proc on these flags or be removed by the damage, skip the scan
+    if (!(m_holderProcFlags & execData.procFlags) && !(isVictim && m_damageInterruptedHolders && (execData.procFlags & PROC_FLAG_TAKE_ANY_DAMAGE)))
+        return;
+
     ProcTriggeredList procTriggered;
     std::vector<SpellAuraHolder*> removedHolders;
     // Fill procTriggered list
@@ -27,8 +27,16 @@
 
 #include <vector>
 #include <algorithm>
+#include <cmath>
+
+// traverse the tree with packets of 4 rays sharing one node stack, see BIH::intersectRays
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BIH_RAY_PACKETS
+#include <emmintrin.h>
+#endif
 
 #define MAX_STACK_SIZE 64
+#define RAY_PACKET_SIZE 4
 
 using G3D::Vector3;
 using G3D::AABox;
@@ -259,6 +267,28 @@ class BIH
             }
         }
 
+        /**
+        Intersect count rays with the tree at once. maxDist and hits hold one entry per ray, hits[i] is set
+        when the callback reported a hit for ray i and maxDist[i] is shortened like in intersectRay.
+        Rays that start close to each other (one caster against a list of targets) share most of the visited nodes,
+        so they are walked together in packets and the node planes are tested against the whole packet.
+        */
+        template<typename RayCallback>
+        void intersectRays(const Ray* rays, uint32 count, RayCallback& intersectCallback, float* maxDist, bool* hits, bool stopAtFirst = false, bool ignoreM2Model = false) const
+        {
+#ifdef BIH_RAY_PACKETS
+            for (uint32 i = 0; i < count; i += RAY_PACKET_SIZE)
+                intersectRayPacket(rays + i, std::min(count - i, uint32(RAY_PACKET_SIZE)), intersectCallback, maxDist + i, hits + i, stopAtFirst, ignoreM2Model);
+#else
+            for (uint32 i = 0; i < count; ++i)
+            {
+                RayHitRecorder<RayCallback> recorder(intersectCallback);
+                intersectRay(rays[i], recorder, maxDist[i], stopAtFirst, ignoreM2Model);
+                hits[i] = recorder.hit;
+            }
+#endif
+        }
+
         template<typename IsectCallback>
         void intersectPoint(const Vector3& p, IsectCallback& intersectCallback) const
         {
@@ -390,6 +420,202 @@ class BIH
                 void printStats();
         };
 
+        template<typename RayCallback>
+        struct RayHitRecorder
+        {
+            RayHitRecorder(RayCallback& callback) : callback(callback), hit(false) {}
+            bool operator()(const Ray& r, uint32 entry, float& distance, bool stopAtFirst, bool ignoreM2Model)
+            {
+                bool result = callback(r, entry, distance, stopAtFirst, ignoreM2Model);
+                hit |= result;
+                return result;
+            }
+
+            RayCallback& callback;
+            bool hit;
+        };
+
+#ifdef BIH_RAY_PACKETS
+        struct PacketStackNode
+        {
+            __m128 tnear;
+            __m128 tfar;
+            uint32 node;
+            int lanes;
+        };
+
+        static __m128 packetSelect(__m128 mask, __m128 a, __m128 b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+
+        // same walk as intersectRay, but every lane keeps its own [tnear, tfar] interval and a node is entered
+        // as long as one lane of the packet overlaps it
+        template<typename RayCallback>
+        void intersectRayPacket(const Ray* rays, uint32 count, RayCallback& intersectCallback, float* maxDist, bool* hits, bool stopAtFirst, bool ignoreM2Model) const
+        {
+            alignas(16) float org[3][RAY_PACKET_SIZE];
+            alignas(16) float invDir[3][RAY_PACKET_SIZE];
+            alignas(16) float dist[RAY_PACKET_SIZE];
+            for (uint32 i = 0; i < RAY_PACKET_SIZE; ++i)
+            {
+                Vector3 const& o = rays[i < count ? i : 0].origin();
+                Vector3 const& d = rays[i < count ? i : 0].direction();
+                for (int axis = 0; axis < 3; ++axis)
+                {
+                    org[axis][i] = o[axis];
+                    // keep parallel axes finite, an infinite inverse gives NaN for origins on a split plane
+                    invDir[axis][i] = std::fabs(d[axis]) > 1e-30f ? 1.f / d[axis] : (std::signbit(d[axis]) ? -1e30f : 1e30f);
+                }
+                dist[i] = i < count ? maxDist[i] : 0.f;
+                if (i < count)
+                    hits[i] = false;
+            }
+
+            __m128 o[3], inv[3], neg[3];
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                o[axis] = _mm_load_ps(org[axis]);
+                inv[axis] = _mm_load_ps(invDir[axis]);
+                neg[axis] = _mm_cmplt_ps(inv[axis], _mm_setzero_ps());
+            }
+
+            // clip to the tree bounds
+            __m128 intervalMin = _mm_setzero_ps();
+            __m128 intervalMax = _mm_load_ps(dist);
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                __m128 t1 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(bounds.low()[axis]), o[axis]), inv[axis]);
+                __m128 t2 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(bounds.high()[axis]), o[axis]), inv[axis]);
+                intervalMin = _mm_max_ps(intervalMin, _mm_min_ps(t1, t2));
+                intervalMax = _mm_min_ps(intervalMax, _mm_max_ps(t1, t2));
+            }
+
+            int const usedLanes = (1 << count) - 1;
+            int finished = 0;                               // lanes that stopped at their first hit
+            int lanes = _mm_movemask_ps(_mm_cmple_ps(intervalMin, intervalMax)) & usedLanes;
+            if (!lanes)
+                return;
+
+            PacketStackNode stack[MAX_STACK_SIZE];
+            int stackPos = 0;
+            int node = 0;
+
+            while (true)
+            {
+                while (true)
+                {
+                    uint32 tn = tree[node];
+                    uint32 axis = (tn & (3 << 30)) >> 30;
+                    const bool BVH2 = (tn & (1 << 29)) != 0;
+                    int offset = tn & ~(7 << 29);
+                    if (!BVH2)
+                    {
+                        if (axis < 3)
+                        {
+                            // "normal" interior node, left child lies below the first plane, right child above the second
+                            __m128 tl = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(intBitsToFloat(tree[node + 1])), o[axis]), inv[axis]);
+                            __m128 tr = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(intBitsToFloat(tree[node + 2])), o[axis]), inv[axis]);
+                            __m128 leftMin = packetSelect(neg[axis], _mm_max_ps(intervalMin, tl), intervalMin);
+                            __m128 leftMax = packetSelect(neg[axis], intervalMax, _mm_min_ps(intervalMax, tl));
+                            __m128 rightMin = packetSelect(neg[axis], intervalMin, _mm_max_ps(intervalMin, tr));
+                            __m128 rightMax = packetSelect(neg[axis], _mm_min_ps(intervalMax, tr), intervalMax);
+                            int leftLanes = _mm_movemask_ps(_mm_cmple_ps(leftMin, leftMax)) & lanes;
+                            int rightLanes = _mm_movemask_ps(_mm_cmple_ps(rightMin, rightMax)) & lanes;
+                            // packet passes between clip zones
+                            if (!leftLanes && !rightLanes)
+                                break;
+                            // packet passes through one node only
+                            if (!rightLanes || !leftLanes)
+                            {
+                                bool left = leftLanes != 0;
+                                node = left ? offset : offset + 3;
+                                intervalMin = left ? leftMin : rightMin;
+                                intervalMax = left ? leftMax : rightMax;
+                                lanes = left ? leftLanes : rightLanes;
+                                continue;
+                            }
+                            // packet passes through both nodes, visit the near one of the first lane first
+                            int firstLane = lanes & -lanes;
+                            bool leftFirst = !(_mm_movemask_ps(neg[axis]) & firstLane);
+                            stack[stackPos].node = leftFirst ? offset + 3 : offset;
+                            stack[stackPos].tnear = leftFirst ? rightMin : leftMin;
+                            stack[stackPos].tfar = leftFirst ? rightMax : leftMax;
+                            stack[stackPos].lanes = leftFirst ? rightLanes : leftLanes;
+                            ++stackPos;
+                            node = leftFirst ? offset : offset + 3;
+                            intervalMin = leftFirst ? leftMin : rightMin;
+                            intervalMax = leftFirst ? leftMax : rightMax;
+                            lanes = leftFirst ? leftLanes : rightLanes;
+                        }
+                        else
+                        {
+                            // leaf - test some objects against every lane that reached it
+                            int n = tree[node + 1];
+                            while (n > 0)
+                            {
+                                for (uint32 i = 0; i < count; ++i)
+                                {
+                                    if (!(lanes & (1 << i)))
+                                        continue;
+                                    if (intersectCallback(rays[i], objects[offset], dist[i], stopAtFirst, ignoreM2Model))
+                                    {
+                                        hits[i] = true;
+                                        if (stopAtFirst)
+                                        {
+                                            lanes &= ~(1 << i);
+                                            finished |= 1 << i;
+                                        }
+                                    }
+                                }
+                                --n;
+                                ++offset;
+                            }
+                            break;
+                        }
+                    }
+                    else
+                    {
+                        if (axis > 2)
+                            break; // should not happen
+                        // BVH2 node, the child lies between both planes
+                        __m128 tl = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(intBitsToFloat(tree[node + 1])), o[axis]), inv[axis]);
+                        __m128 tr = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(intBitsToFloat(tree[node + 2])), o[axis]), inv[axis]);
+                        node = offset;
+                        intervalMin = _mm_max_ps(intervalMin, packetSelect(neg[axis], tr, tl));
+                        intervalMax = _mm_min_ps(intervalMax, packetSelect(neg[axis], tl, tr));
+                        lanes &= _mm_movemask_ps(_mm_cmple_ps(intervalMin, intervalMax));
+                        if (!lanes)
+                            break;
+                    }
+                } // traversal loop
+
+                if (finished == usedLanes)
+                    break;
+                do
+                {
+                    // stack is empty?
+                    if (stackPos == 0)
+                    {
+                        lanes = 0;
+                        break;
+                    }
+                    // move back up the stack, dropping lanes that already hit something closer
+                    --stackPos;
+                    lanes = stack[stackPos].lanes & ~finished & _mm_movemask_ps(_mm_cmple_ps(stack[stackPos].tnear, _mm_load_ps(dist)));
+                    if (!lanes)
+                        continue;
+                    node = stack[stackPos].node;
+                    intervalMin = stack[stackPos].tnear;
+                    intervalMax = stack[stackPos].tfar;
+                    break;
+                } while (true);
+                if (!lanes)
+                    break;
+            }
+
+            for (uint32 i = 0; i < count; ++i)
+                maxDist[i] = dist[i];
+        }
+#endif
+
         void buildHierarchy(std::vector<uint32>& tempTree, buildData& dat, BuildStats& stats);
 
         void createNode(std::vector<uint32>& tempTree, int nodeIndex, uint32 left, uint32 right) const
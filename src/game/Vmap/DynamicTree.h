@@ -27,6 +27,10 @@ namespace G3D
     class Ray;
 }
 class GameObjectModel;
+namespace VMAP
+{
+    struct LineOfSightQuery;
+}
 
 class DynamicMapTree
 {
@@ -35,6 +39,8 @@ class DynamicMapTree
         ~DynamicMapTree();
 
         bool isInLineOfSight(float x1, float y1, float z1, float x2, float y2, float z2, uint32 phasemask, bool ignoreM2Model) const;
+        // clears the result of queries blocked by a game object, queries that are already blocked are skipped
+        void isInLineOfSight(VMAP::LineOfSightQuery* queries, uint32 count, bool ignoreM2Model) const;
         bool getIntersectionTime(uint32 phasemask, const G3D::Ray& ray, const G3D::Vector3& endPos, float& pMaxDist) const;
         bool getObjectHitPos(uint32 phasemask, const G3D::Vector3& pPos1, const G3D::Vector3& pPos2, G3D::Vector3& pResultHitPos, float pModifyDist) const;
         bool getObjectHitPos(uint32 phasemask, float x1, float y1, float z1, float x2, float y2, float z2, float& rx, float& ry, float& rz, float pModifyDist) const;
@@ -164,6 +164,54 @@ namespace VMAP
         return !getIntersectionTime(ray, maxDist, true, ignoreM2Model);
     }
     //=========================================================
+
+    void StaticMapTree::isInLineOfSight(Vector3 const* pos1, Vector3 const* pos2, bool* results, uint32 count, bool ignoreM2Model) const
+    {
+        G3D::Ray rays[RAY_BATCH_SIZE];
+        float dists[RAY_BATCH_SIZE];
+        bool hits[RAY_BATCH_SIZE];
+        uint32 index[RAY_BATCH_SIZE];
+        uint32 chunk[RAY_BATCH_SIZE];
+        uint8 octant[RAY_BATCH_SIZE];
+        MapRayCallback intersectionCallBack(iTreeValues);
+        uint32 i = 0;
+        while (i < count)
+        {
+            uint32 n = 0;
+            uint32 octantStart[9] = {};
+            for (; i < count && n < RAY_BATCH_SIZE; ++i)
+            {
+                results[i] = true;
+                Vector3 dir = pos2[i] - pos1[i];
+                if (dir.magnitude() < 1e-10f)
+                    continue;
+                chunk[n] = i;
+                octant[n] = (dir.x < 0.f ? 1 : 0) | (dir.y < 0.f ? 2 : 0) | (dir.z < 0.f ? 4 : 0);
+                ++octantStart[octant[n] + 1];
+                ++n;
+            }
+
+            // packets walk the tree near to far for their first ray only, so rays going the same way
+            // (e.g. a caster's targets on one side) are packed together
+            for (uint32 o = 1; o < 9; ++o)
+                octantStart[o] += octantStart[o - 1];
+            for (uint32 k = 0; k < n; ++k)
+                index[octantStart[octant[k]]++] = chunk[k];
+
+            for (uint32 k = 0; k < n; ++k)
+            {
+                uint32 q = index[k];
+                float maxDist = (pos2[q] - pos1[q]).magnitude();
+                MANGOS_ASSERT(maxDist < std::numeric_limits<float>::max());
+                rays[k] = G3D::Ray::fromOriginAndDirection(pos1[q], (pos2[q] - pos1[q]) / maxDist);
+                dists[k] = maxDist;
+            }
+            iTree.intersectRays(rays, n, intersectionCallBack, dists, hits, true, ignoreM2Model);
+            for (uint32 k = 0; k < n; ++k)
+                results[index[k]] = !hits[k];
+        }
+    }
+    //=========================================================
     /**
     When moving from pos1 to pos2 check if we hit an object. Return true and the position if we hit one
     Return the hit pos or the original dest pos
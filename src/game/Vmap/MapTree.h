@@ -39,6 +39,9 @@ namespace VMAP
 
     class StaticMapTree
     {
+            // rays handed to the BIH per batched call, the callers' lists are split into chunks of this size
+            static uint32 const RAY_BATCH_SIZE = 8 * RAY_PACKET_SIZE;
+
             typedef std::unordered_map<uint32, bool> loadedTileMap;
             typedef std::unordered_map<uint32, int32> loadedSpawnMap;
         private:
@@ -71,6 +74,8 @@ namespace VMAP
             bool isInLineOfSight(const G3D::Vector3& pos1, const G3D::Vector3& pos2, bool ignoreM2Model) const;
             bool getObjectHitPos(const G3D::Vector3& pPos1, const G3D::Vector3& pPos2, G3D::Vector3& pResultHitPos, float pModifyDist) const;
             float getHeight(const G3D::Vector3& pPos, float maxSearchDist) const;
+            // batched version, one result per position pair
+            void isInLineOfSight(const G3D::Vector3* pos1, const G3D::Vector3* pos2, bool* results, uint32 count, bool ignoreM2Model) const;
             bool getAreaInfo(G3D::Vector3& pos, uint32& flags, int32& adtId, int32& rootId, int32& groupId) const;
             bool GetLocationInfo(Vector3 const& pos, LocationInfo& info) const;
 
@@ -19,6 +19,8 @@
 #include <iomanip>
 #include <string>
 #include <sstream>
+#include <memory>
+#include <vector>
 #include "VMapManager2.h"
 #include "MapTree.h"
 #include "ModelInstance.h"
@@ -172,6 +174,29 @@ namespace VMAP
         return result;
     }
     //=========================================================
+
+    void VMapManager2::isInLineOfSight(unsigned int pMapId, LineOfSightQuery* queries, uint32 count, bool ignoreM2Model)
+    {
+        for (uint32 i = 0; i < count; ++i)
+            queries[i].result = true;
+        if (!isLineOfSightCalcEnabled())
+            return;
+        InstanceTreeMap::iterator instanceTree = iInstanceMapTrees.find(pMapId);
+        if (instanceTree == iInstanceMapTrees.end())
+            return;
+
+        std::vector<Vector3> pos1(count), pos2(count);
+        std::unique_ptr<bool[]> results(new bool[count]);
+        for (uint32 i = 0; i < count; ++i)
+        {
+            pos1[i] = convertPositionToInternalRep(queries[i].x1, queries[i].y1, queries[i].z1);
+            pos2[i] = convertPositionToInternalRep(queries[i].x2, queries[i].y2, queries[i].z2);
+        }
+        instanceTree->second->isInLineOfSight(pos1.data(), pos2.data(), results.get(), count, ignoreM2Model);
+        for (uint32 i = 0; i < count; ++i)
+            queries[i].result = results[i];
+    }
+    //=========================================================
     /**
     get the hit position and return true if we hit something
     otherwise the result pos will be the dest pos
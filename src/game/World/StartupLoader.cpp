@@ -0,0 +1,167 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "World/StartupLoader.h"
+#include "Database/DatabaseEnv.h"
+#include "Log.h"
+#include "Timer.h"
+
+#include <thread>
+
+StartupLoader::StepId StartupLoader::AddStep(char const* name, StepFunc const& func, std::initializer_list<StepId> dependencies)
+{
+    StepId id = m_steps.size();
+
+    Step step;
+    step.name = name;
+    step.func = func;
+    step.dependencies.assign(dependencies.begin(), dependencies.end());
+    step.waitingFor = step.dependencies.size();
+    step.startTime = 0;
+    step.duration = 0;
+
+    for (StepId dependency : step.dependencies)
+    {
+        MANGOS_ASSERT(dependency < id);                     // keeps the graph acyclic and the add order a valid serial order
+        m_steps[dependency].dependents.push_back(id);
+    }
+
+    m_steps.push_back(step);
+    return id;
+}
+
+void StartupLoader::RunStep(Step& step)
+{
+    sLog.outString("Loading %s...", step.name);
+
+    step.startTime = WorldTimer::getMSTime();
+    step.func();
+    step.duration = WorldTimer::getMSTimeDiff(step.startTime, WorldTimer::getMSTime());
+}
+
+void StartupLoader::Run(uint32 threads)
+{
+    uint32 startTime = WorldTimer::getMSTime();
+
+    if (threads > m_steps.size())
+        threads = m_steps.size();
+
+    if (threads <= 1)
+    {
+        for (Step& step : m_steps)
+            RunStep(step);
+    }
+    else
+    {
+        m_pending = m_steps.size();
+        for (StepId id = 0; id < m_steps.size(); ++id)
+            if (!m_steps[id].waitingFor)
+                m_ready.insert(id);
+
+        std::vector<std::thread> workers;
+        workers.reserve(threads);
+        for (uint32 i = 0; i < threads; ++i)
+            workers.emplace_back(&StartupLoader::WorkerThread, this, int(i));
+
+        for (auto& worker : workers)
+            worker.join();
+    }
+
+    PrintReport(WorldTimer::getMSTimeDiff(startTime, WorldTimer::getMSTime()), threads);
+}
+
+void StartupLoader::WorkerThread(int connectionIndex)
+{
+    WorldDatabase.ThreadStart();
+    Database::SetThreadQueryConnection(connectionIndex);
+
+    std::unique_lock<std::mutex> guard(m_lock);
+    while (m_pending)
+    {
+        if (m_ready.empty())
+        {
+            m_cond.wait(guard);
+            continue;
+        }
+
+        StepId id = *m_ready.begin();
+        m_ready.erase(m_ready.begin());
+
+        guard.unlock();
+        RunStep(m_steps[id]);
+        guard.lock();
+
+        --m_pending;
+        for (StepId dependent : m_steps[id].dependents)
+            if (!--m_steps[dependent].waitingFor)
+                m_ready.insert(dependent);
+
+        m_cond.notify_all();
+    }
+
+    Database::SetThreadQueryConnection(-1);
+    WorldDatabase.ThreadEnd();
+}
+
+void StartupLoader::PrintReport(uint32 wallTime, uint32 threads) const
+{
+    // longest chain of dependent steps ending at each step, by measured durations
+    std::vector<uint32> pathTime(m_steps.size());
+    std::vector<StepId> pathPrev(m_steps.size());
+    StepId last = 0;
+    uint32 totalTime = 0;
+
+    for (StepId id = 0; id < m_steps.size(); ++id)
+    {
+        Step const& step = m_steps[id];
+        pathPrev[id] = id;
+        uint32 before = 0;
+        for (StepId dependency : step.dependencies)
+        {
+            if (pathTime[dependency] >= before)
+            {
+                before = pathTime[dependency];
+                pathPrev[id] = dependency;
+            }
+        }
+
+        pathTime[id] = before + step.duration;
+        totalTime += step.duration;
+        if (pathTime[id] > pathTime[last])
+            last = id;
+    }
+
+    sLog.outString();
+    sLog.outString(">> %s: %u steps loaded in %u ms with %u thread(s), %u ms sequential, critical path %u ms:",
+                   m_name, uint32(m_steps.size()), wallTime, threads, totalTime, m_steps.empty() ? 0 : pathTime[last]);
+
+    if (m_steps.empty())
+        return;
+
+    std::vector<StepId> path;
+    for (StepId id = last;; id = pathPrev[id])
+    {
+        path.push_back(id);
+        if (pathPrev[id] == id)
+            break;
+    }
+
+    for (auto itr = path.rbegin(); itr != path.rend(); ++itr)
+        sLog.outString(">>     %6u ms  %s", m_steps[*itr].duration, m_steps[*itr].name);
+    sLog.outString();
+}
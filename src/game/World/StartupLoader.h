@@ -0,0 +1,76 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_STARTUPLOADER_H
+#define MANGOS_STARTUPLOADER_H
+
+#include "Common.h"
+
+#include <condition_variable>
+#include <functional>
+#include <initializer_list>
+#include <mutex>
+#include <set>
+#include <vector>
+
+/**
+ * Runs startup load steps as a dependency graph on a set of threads.
+ * A step may only depend on steps added before it, so the add order is always a valid serial order
+ * and one thread runs the steps exactly like the old sequential code.
+ * Each worker thread uses its own database query connection. After Run() a timing report with the
+ * critical path (the chain of dependent steps that bounds the total load time) is written to the log.
+ */
+class StartupLoader
+{
+    public:
+        typedef uint32 StepId;
+        typedef std::function<void()> StepFunc;
+
+        explicit StartupLoader(char const* name) : m_name(name), m_pending(0) {}
+
+        StepId AddStep(char const* name, StepFunc const& func, std::initializer_list<StepId> dependencies = {});
+
+        // blocks until all steps are done
+        void Run(uint32 threads);
+
+    private:
+        struct Step
+        {
+            char const* name;
+            StepFunc func;
+            std::vector<StepId> dependencies;
+            std::vector<StepId> dependents;
+            uint32 waitingFor;                              // unfinished dependencies
+            uint32 startTime;
+            uint32 duration;
+        };
+
+        void WorkerThread(int connectionIndex);
+        void RunStep(Step& step);
+        void PrintReport(uint32 wallTime, uint32 threads) const;
+
+        char const* m_name;
+        std::vector<Step> m_steps;
+
+        std::mutex m_lock;
+        std::condition_variable m_cond;
+        std::set<StepId> m_ready;                           // steps with all dependencies done, run in add order
+        uint32 m_pending;                                   // steps not finished yet
+};
+
+#endif
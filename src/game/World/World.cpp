@@ -44,6 +44,7 @@
 #include "Mails/MassMailMgr.h"
 #include "Loot/LootMgr.h"
 #include "Entities/ItemEnchantmentMgr.h"
+#include "Entities/UpdateData.h"
 #include "Maps/MapManager.h"
 #include "DBScripts/ScriptMgr.h"
 #include "AI/ScriptDevAI/ScriptDevAIMgr.h"
@@ -56,6 +57,8 @@
 #include "GameEvents/GameEventMgr.h"
 #include "Pools/PoolManager.h"
 #include "Database/DatabaseImpl.h"
+#include "Database/SQLStorageSnapshot.h"
+#include "World/StartupLoader.h"
 #include "Grids/GridNotifiersImpl.h"
 #include "Grids/CellImpl.h"
 #include "Maps/MapPersistentStateMgr.h"
@@ -480,6 +483,7 @@ void World::LoadConfigSettings(bool reload)
 
     ///- Read other configuration items from the config file
     setConfigMinMax(CONFIG_UINT32_COMPRESSION, "Compression", 1, 1, 9);
+    UpdateData::SetCompressionLevel(int(getConfig(CONFIG_UINT32_COMPRESSION)));
     setConfig(CONFIG_BOOL_ADDON_CHANNEL, "AddonChannel", true);
     setConfig(CONFIG_BOOL_CLEAN_CHARACTER_DB, "CleanCharacterDB", true);
     setConfig(CONFIG_BOOL_GRID_UNLOAD, "GridUnload", true);
@@ -505,9 +509,33 @@ void World::LoadConfigSettings(bool reload)
     if (reload)
         sMapMgr.SetGridCleanUpDelay(getConfig(CONFIG_UINT32_INTERVAL_GRIDCLEAN));
 
+    setConfig(CONFIG_UINT32_GRID_PREFETCH_LOOKAHEAD, "GridPrefetch.Lookahead", 10);
+
     setConfigMin(CONFIG_UINT32_INTERVAL_MAPUPDATE, "MapUpdateInterval", 100, MIN_MAP_UPDATE_DELAY);
     if (reload)
         sMapMgr.SetMapUpdateInterval(getConfig(CONFIG_UINT32_INTERVAL_MAPUPDATE));
+    setConfig(CONFIG_UINT32_INTERVAL_MAPUPDATE_IDLE, "MapUpdateInterval.Idle", 0);
+
+    m_configMapUpdateIntervals.clear();
+    for (std::string const& entry : StrSplit(sConfig.GetStringDefault("MapUpdateInterval.Maps"), ","))
+    {
+        Tokens mapInterval = StrSplit(entry, ":");
+        if (mapInterval.size() != 2)
+        {
+            sLog.outError("MapUpdateInterval.Maps: entry '%s' is not in the form mapId:interval, skipped.", entry.c_str());
+            continue;
+        }
+
+        uint32 mapId = uint32(atoi(mapInterval[0].c_str()));
+        uint32 interval = uint32(atoi(mapInterval[1].c_str()));
+        if (interval < MIN_MAP_UPDATE_DELAY)
+        {
+            sLog.outError("MapUpdateInterval.Maps: interval %u of map %u is lower than %u, skipped.", interval, mapId, MIN_MAP_UPDATE_DELAY);
+            continue;
+        }
+
+        m_configMapUpdateIntervals[mapId] = interval;
+    }
 
     setConfig(CONFIG_UINT32_INTERVAL_CHANGEWEATHER, "ChangeWeatherInterval", 10 * MINUTE * IN_MILLISECONDS);
 
@@ -628,6 +656,7 @@ void World::LoadConfigSettings(bool reload)
     }
 
     setConfig(CONFIG_UINT32_NUM_MAP_THREADS, "MapUpdate.Threads", 3);
+    setConfig(CONFIG_UINT32_STARTUP_LOAD_THREADS, "StartupLoad.Threads", 1);
     setConfig(CONFIG_UINT32_SKILL_CHANCE_ORANGE, "SkillChance.Orange", 100);
     setConfig(CONFIG_UINT32_SKILL_CHANCE_YELLOW, "SkillChance.Yellow", 75);
     setConfig(CONFIG_UINT32_SKILL_CHANCE_GREEN,  "SkillChance.Green",  25);
@@ -863,6 +892,18 @@ void World::LoadConfigSettings(bool reload)
         sLog.outString("Using DataDir %s", m_dataPath.c_str());
     }
 
+    std::string snapshotPath = sConfig.GetStringDefault("StorageSnapshotDir", "");
+    // normalize dir path to path/ or path\ form, empty string disables the snapshots
+    if (!snapshotPath.empty() && snapshotPath.at(snapshotPath.length() - 1) != '/' && snapshotPath.at(snapshotPath.length() - 1) != '\\')
+        snapshotPath.append("/");
+
+    if (!reload)
+    {
+        SQLStorageSnapshot::SetDirectory(snapshotPath);
+        if (!snapshotPath.empty())
+            sLog.outString("Using StorageSnapshotDir %s", snapshotPath.c_str());
+    }
+
     setConfig(CONFIG_BOOL_VMAP_INDOOR_CHECK, "vmap.enableIndoorCheck", true);
     bool enableLOS = sConfig.GetBoolDefault("vmap.enableLOS", false);
     bool enableHeight = sConfig.GetBoolDefault("vmap.enableHeight", false);
@@ -876,6 +917,8 @@ void World::LoadConfigSettings(bool reload)
                    enableLOS, enableHeight, getConfig(CONFIG_BOOL_VMAP_INDOOR_CHECK) ? 1 : 0);
     sLog.outString("WORLD: VMap data directory is: %svmaps", m_dataPath.c_str());
 
+    setConfig(CONFIG_BOOL_MAP_FILES_MEMORY_MAPPED, "map.memoryMapped", true);
+
     setConfig(CONFIG_BOOL_MMAP_ENABLED, "mmap.enabled", true);
     std::string ignoreMapIds = sConfig.GetStringDefault("mmap.ignoreMapIds");
     MMAP::MMapFactory::preventPathfindingOnMaps(ignoreMapIds.c_str());
@@ -883,6 +926,7 @@ void World::LoadConfigSettings(bool reload)
 
     setConfig(CONFIG_BOOL_PATH_FIND_OPTIMIZE, "PathFinder.OptimizePath", true);
     setConfig(CONFIG_BOOL_PATH_FIND_NORMALIZE_Z, "PathFinder.NormalizeZ", false);
+    setConfig(CONFIG_BOOL_PATH_FIND_ASYNC, "PathFinder.Async", true);
 
     setConfig(CONFIG_UINT32_MAX_RECRUIT_A_FRIEND_BONUS_PLAYER_LEVEL, "Raf.BonusLevel", 60);
     setConfig(CONFIG_UINT32_MAX_RECRUIT_A_FRIEND_BONUS_PLAYER_LEVEL_DIFFERENCE, "Raf.LevelDifference", 4);
@@ -994,106 +1038,52 @@ void World::SetInitialWorldSettings()
     sObjectMgr.SetHighestGuids();                           // must be after PackInstances() and PackGroupIds()
     sLog.outString();
 
-    sLog.outString("Loading Page Texts...");
-    sObjectMgr.LoadPageTexts();
-
-    sLog.outString("Loading Game Object Templates...");     // must be after LoadPageTexts
-    std::vector<uint32> transportDisplayIds = sObjectMgr.LoadGameobjectInfo();
-    MMAP::MMapFactory::createOrGetMMapManager()->loadAllGameObjectModels(transportDisplayIds);
-
-    sLog.outString("Loading GameObject models...");
-    LoadGameObjectModelList();
-    sLog.outString();
-
-    // loads GO data
-    sTransportMgr.LoadTransportAnimationAndRotation();
-
-    sLog.outString("Loading Spell Chain Data...");
-    sSpellMgr.LoadSpellChains();
-
-    sLog.outString("Checking Spell Cone Data...");
-    sObjectMgr.CheckSpellCones();
-
-    sLog.outString("Loading Spell Elixir types...");
-    sSpellMgr.LoadSpellElixirs();
-
-    sLog.outString("Loading Spell Learn Skills...");
-    sSpellMgr.LoadSpellLearnSkills();                       // must be after LoadSpellChains
-
-    sLog.outString("Loading Spell Learn Spells...");
-    sSpellMgr.LoadSpellLearnSpells();
-
-    sLog.outString("Loading Spell Proc Event conditions...");
-    sSpellMgr.LoadSpellProcEvents();
-
-    sLog.outString("Loading Spell Bonus Data...");
-    sSpellMgr.LoadSpellBonuses();                           // must be after LoadSpellChains
-
-    sLog.outString("Loading Spell Proc Item Enchant...");
-    sSpellMgr.LoadSpellProcItemEnchant();                   // must be after LoadSpellChains
-
-    sLog.outString("Loading Aggro Spells Definitions...");
-    sSpellMgr.LoadSpellThreats();
-
-    sLog.outString("Loading NPC Texts...");
-    sObjectMgr.LoadGossipText();
-
-    sLog.outString("Loading Item Random Enchantments Table...");
-    LoadRandomEnchantmentsTable();
-
-    sLog.outString("Loading Item Templates...");            // must be after LoadRandomEnchantmentsTable and LoadPageTexts
-    sObjectMgr.LoadItemPrototypes();
-
-    sLog.outString("Loading Item converts...");             // must be after LoadItemPrototypes
-    sObjectMgr.LoadItemConverts();
-
-    sLog.outString("Loading Item expire converts...");      // must be after LoadItemPrototypes
-    sObjectMgr.LoadItemExpireConverts();
-
-    sLog.outString("Loading Creature Model Based Info Data...");
-    sObjectMgr.LoadCreatureModelInfo();
-
-    sLog.outString("Loading Equipment templates...");
-    sObjectMgr.LoadEquipmentTemplates();
-
-    sLog.outString("Loading Creature Stats...");
-    sObjectMgr.LoadCreatureClassLvlStats();
-
-    sLog.outString("Loading Creature templates...");
-    sObjectMgr.LoadCreatureTemplates();
-
-    sLog.outString("Loading Creature immunities...");
-    sObjectMgr.LoadCreatureImmunities();
-
-    sLog.outString("Loading Creature spell lists...");
-    sObjectMgr.LoadCreatureSpellLists();
-
-    sLog.outString("Loading Creature cooldowns...");
-    sObjectMgr.LoadCreatureCooldowns();
-
-    sLog.outString("Loading Creature template spells...");
-    sObjectMgr.LoadCreatureTemplateSpells();
-
-    sLog.outString("Loading Creature Model for race...");   // must be after creature templates
-    sObjectMgr.LoadCreatureModelRace();
-
-    sLog.outString("Loading Vehicle Accessory...");         // must be after LoadCreatureTemplates
-    sObjectMgr.LoadVehicleAccessory();
-
-    sLog.outString("Loading ItemRequiredTarget...");
-    sObjectMgr.LoadItemRequiredTarget();
-
-    sLog.outString("Loading Reputation Reward Rates...");
-    sObjectMgr.LoadReputationRewardRate();
-
-    sLog.outString("Loading Creature Reputation OnKill Data...");
-    sObjectMgr.LoadReputationOnKill();
-
-    sLog.outString("Loading Reputation Spillover Data...");
-    sObjectMgr.LoadReputationSpilloverTemplate();
-
-    sLog.outString("Loading Points Of Interest Data...");
-    sObjectMgr.LoadPointsOfInterest();
+    ///- Load the independent template tables in parallel, dependencies are the "must be after" constraints
+    StartupLoader templateLoader("Template tables");
+    StartupLoader::StepId pageTexts = templateLoader.AddStep("Page Texts", [] { sObjectMgr.LoadPageTexts(); });
+    StartupLoader::StepId goTemplates = templateLoader.AddStep("Game Object Templates", []
+    {
+        std::vector<uint32> transportDisplayIds = sObjectMgr.LoadGameobjectInfo();
+        MMAP::MMapFactory::createOrGetMMapManager()->loadAllGameObjectModels(transportDisplayIds);
+    }, { pageTexts });
+    templateLoader.AddStep("GameObject models", [] { LoadGameObjectModelList(); }, { goTemplates });
+    templateLoader.AddStep("Transport Animations", [] { sTransportMgr.LoadTransportAnimationAndRotation(); }, { goTemplates });
+
+    StartupLoader::StepId spellChains = templateLoader.AddStep("Spell Chain Data", [] { sSpellMgr.LoadSpellChains(); });
+    templateLoader.AddStep("Spell Cone Data", [] { sObjectMgr.CheckSpellCones(); }, { spellChains });
+    templateLoader.AddStep("Spell Elixir types", [] { sSpellMgr.LoadSpellElixirs(); });
+    templateLoader.AddStep("Spell Learn Skills", [] { sSpellMgr.LoadSpellLearnSkills(); }, { spellChains });
+    templateLoader.AddStep("Spell Learn Spells", [] { sSpellMgr.LoadSpellLearnSpells(); });
+    templateLoader.AddStep("Spell Proc Event conditions", [] { sSpellMgr.LoadSpellProcEvents(); }, { spellChains });
+    templateLoader.AddStep("Spell Bonus Data", [] { sSpellMgr.LoadSpellBonuses(); }, { spellChains });
+    templateLoader.AddStep("Spell Proc Item Enchant", [] { sSpellMgr.LoadSpellProcItemEnchant(); }, { spellChains });
+    templateLoader.AddStep("Aggro Spells Definitions", [] { sSpellMgr.LoadSpellThreats(); }, { spellChains });
+
+    templateLoader.AddStep("NPC Texts", [] { sObjectMgr.LoadGossipText(); });
+
+    StartupLoader::StepId randomEnchants = templateLoader.AddStep("Item Random Enchantments Table", [] { LoadRandomEnchantmentsTable(); });
+    StartupLoader::StepId items = templateLoader.AddStep("Item Templates", [] { sObjectMgr.LoadItemPrototypes(); }, { randomEnchants, pageTexts });
+    templateLoader.AddStep("Item converts", [] { sObjectMgr.LoadItemConverts(); }, { items });
+    templateLoader.AddStep("Item expire converts", [] { sObjectMgr.LoadItemExpireConverts(); }, { items });
+
+    StartupLoader::StepId modelInfo = templateLoader.AddStep("Creature Model Based Info Data", [] { sObjectMgr.LoadCreatureModelInfo(); });
+    StartupLoader::StepId equipment = templateLoader.AddStep("Equipment templates", [] { sObjectMgr.LoadEquipmentTemplates(); });
+    StartupLoader::StepId classLvlStats = templateLoader.AddStep("Creature Stats", [] { sObjectMgr.LoadCreatureClassLvlStats(); });
+    StartupLoader::StepId creatures = templateLoader.AddStep("Creature templates", [] { sObjectMgr.LoadCreatureTemplates(); }, { modelInfo, equipment, classLvlStats });
+    templateLoader.AddStep("Creature immunities", [] { sObjectMgr.LoadCreatureImmunities(); }, { creatures });
+    templateLoader.AddStep("Creature spell lists", [] { sObjectMgr.LoadCreatureSpellLists(); }, { creatures });
+    StartupLoader::StepId cooldowns = templateLoader.AddStep("Creature cooldowns", [] { sObjectMgr.LoadCreatureCooldowns(); }, { creatures });
+    templateLoader.AddStep("Creature template spells", [] { sObjectMgr.LoadCreatureTemplateSpells(); }, { creatures, cooldowns });
+    templateLoader.AddStep("Creature Model for race", [] { sObjectMgr.LoadCreatureModelRace(); }, { creatures });
+    templateLoader.AddStep("Vehicle Accessory", [] { sObjectMgr.LoadVehicleAccessory(); }, { creatures });
+    templateLoader.AddStep("ItemRequiredTarget", [] { sObjectMgr.LoadItemRequiredTarget(); }, { items, creatures });
+
+    templateLoader.AddStep("Reputation Reward Rates", [] { sObjectMgr.LoadReputationRewardRate(); });
+    templateLoader.AddStep("Creature Reputation OnKill Data", [] { sObjectMgr.LoadReputationOnKill(); }, { creatures });
+    templateLoader.AddStep("Reputation Spillover Data", [] { sObjectMgr.LoadReputationSpilloverTemplate(); });
+    templateLoader.AddStep("Points Of Interest Data", [] { sObjectMgr.LoadPointsOfInterest(); });
+
+    templateLoader.Run(getConfig(CONFIG_UINT32_STARTUP_LOAD_THREADS));
 
     sLog.outString("Loading Creature Conditional Spawn Data...");  // must be after LoadCreatureTemplates and before LoadCreatures
     sObjectMgr.LoadCreatureConditionalSpawn();
@@ -1697,6 +1687,7 @@ void World::Update(uint32 diff)
     {
         m_timers[WUPDATE_METRICS].Reset();
         GeneratePacketMetrics();
+        GenerateDatabaseMetrics();
     }
 #endif
 
@@ -2762,6 +2753,28 @@ void World::IncrementOpcodeCounter(uint32 opcodeId)
 }
 
 #ifdef BUILD_METRICS
+void World::GenerateDatabaseMetrics()
+{
+    auto generate = [](char const* name, Database& db)
+    {
+        for (uint32 i = 0; i < db.GetAsyncLaneCount(); ++i)
+        {
+            SqlDelayThread* lane = db.GetAsyncLaneThread(i);
+            if (!lane)
+                continue;
+
+            metric::measurement meas("db.async", { {"database", name}, {"lane", std::to_string(i)} });
+            meas.add_field("queue", std::to_string(lane->GetQueueDepth()));
+            meas.add_field("max_latency", std::to_string(lane->TakeMaxLatency()));
+        }
+    };
+
+    generate("character", CharacterDatabase);
+    generate("world", WorldDatabase);
+    generate("login", LoginDatabase);
+    generate("logs", LogsDatabase);
+}
+
 void World::GeneratePacketMetrics()
 {
     for (uint32 i = 0; i < NUM_MSG_TYPES; ++i)
@@ -2776,6 +2789,22 @@ void World::GeneratePacketMetrics()
         m_opcodeCounters[i] = 0;
     }
 
+    uint32 queued = 0, queuedMap = 0, maxDepth = 0, overflowed = 0;
+    for (auto& data : m_sessions)
+    {
+        WorldSession const* session = data.second;
+        queued += session->GetRecvQueueDepth();
+        queuedMap += session->GetRecvQueueMapDepth();
+        maxDepth = std::max(maxDepth, session->GetRecvQueueDepth() + session->GetRecvQueueMapDepth());
+        overflowed += session->GetOverflowedPacketCount();
+    }
+
+    metric::measurement meas_queues("world.metrics.packets.queues");
+    meas_queues.add_field("world", std::to_string(queued));
+    meas_queues.add_field("map", std::to_string(queuedMap));
+    meas_queues.add_field("max_depth", std::to_string(maxDepth));
+    meas_queues.add_field("overflowed", std::to_string(overflowed));
+
     metric::measurement meas_players("world.metrics.players");
     meas_players.add_field("online", std::to_string(GetActiveSessionCount()));
     meas_players.add_field("unique", std::to_string(GetUniqueSessionCount()));
@@ -32,6 +32,7 @@
 #include "Globals/GraveyardManager.h"
 
 #include <set>
+#include <map>
 #include <list>
 #include <deque>
 #include <mutex>
@@ -96,7 +97,9 @@ enum eConfigUInt32Values
     CONFIG_UINT32_COMPRESSION = 0,
     CONFIG_UINT32_INTERVAL_SAVE,
     CONFIG_UINT32_INTERVAL_GRIDCLEAN,
+    CONFIG_UINT32_GRID_PREFETCH_LOOKAHEAD,
     CONFIG_UINT32_INTERVAL_MAPUPDATE,
+    CONFIG_UINT32_INTERVAL_MAPUPDATE_IDLE,
     CONFIG_UINT32_INTERVAL_CHANGEWEATHER,
     CONFIG_UINT32_PORT_WORLD,
     CONFIG_UINT32_GAME_TYPE,
@@ -148,6 +151,7 @@ enum eConfigUInt32Values
     CONFIG_UINT32_MASS_MAILER_SEND_PER_TICK,
     CONFIG_UINT32_UPTIME_UPDATE,
     CONFIG_UINT32_NUM_MAP_THREADS,
+    CONFIG_UINT32_STARTUP_LOAD_THREADS,
     CONFIG_UINT32_AUCTION_DEPOSIT_MIN,
     CONFIG_UINT32_SKILL_CHANCE_ORANGE,
     CONFIG_UINT32_SKILL_CHANCE_YELLOW,
@@ -389,10 +393,12 @@ enum eConfigBoolValues
     CONFIG_BOOL_PET_ATTACK_FROM_BEHIND,
     CONFIG_BOOL_AUTO_DOWNRANK,
     CONFIG_BOOL_MMAP_ENABLED,
+    CONFIG_BOOL_MAP_FILES_MEMORY_MAPPED,
     CONFIG_BOOL_PLAYER_COMMANDS,
     CONFIG_BOOL_AUTOLOAD_ACTIVE,
     CONFIG_BOOL_PATH_FIND_OPTIMIZE,
     CONFIG_BOOL_PATH_FIND_NORMALIZE_Z,
+    CONFIG_BOOL_PATH_FIND_ASYNC,
     CONFIG_BOOL_VALUE_COUNT
 };
 
@@ -609,6 +615,12 @@ class World
 
         /// Get configuration about force-loaded maps
         bool isForceLoadMap(uint32 id) const { return m_configForceLoadMapIds.find(id) != m_configForceLoadMapIds.end(); }
+        /// Get the configured update interval of a map, 0 for maps using MapUpdateInterval
+        uint32 GetMapUpdateInterval(uint32 id) const
+        {
+            auto itr = m_configMapUpdateIntervals.find(id);
+            return itr != m_configMapUpdateIntervals.end() ? itr->second : 0;
+        }
 
         /// Are we on a "Player versus Player" server?
         bool IsPvPRealm() const { return (getConfig(CONFIG_UINT32_GAME_TYPE) == REALM_TYPE_PVP || getConfig(CONFIG_UINT32_GAME_TYPE) == REALM_TYPE_RPPVP || getConfig(CONFIG_UINT32_GAME_TYPE) == REALM_TYPE_FFA_PVP); }
@@ -701,6 +713,7 @@ class World
 
 #ifdef BUILD_METRICS
         void GeneratePacketMetrics(); // thread safe due to atomics
+        void GenerateDatabaseMetrics();
         uint32 GetAverageLatency() const;
 #endif
 
@@ -786,6 +799,9 @@ class World
         // List of Maps that should be force-loaded on startup
         std::set<uint32> m_configForceLoadMapIds;
 
+        // Update intervals of maps ticking at their own rate
+        std::map<uint32, uint32> m_configMapUpdateIntervals;
+
         // Vector of quests that were chosen for given group
         std::vector<uint32> m_eventGroupChosen;
 
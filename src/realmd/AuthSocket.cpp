@@ -28,6 +28,7 @@
 #include "Log.h"
 #include "RealmList.h"
 #include "AuthSocket.h"
+#include "AuthWorkerPool.h"
 #include "AuthCodes.h"
 #include "SRP6/SRP6.h"
 #include "CommonDefines.h"
@@ -174,11 +175,22 @@ typedef struct AuthHandler
 #pragma pack(pop)
 #endif
 
+struct AuthSocket::LogonProofData
+{
+    LogonProofData() : pinRead(false), sessionKeyValid(false), matches(false) {}
+
+    sAuthLogonProof_C packet;
+    std::vector<uint8> pinKeys;                             // zero terminated
+    bool pinRead;
+    bool sessionKeyValid;
+    bool matches;
+};
+
 std::array<uint8, 16> VersionChallenge = { { 0xBA, 0xA3, 0x1E, 0x99, 0xA0, 0x0B, 0x21, 0x57, 0xFC, 0x37, 0x3F, 0xB3, 0x69, 0xCD, 0xD2, 0xF1 } };
 
 /// Constructor - set the N and g values for SRP6
 AuthSocket::AuthSocket(boost::asio::io_service& service, std::function<void (Socket*)> closeHandler)
-    : Socket(service, std::move(closeHandler)), _status(STATUS_CHALLENGE), _build(0), _accountSecurityLevel(SEC_PLAYER), m_timeoutTimer(service)
+    : Socket(service, std::move(closeHandler)), _status(STATUS_CHALLENGE), _build(0), _accountId(0), _accountSecurityLevel(SEC_PLAYER), m_timeoutTimer(service)
 {
     m_timeoutTimer.expires_from_now(boost::posix_time::seconds(30));
     m_timeoutTimer.async_wait([&] (const boost::system::error_code& error)
@@ -258,6 +270,31 @@ bool AuthSocket::ProcessIncomingData()
     return true;
 }
 
+void AuthSocket::ExecuteAsync(std::function<void()> const& query, std::function<void()> const& callback)
+{
+    RunAsync(sAuthQueryPool, query, callback);
+}
+
+void AuthSocket::ComputeAsync(std::function<void()> const& work, std::function<void()> const& callback)
+{
+    RunAsync(sAuthCryptoPool, work, callback);
+}
+
+void AuthSocket::RunAsync(AuthWorkerPool& pool, std::function<void()> const& work, std::function<void()> const& callback)
+{
+    // keeps the socket alive until the callback ran
+    std::shared_ptr<AuthSocket> self = shared<AuthSocket>();
+    pool.Enqueue([self, work, callback]()
+    {
+        work();
+        boost::asio::post(self->GetAsioSocket().get_executor(), [self, callback]()
+        {
+            if (!self->IsClosed())
+                callback();
+        });
+    });
+}
+
 void AuthSocket::SendProof(Sha1Hash sha)
 {
     switch (_build)
@@ -341,8 +378,6 @@ bool AuthSocket::_HandleLogonChallenge()
     EndianConvert(ch->timezone_bias);
     EndianConvert(ch->ip);
 
-    ByteBuffer pkt;
-
     _login = (const char*)ch->I;
     _build = ch->build;
 
@@ -358,33 +393,57 @@ bool AuthSocket::_HandleLogonChallenge()
     ///- Normalize account name
     // utf8ToUpperOnlyLatin(_login); -- client already send account in expected form
 
-    // Escape the user input used in DB to avoid further SQL injection
-    // Memory will be freed on AuthSocket object destruction
-    _safelogin = _login;
-    LoginDatabase.escape_string(_safelogin);
+    // Escape the user input used in DB to avoid further SQL injection, the account name is only bound to prepared statements
     _safelocale = m_locale;
     LoginDatabase.escape_string(_safelocale);
     LoginDatabase.escape_string(m_os);
 
+    ///- Query the bans and the account details on the auth query pool, the session stays closed until they are answered
+    std::shared_ptr<LogonChallengeQuery> query = std::make_shared<LogonChallengeQuery>();
+    std::string address = m_address;
+    std::string login = _login;
+    ExecuteAsync([query, address, login]()
+    {
+        static SqlStatementID selectIpBanned;
+        static SqlStatementID selectAccount;
+        static SqlStatementID selectAccountBanned;
+
+        ///- Verify that this IP is not in the ip_banned table
+        SqlStatement stmt = LoginDatabase.CreateStatement(selectIpBanned, "SELECT expires_at FROM ip_banned "
+                            "WHERE (expires_at = banned_at OR expires_at > UNIX_TIMESTAMP()) AND ip = ?");
+        std::unique_ptr<QueryResult> ipBanned(stmt.PQuery(address.c_str()));
+        query->ipBanned = !!ipBanned;
+        if (query->ipBanned)
+            return;
+
+        ///- Get the account details from the account table
+        stmt = LoginDatabase.CreateStatement(selectAccount, "SELECT id,locked,lockedIp,gmlevel,v,s,token FROM account WHERE username = ?");
+        query->account.reset(stmt.PQuery(login.c_str()));
+        if (!query->account)
+            return;
+
+        stmt = LoginDatabase.CreateStatement(selectAccountBanned, "SELECT banned_at,expires_at FROM account_banned WHERE "
+                                             "account_id = ? AND active = 1 AND (expires_at > UNIX_TIMESTAMP() OR expires_at = banned_at)");
+        query->accountBan.reset(stmt.PQuery((*query->account)[0].GetUInt32()));
+    }, [this, query]() { LogonChallengeCallback(*query); });
+
+    return true;
+}
+
+void AuthSocket::LogonChallengeCallback(LogonChallengeQuery const& query)
+{
+    ByteBuffer pkt;
     pkt << uint8(CMD_AUTH_LOGON_CHALLENGE);
     pkt << uint8(0x00);
 
-    ///- Verify that this IP is not in the ip_banned table
-    // No SQL injection possible (paste the IP address as passed by the socket)
-    std::unique_ptr<QueryResult> ip_banned_result(LoginDatabase.PQuery("SELECT expires_at FROM ip_banned "
-            "WHERE (expires_at = banned_at OR expires_at > UNIX_TIMESTAMP()) AND ip = '%s'", m_address.c_str()));
-
-    if (ip_banned_result)
+    if (query.ipBanned)
     {
         pkt << uint8(AUTH_LOGON_FAILED_FAIL_NOACCESS);
         BASIC_LOG("[AuthChallenge] Banned ip %s tries to login!", m_address.c_str());
     }
     else
     {
-        ///- Get the account details from the account table
-        // No SQL injection (escaped user name)
-        QueryResult* result = LoginDatabase.PQuery("SELECT id,locked,lockedIp,gmlevel,v,s,token FROM account WHERE username = '%s'", _safelogin.c_str());
-        if (result)
+        if (QueryResult* result = query.account.get())
         {
             Field* fields = result->Fetch();
 
@@ -420,9 +479,7 @@ bool AuthSocket::_HandleLogonChallenge()
             if (!locked && !broken)
             {
                 ///- If the account is banned, reject the logon attempt
-                QueryResult* banresult = LoginDatabase.PQuery("SELECT banned_at,expires_at FROM account_banned WHERE "
-                                         "account_id = %u AND active = 1 AND (expires_at > UNIX_TIMESTAMP() OR expires_at = banned_at)", fields[0].GetUInt32());
-                if (banresult)
+                if (QueryResult* banresult = query.accountBan.get())
                 {
                     if ((*banresult)[0].GetUInt64() == (*banresult)[1].GetUInt64())
                     {
@@ -434,8 +491,6 @@ bool AuthSocket::_HandleLogonChallenge()
                         pkt << uint8(AUTH_LOGON_FAILED_SUSPENDED);
                         BASIC_LOG("[AuthChallenge] Temporarily banned account %s tries to login!", _login.c_str());
                     }
-
-                    delete banresult;
                 }
                 else
                 {
@@ -486,19 +541,18 @@ bool AuthSocket::_HandleLogonChallenge()
 
                     uint8 secLevel = fields[3].GetUInt8();
                     _accountSecurityLevel = secLevel <= SEC_ADMINISTRATOR ? AccountTypes(secLevel) : SEC_ADMINISTRATOR;
+                    _accountId = fields[0].GetUInt32();
 
                     ///- All good, await client's proof
                     _status = STATUS_LOGON_PROOF;
                 }
             }
-            delete result;
         }
         else                                                // no account
             pkt << uint8(AUTH_LOGON_FAILED_UNKNOWN_ACCOUNT);
     }
 
     Write((const char*)pkt.contents(), pkt.size());
-    return true;
 }
 
 /// Logon Proof command handler
@@ -528,46 +582,69 @@ bool AuthSocket::_HandleLogonProof()
     }
     /// </ul>
 
-    ///- Continue the SRP6 calculation based on data received from the client
-    if(!srp.CalculateSessionKey(lp.A, 32))
+    std::shared_ptr<LogonProofData> proof = std::make_shared<LogonProofData>();
+    proof->packet = lp;
+
+    ///- The authenticator pin follows the proof, take it out of the buffer before the proof is computed
+    if (lp.securityFlags & SECURITY_FLAG_AUTHENTICATOR || !_token.empty())
     {
-        BASIC_LOG("[AuthChallenge] Session calculation failed for account %s!", _login.c_str());
-        return false;
+        uint8 pinCount;
+        if (Read((char*)&pinCount, sizeof(uint8)))
+        {
+            proof->pinKeys.resize(pinCount + 1);
+            proof->pinRead = Read((char*)proof->pinKeys.data(), sizeof(uint8) * pinCount);
+            proof->pinKeys[pinCount] = '\0';
+        }
     }
 
-    srp.HashSessionKey();
-    srp.CalculateProof(_login);
+    ///- Continue the SRP6 calculation based on data received from the client on the crypto pool
+    ComputeAsync([this, proof]()
+    {
+        proof->sessionKeyValid = srp.CalculateSessionKey(proof->packet.A, 32);
+        if (!proof->sessionKeyValid)
+            return;
+
+        srp.HashSessionKey();
+        srp.CalculateProof(_login);
+        proof->matches = !srp.Proof(proof->packet.M1, 20);
+    }, [this, proof]() { LogonProofCallback(*proof); });
+
+    return true;
+}
+
+void AuthSocket::LogonProofCallback(LogonProofData const& proof)
+{
+    sAuthLogonProof_C const& lp = proof.packet;
+
+    if (!proof.sessionKeyValid)
+    {
+        BASIC_LOG("[AuthChallenge] Session calculation failed for account %s!", _login.c_str());
+        Close();
+        return;
+    }
 
     ///- Check if SRP6 results match (password is correct), else send an error
-    if (!srp.Proof(lp.M1, 20))
+    if (proof.matches)
     {
         if (lp.securityFlags & SECURITY_FLAG_AUTHENTICATOR || !_token.empty())
         {
-            uint8 pinCount;
-            if (!Read((char*)&pinCount, sizeof(uint8)))
-            {
-                const char data[4] = { CMD_AUTH_LOGON_PROOF, AUTH_LOGON_FAILED_UNKNOWN_ACCOUNT, 3, 0 };
-                Write(data, sizeof(data));
-                return true;
-            }
-            std::vector<uint8> keys(pinCount + 1);
-            if (!Read((char*)keys.data(), sizeof(uint8) * pinCount))
+            if (!proof.pinRead)
             {
                 const char data[4] = { CMD_AUTH_LOGON_PROOF, AUTH_LOGON_FAILED_UNKNOWN_ACCOUNT, 3, 0 };
                 Write(data, sizeof(data));
-                return true;
+                return;
             }
 
-            keys[pinCount] = '\0';
+            uint8 pinCount = uint8(proof.pinKeys.size() - 1);
             auto ServerToken = generateToken(_token.c_str());
-            auto clientToken = atoi((const char*)keys.data());
+            auto clientToken = atoi((const char*)proof.pinKeys.data());
             if (ServerToken != clientToken)
             {
                 BASIC_LOG("[AuthChallenge] Account %s tried to login with wrong pincode! Given %u Expected %u Pin Count: %u", _login.c_str(), clientToken, ServerToken, pinCount);
 
                 const char data[4] = { CMD_AUTH_LOGON_PROOF, AUTH_LOGON_FAILED_UNKNOWN_ACCOUNT, 0, 0 };
                 Write(data, sizeof(data));
-                return true;
+                return;
             }
         }
 
@@ -577,7 +654,7 @@ bool AuthSocket::_HandleLogonProof()
 
             const char data[2] = { CMD_AUTH_LOGON_PROOF, AUTH_LOGON_FAILED_VERSION_INVALID };
             Write(data, sizeof(data));
-            return true;
+            return;
         }
 
         BASIC_LOG("User '%s' successfully authenticated", _login.c_str());
@@ -585,9 +662,8 @@ bool AuthSocket::_HandleLogonProof()
         ///- Update the sessionkey, current ip and login time and reset number of failed logins in the account table for this account
         // No SQL injection (escaped user input) and IP address as received by socket
         const char* K_hex = srp.GetStrongSessionKey().AsHexStr();
-        LoginDatabase.PExecute("UPDATE account SET sessionkey = '%s', locale = '%s', failed_logins = 0, os = '%s' WHERE username = '%s'", K_hex, _safelocale.c_str(), m_os.c_str(), _safelogin.c_str());
-        if (QueryResult* loginfail = LoginDatabase.PQuery("SELECT id FROM account WHERE username = '%s'", _safelogin.c_str()))
-            LoginDatabase.PExecute("INSERT INTO account_logons(accountId,ip,loginTime,loginSource) VALUES('%u','%s',NOW(),'%u')", loginfail->Fetch()[0].GetUInt32(), m_address.c_str(), LOGIN_TYPE_REALMD);
+        LoginDatabase.PExecute("UPDATE account SET sessionkey = '%s', locale = '%s', failed_logins = 0, os = '%s' WHERE id = '%u'", K_hex, _safelocale.c_str(), m_os.c_str(), _accountId);
+        LoginDatabase.PExecute("INSERT INTO account_logons(accountId,ip,loginTime,loginSource) VALUES('%u','%s',NOW(),'%u')", _accountId, m_address.c_str(), LOGIN_TYPE_REALMD);
         OPENSSL_free((void*)K_hex);
 
         ///- Finish SRP6 and send the final result to the client
@@ -618,43 +694,46 @@ bool AuthSocket::_HandleLogonProof()
         uint32 MaxWrongPassCount = sConfig.GetIntDefault("WrongPass.MaxCount", 0);
         if (MaxWrongPassCount > 0)
         {
-            // Increment number of failed logins by one and if it reaches the limit temporarily ban that account or IP
-            LoginDatabase.PExecute("UPDATE account SET failed_logins = failed_logins + 1 WHERE username = '%s'", _safelogin.c_str());
-
-            if (QueryResult* loginfail = LoginDatabase.PQuery("SELECT id, failed_logins FROM account WHERE username = '%s'", _safelogin.c_str()))
+            uint32 WrongPassBanTime = sConfig.GetIntDefault("WrongPass.BanTime", 600);
+            bool WrongPassBanType = sConfig.GetBoolDefault("WrongPass.BanType", false);
+            uint32 accountId = _accountId;
+            std::string login = _login;
+            std::string current_ip = m_address;
+
+            // the counter is read back right after the update, so run both on the auth query pool
+            sAuthQueryPool.Enqueue([=]()
             {
-                Field* fields = loginfail->Fetch();
-                uint32 failed_logins = fields[1].GetUInt32();
+                // Increment number of failed logins by one and if it reaches the limit temporarily ban that account or IP
+                LoginDatabase.DirectPExecute("UPDATE account SET failed_logins = failed_logins + 1 WHERE id = '%u'", accountId);
 
-                if (failed_logins >= MaxWrongPassCount)
-                {
-                    uint32 WrongPassBanTime = sConfig.GetIntDefault("WrongPass.BanTime", 600);
-                    bool WrongPassBanType = sConfig.GetBoolDefault("WrongPass.BanType", false);
+                std::unique_ptr<QueryResult> loginfail(LoginDatabase.PQuery("SELECT failed_logins FROM account WHERE id = '%u'", accountId));
+                if (!loginfail)
+                    return;
 
-                    if (WrongPassBanType)
-                    {
-                        uint32 acc_id = fields[0].GetUInt32();
-                        LoginDatabase.PExecute("INSERT INTO account_banned(account_id, banned_at, expires_at, banned_by, reason, active)"
-                                               "VALUES ('%u',UNIX_TIMESTAMP(),UNIX_TIMESTAMP()+'%u','MaNGOS realmd','Failed login autoban',1)",
-                                               acc_id, WrongPassBanTime);
-                        BASIC_LOG("[AuthChallenge] account %s got banned for '%u' seconds because it failed to authenticate '%u' times",
-                                  _login.c_str(), WrongPassBanTime, failed_logins);
-                    }
-                    else
-                    {
-                        std::string current_ip = m_address;
-                        LoginDatabase.escape_string(current_ip);
-                        LoginDatabase.PExecute("INSERT INTO ip_banned VALUES ('%s',UNIX_TIMESTAMP(),UNIX_TIMESTAMP()+'%u','MaNGOS realmd','Failed login autoban')",
-                                               current_ip.c_str(), WrongPassBanTime);
-                        BASIC_LOG("[AuthChallenge] IP %s got banned for '%u' seconds because account %s failed to authenticate '%u' times",
-                                  current_ip.c_str(), WrongPassBanTime, _login.c_str(), failed_logins);
-                    }
+                uint32 failed_logins = (*loginfail)[0].GetUInt32();
+                if (failed_logins < MaxWrongPassCount)
+                    return;
+
+                if (WrongPassBanType)
+                {
+                    LoginDatabase.PExecute("INSERT INTO account_banned(account_id, banned_at, expires_at, banned_by, reason, active)"
+                                           "VALUES ('%u',UNIX_TIMESTAMP(),UNIX_TIMESTAMP()+'%u','MaNGOS realmd','Failed login autoban',1)",
+                                           accountId, WrongPassBanTime);
+                    BASIC_LOG("[AuthChallenge] account %s got banned for '%u' seconds because it failed to authenticate '%u' times",
+                              login.c_str(), WrongPassBanTime, failed_logins);
                 }
-                delete loginfail;
-            }
+                else
+                {
+                    std::string safe_ip = current_ip;
+                    LoginDatabase.escape_string(safe_ip);
+                    LoginDatabase.PExecute("INSERT INTO ip_banned VALUES ('%s',UNIX_TIMESTAMP(),UNIX_TIMESTAMP()+'%u','MaNGOS realmd','Failed login autoban')",
+                                           safe_ip.c_str(), WrongPassBanTime);
+                    BASIC_LOG("[AuthChallenge] IP %s got banned for '%u' seconds because account %s failed to authenticate '%u' times",
+                              safe_ip.c_str(), WrongPassBanTime, login.c_str(), failed_logins);
+                }
+            });
         }
     }
-    return true;
 }
 
 /// Reconnect Challenge command handler
@@ -694,25 +773,35 @@ bool AuthSocket::_HandleReconnectChallenge()
 
     _login = (const char*)ch->I;
 
-    _safelogin = _login;
-    LoginDatabase.escape_string(_safelogin);
-
     EndianConvert(ch->build);
     _build = ch->build;
 
-    QueryResult* result = LoginDatabase.PQuery("SELECT sessionkey FROM account WHERE username = '%s'", _safelogin.c_str());
+    std::shared_ptr<std::unique_ptr<QueryResult>> result = std::make_shared<std::unique_ptr<QueryResult>>();
+    std::string login = _login;
+    ExecuteAsync([result, login]()
+    {
+        static SqlStatementID selectSessionKey;
 
+        SqlStatement stmt = LoginDatabase.CreateStatement(selectSessionKey, "SELECT id, sessionkey FROM account WHERE username = ?");
+        result->reset(stmt.PQuery(login.c_str()));
+    }, [this, result]() { ReconnectChallengeCallback(result->get()); });
+
+    return true;
+}
+
+void AuthSocket::ReconnectChallengeCallback(QueryResult* result)
+{
     // Stop if the account is not found
     if (!result)
     {
         sLog.outError("[ERROR] user %s tried to login and we cannot find his session key in the database.", _login.c_str());
         Close();
-        return false;
+        return;
     }
 
     Field* fields = result->Fetch();
-    srp.SetStrongSessionKey(fields[0].GetString());
-    delete result;
+    _accountId = fields[0].GetUInt32();
+    srp.SetStrongSessionKey(fields[1].GetString());
 
     ///- All good, await client's proof
     _status = STATUS_RECON_PROOF;
@@ -725,7 +814,6 @@ bool AuthSocket::_HandleReconnectChallenge()
     pkt.append(_reconnectProof.AsByteArray(16));        // 16 bytes random
     pkt.append(VersionChallenge.data(), VersionChallenge.size());
     Write((const char*)pkt.contents(), pkt.size());
-    return true;
 }
 
 /// Reconnect Proof command handler
@@ -789,26 +877,43 @@ bool AuthSocket::_HandleRealmList()
 
     ReadSkip(5);
 
-    ///- Get the user id (else close the connection)
-    // No SQL injection (escaped user name)
-
-    QueryResult* result = LoginDatabase.PQuery("SELECT id FROM account WHERE username = '%s'", _safelogin.c_str());
-    if (!result)
+    ///- Clients poll the realm list, so the character counts are cached per account
+    RealmCharacterCounts characterCounts;
+    if (sRealmList.GetCharacterCounts(_accountId, characterCounts))
     {
-        sLog.outError("[ERROR] user %s tried to login and we cannot find him in the database.", _login.c_str());
-        Close();
-        return false;
+        SendRealmList(characterCounts);
+        return true;
     }
 
-    uint32 id = (*result)[0].GetUInt32();
-    delete result;
+    std::shared_ptr<RealmCharacterCounts> query = std::make_shared<RealmCharacterCounts>();
+    uint32 accountId = _accountId;
+    ExecuteAsync([query, accountId]()
+    {
+        static SqlStatementID selectCharacterCounts;
+
+        SqlStatement stmt = LoginDatabase.CreateStatement(selectCharacterCounts, "SELECT realmid, numchars FROM realmcharacters WHERE acctid = ?");
+        if (QueryResult* result = stmt.PQuery(accountId))
+        {
+            do
+            {
+                Field* fields = result->Fetch();
+                (*query)[fields[0].GetUInt32()] = fields[1].GetUInt8();
+            }
+            while (result->NextRow());
+            delete result;
+        }
 
-    ///- Update realm list if need
-    sRealmList.UpdateIfNeed();
+        sRealmList.SetCharacterCounts(accountId, *query);
+    }, [this, query]() { SendRealmList(*query); });
 
+    return true;
+}
+
+void AuthSocket::SendRealmList(RealmCharacterCounts const& characterCounts)
+{
     ///- Circle through realms in the RealmList and construct the return packet (including # of user characters in each realm)
     ByteBuffer pkt;
-    LoadRealmlist(pkt, id);
+    LoadRealmlist(pkt, characterCounts);
 
     ByteBuffer hdr;
     hdr << (uint8) CMD_REALM_LIST;
@@ -816,11 +921,12 @@ bool AuthSocket::_HandleRealmList()
     hdr.append(pkt);
 
     Write((const char*)hdr.contents(), hdr.size());
-    return true;
 }
 
-void AuthSocket::LoadRealmlist(ByteBuffer& pkt, uint32 acctid)
+void AuthSocket::LoadRealmlist(ByteBuffer& pkt, RealmCharacterCounts const& characterCounts)
 {
+    RealmList::RealmMapPtr realms = sRealmList.GetRealms();
+
     switch (_build)
     {
         case 5875:                                          // 1.12.1
@@ -828,22 +934,12 @@ void AuthSocket::LoadRealmlist(ByteBuffer& pkt, uint32 acctid)
         case 6141:                                          // 1.12.3
         {
             pkt << uint32(0);                               // unused value
-            pkt << uint8(sRealmList.size());
+            pkt << uint8(realms->size());
 
-            for (const auto& i : sRealmList)
+            for (const auto& i : *realms)
             {
-                uint8 AmountOfCharacters;
-
-                // No SQL injection. id of realm is controlled by the database.
-                QueryResult* result = LoginDatabase.PQuery("SELECT numchars FROM realmcharacters WHERE realmid = '%d' AND acctid='%u'", i.second.m_ID, acctid);
-                if (result)
-                {
-                    Field* fields = result->Fetch();
-                    AmountOfCharacters = fields[0].GetUInt8();
-                    delete result;
-                }
-                else
-                    AmountOfCharacters = 0;
+                RealmCharacterCounts::const_iterator count = characterCounts.find(i.second.m_ID);
+                uint8 AmountOfCharacters = count != characterCounts.end() ? count->second : 0;
 
                 bool ok_build = std::find(i.second.realmbuilds.begin(), i.second.realmbuilds.end(), _build) != i.second.realmbuilds.end();
 
@@ -889,22 +985,12 @@ void AuthSocket::LoadRealmlist(ByteBuffer& pkt, uint32 acctid)
         default:                                            // and later
         {
             pkt << uint32(0);                               // unused value
-            pkt << uint16(sRealmList.size());
+            pkt << uint16(realms->size());
 
-            for (const auto& i : sRealmList)
+            for (const auto& i : *realms)
             {
-                uint8 AmountOfCharacters;
-
-                // No SQL injection. id of realm is controlled by the database.
-                QueryResult* result = LoginDatabase.PQuery("SELECT numchars FROM realmcharacters WHERE realmid = '%d' AND acctid='%u'", i.second.m_ID, acctid);
-                if (result)
-                {
-                    Field* fields = result->Fetch();
-                    AmountOfCharacters = fields[0].GetUInt8();
-                    delete result;
-                }
-                else
-                    AmountOfCharacters = 0;
+                RealmCharacterCounts::const_iterator count = characterCounts.find(i.second.m_ID);
+                uint8 AmountOfCharacters = count != characterCounts.end() ? count->second : 0;
 
                 bool ok_build = std::find(i.second.realmbuilds.begin(), i.second.realmbuilds.end(), _build) != i.second.realmbuilds.end();
 
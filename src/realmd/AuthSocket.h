@@ -28,15 +28,20 @@
 #include "Auth/Sha1.h"
 #include "SRP6/SRP6.h"
 #include "ByteBuffer.h"
+#include "RealmList.h"
 
 #include "Network/Socket.hpp"
 
 #include <boost/asio.hpp>
 
 #include <functional>
+#include <memory>
 
 #define HMAC_RES_SIZE 20
 
+class AuthWorkerPool;
+class QueryResult;
+
 class AuthSocket : public MaNGOS::Socket
 {
     public:
@@ -45,7 +50,7 @@ class AuthSocket : public MaNGOS::Socket
         AuthSocket(boost::asio::io_service& service, std::function<void (Socket*)> closeHandler);
 
         void SendProof(Sha1Hash sha);
-        void LoadRealmlist(ByteBuffer& pkt, uint32 acctid);
+        void LoadRealmlist(ByteBuffer& pkt, RealmCharacterCounts const& characterCounts);
         int32 generateToken(char const* b32key);
 
         bool VerifyVersion(uint8 const* a, int32 aLength, uint8 const* versionProof, bool isReconnect);
@@ -61,6 +66,28 @@ class AuthSocket : public MaNGOS::Socket
         bool _HandleXferAccept();
 
     private:
+        struct LogonChallengeQuery
+        {
+            LogonChallengeQuery() : ipBanned(false) {}
+
+            bool ipBanned;
+            std::unique_ptr<QueryResult> account;
+            std::unique_ptr<QueryResult> accountBan;
+        };
+
+        struct LogonProofData;
+
+        // runs query on the auth query pool, then callback on the network thread of the socket if it is still open
+        void ExecuteAsync(std::function<void()> const& query, std::function<void()> const& callback);
+        // same for SRP6 work on the auth crypto pool, the socket must not touch srp until callback ran
+        void ComputeAsync(std::function<void()> const& work, std::function<void()> const& callback);
+        void RunAsync(AuthWorkerPool& pool, std::function<void()> const& work, std::function<void()> const& callback);
+
+        void LogonChallengeCallback(LogonChallengeQuery const& query);
+        void LogonProofCallback(LogonProofData const& proof);
+        void ReconnectChallengeCallback(QueryResult* result);
+        void SendRealmList(RealmCharacterCounts const& characterCounts);
+
         enum eStatus
         {
             STATUS_CHALLENGE,
@@ -77,12 +104,12 @@ class AuthSocket : public MaNGOS::Socket
         eStatus _status;
 
         std::string _login;
-        std::string _safelogin;
         std::string _token;
         std::string m_os;
         std::string m_locale;
         std::string _safelocale;
         uint16 _build;
+        uint32 _accountId;
         AccountTypes _accountSecurityLevel;
 
         boost::asio::deadline_timer m_timeoutTimer;
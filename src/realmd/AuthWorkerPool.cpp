@@ -0,0 +1,68 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/** \file
+    \ingroup realmd
+*/
+
+#include "AuthWorkerPool.h"
+#include "Database/DatabaseEnv.h"
+
+extern DatabaseType LoginDatabase;
+
+AuthWorkerPool sAuthQueryPool(true);
+AuthWorkerPool sAuthCryptoPool(false);
+
+void AuthWorkerPool::Start(uint32 threads)
+{
+    for (uint32 i = 0; i < threads; ++i)
+        m_threads.emplace_back(&AuthWorkerPool::WorkerThread, this, int(i));
+}
+
+void AuthWorkerPool::Stop()
+{
+    // queued tasks are dropped, their sockets get closed with the network threads anyway
+    m_queue.Cancel();
+
+    for (auto& thread : m_threads)
+        thread.join();
+    m_threads.clear();
+}
+
+void AuthWorkerPool::WorkerThread(int connectionIndex)
+{
+    if (m_useLoginDatabase)
+    {
+        LoginDatabase.ThreadStart();
+        Database::SetThreadQueryConnection(connectionIndex);
+    }
+
+    for (;;)
+    {
+        Task task;
+        m_queue.WaitAndPop(task);
+        // only an empty task after Cancel()
+        if (!task)
+            break;
+
+        task();
+    }
+
+    if (m_useLoginDatabase)
+        LoginDatabase.ThreadEnd();
+}
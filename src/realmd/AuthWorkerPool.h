@@ -0,0 +1,60 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/// \addtogroup realmd
+/// @{
+/// \file
+
+#ifndef _AUTHWORKERPOOL_H
+#define _AUTHWORKERPOOL_H
+
+#include "Common.h"
+#include "ProducerConsumerQueue.h"
+
+#include <functional>
+#include <thread>
+#include <vector>
+
+/// Threads running the blocking work of the auth handlers, so the network threads only parse and send packets
+/// sAuthQueryPool runs the login database queries, every thread with its own query connection of LoginDatabase.
+/// sAuthCryptoPool runs the SRP6 computations.
+class AuthWorkerPool
+{
+    public:
+        typedef std::function<void()> Task;
+
+        explicit AuthWorkerPool(bool useLoginDatabase) : m_useLoginDatabase(useLoginDatabase) {}
+
+        void Start(uint32 threads);
+        void Stop();
+
+        void Enqueue(Task task) { m_queue.Push(std::move(task)); }
+
+    private:
+        void WorkerThread(int connectionIndex);
+
+        bool m_useLoginDatabase;
+        ProducerConsumerQueue<Task> m_queue;
+        std::vector<std::thread> m_threads;
+};
+
+extern AuthWorkerPool sAuthQueryPool;
+extern AuthWorkerPool sAuthCryptoPool;
+
+#endif
+/// @}
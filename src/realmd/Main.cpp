@@ -27,6 +27,7 @@
 #include "Config/Config.h"
 #include "Log.h"
 #include "AuthSocket.h"
+#include "AuthWorkerPool.h"
 #include "SystemConfig.h"
 #include "revision.h"
 #include "revision_sql.h"
@@ -210,6 +211,11 @@ int main(int argc, char* argv[])
         return 1;
     }
 
+    ///- Start the threads answering the login database queries of the auth handlers
+    sAuthQueryPool.Start(sConfig.GetIntDefault("LoginDatabaseConnections", 2));
+    ///- and the SRP6 computations of logon proofs
+    sAuthCryptoPool.Start(std::max(sConfig.GetIntDefault("CryptoThreads", 2), 1));
+
     // cleanup query
     // set expired bans to inactive
     LoginDatabase.BeginTransaction();
@@ -221,7 +227,9 @@ int main(int argc, char* argv[])
     MaNGOS::Listener<AuthSocket> listener(
             sConfig.GetStringDefault("BindIP", "0.0.0.0"),
             sConfig.GetIntDefault("RealmServerPort", DEFAULT_REALMSERVER_PORT),
-            sConfig.GetIntDefault("ListenerThreads", 1)
+            sConfig.GetIntDefault("ListenerThreads", 1),
+            sConfig.GetBoolDefault("ListenerReusePort", false),
+            sConfig.GetBoolDefault("ListenerThreadAffinity", false)
     );
 
     ///- Catch termination signals
@@ -283,6 +291,8 @@ int main(int argc, char* argv[])
     ///- Wait for termination signal
     while (!stopEvent)
     {
+        sRealmList.UpdateIfNeed();
+
         if ((++loopCounter) == numLoops)
         {
             loopCounter = 0;
@@ -296,6 +306,9 @@ int main(int argc, char* argv[])
 #endif
     }
 
+    sAuthCryptoPool.Stop();
+    sAuthQueryPool.Stop();
+
     ///- Wait for the delay thread to exit
     LoginDatabase.HaltDelayThread();
 
@@ -336,9 +349,10 @@ bool StartDB()
         return false;
     }
 
-    sLog.outString("Login Database total connections: %i", 1 + 1);
+    int nConnections = sConfig.GetIntDefault("LoginDatabaseConnections", 2);
+    sLog.outString("Login Database total connections: %i", nConnections + 1);
 
-    if (!LoginDatabase.Initialize(dbstring.c_str()))
+    if (!LoginDatabase.Initialize(dbstring.c_str(), nConnections))
     {
         sLog.outError("Cannot connect to database");
         return false;
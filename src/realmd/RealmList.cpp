@@ -81,7 +81,7 @@ RealmBuildInfo const* FindBuildInfo(uint16 _build)
     return nullptr;
 }
 
-RealmList::RealmList() : m_UpdateInterval(0), m_NextUpdateTime(time(nullptr))
+RealmList::RealmList() : m_realms(std::make_shared<RealmMap>()), m_UpdateInterval(0), m_NextUpdateTime(time(nullptr)), m_NextCharacterCountsCleanup(time(nullptr))
 {
 }
 
@@ -100,10 +100,10 @@ void RealmList::Initialize(uint32 updateInterval)
     UpdateRealms(true);
 }
 
-void RealmList::UpdateRealm(uint32 ID, const std::string& name, const std::string& address, uint32 port, uint8 icon, RealmFlags realmflags, uint8 timezone, AccountTypes allowedSecurityLevel, float popu, const std::string& builds)
+void RealmList::UpdateRealm(RealmMap& realms, uint32 ID, const std::string& name, const std::string& address, uint32 port, uint8 icon, RealmFlags realmflags, uint8 timezone, AccountTypes allowedSecurityLevel, float popu, const std::string& builds)
 {
     ///- Create new if not exist or update existed
-    Realm& realm = m_realms[name];
+    Realm& realm = realms[name];
 
     realm.m_ID       = ID;
     realm.icon       = icon;
@@ -147,13 +147,55 @@ void RealmList::UpdateIfNeed()
 
     m_NextUpdateTime = time(nullptr) + m_UpdateInterval;
 
-    // Clears Realm list
-    m_realms.clear();
-
     // Get the content of the realmlist table in the database
     UpdateRealms(false);
 }
 
+RealmList::RealmMapPtr RealmList::GetRealms() const
+{
+    std::lock_guard<std::mutex> guard(m_realmsLock);
+    return m_realms;
+}
+
+bool RealmList::GetCharacterCounts(uint32 accountId, RealmCharacterCounts& counts)
+{
+    std::lock_guard<std::mutex> guard(m_characterCountsLock);
+
+    CharacterCountsCache::const_iterator itr = m_characterCounts.find(accountId);
+    if (itr == m_characterCounts.end() || itr->second.expireTime <= time(nullptr))
+        return false;
+
+    counts = itr->second.counts;
+    return true;
+}
+
+void RealmList::SetCharacterCounts(uint32 accountId, RealmCharacterCounts const& counts)
+{
+    // without realm list updates the counts could never change, don't cache at all
+    if (!m_UpdateInterval)
+        return;
+
+    time_t now = time(nullptr);
+
+    std::lock_guard<std::mutex> guard(m_characterCountsLock);
+
+    CachedCharacterCounts& cached = m_characterCounts[accountId];
+    cached.counts = counts;
+    cached.expireTime = now + m_UpdateInterval;
+
+    if (m_NextCharacterCountsCleanup > now)
+        return;
+
+    m_NextCharacterCountsCleanup = now + m_UpdateInterval;
+    for (CharacterCountsCache::iterator itr = m_characterCounts.begin(); itr != m_characterCounts.end();)
+    {
+        if (itr->second.expireTime <= now)
+            itr = m_characterCounts.erase(itr);
+        else
+            ++itr;
+    }
+}
+
 void RealmList::UpdateRealms(bool init)
 {
     DETAIL_LOG("Updating Realm List...");
@@ -161,6 +203,8 @@ void RealmList::UpdateRealms(bool init)
     ////                                               0   1     2        3     4     5           6         7                     8           9
     QueryResult* result = LoginDatabase.Query("SELECT id, name, address, port, icon, realmflags, timezone, allowedSecurityLevel, population, realmbuilds FROM realmlist WHERE (realmflags & 1) = 0 ORDER BY name");
 
+    std::shared_ptr<RealmMap> realms = std::make_shared<RealmMap>();
+
     ///- Circle through results and add them to the realm map
     if (result)
     {
@@ -179,7 +223,7 @@ void RealmList::UpdateRealms(bool init)
                 realmflags &= (REALM_FLAG_OFFLINE | REALM_FLAG_NEW_PLAYERS | REALM_FLAG_RECOMMENDED | REALM_FLAG_SPECIFYBUILD);
             }
 
-            UpdateRealm(
+            UpdateRealm(*realms,
                 Id, name, fields[2].GetCppString(), fields[3].GetUInt32(),
                 fields[4].GetUInt8(), RealmFlags(realmflags), fields[6].GetUInt8(),
                 (allowedSecurityLevel <= SEC_ADMINISTRATOR ? AccountTypes(allowedSecurityLevel) : SEC_ADMINISTRATOR),
@@ -191,4 +235,8 @@ void RealmList::UpdateRealms(bool init)
         while (result->NextRow());
         delete result;
     }
+
+    // readers keep the list they took, the new one is only swapped in
+    std::lock_guard<std::mutex> guard(m_realmsLock);
+    m_realms = realms;
 }
@@ -25,6 +25,9 @@
 
 #include "Common.h"
 #include <array>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
 
 struct RealmBuildInfo
 {
@@ -40,6 +43,7 @@ struct RealmBuildInfo
 RealmBuildInfo const* FindBuildInfo(uint16 _build);
 
 typedef std::set<uint32> RealmBuilds;
+typedef std::map<uint32 /*realm id*/, uint8 /*numchars*/> RealmCharacterCounts;
 
 /// Storage object for a realm
 struct Realm
@@ -60,6 +64,7 @@ class RealmList
 {
     public:
         typedef std::map<std::string, Realm> RealmMap;
+        typedef std::shared_ptr<RealmMap const> RealmMapPtr;
 
         static RealmList& Instance();
 
@@ -68,18 +73,35 @@ class RealmList
 
         void Initialize(uint32 updateInterval);
 
+        // called from the realmd main loop, the network threads never wait for the realmlist query
         void UpdateIfNeed();
 
-        RealmMap::const_iterator begin() const { return m_realms.begin(); }
-        RealmMap::const_iterator end() const { return m_realms.end(); }
-        uint32 size() const { return m_realms.size(); }
+        // updates replace the whole list, a snapshot stays valid for as long as it is held
+        RealmMapPtr GetRealms() const;
+        uint32 size() const { return GetRealms()->size(); }
+
+        // per-account `realmcharacters` cache, kept for one realm list update interval
+        bool GetCharacterCounts(uint32 accountId, RealmCharacterCounts& counts);
+        void SetCharacterCounts(uint32 accountId, RealmCharacterCounts const& counts);
     private:
         void UpdateRealms(bool init);
-        void UpdateRealm(uint32 ID, const std::string& name, const std::string& address, uint32 port, uint8 icon, RealmFlags realmflags, uint8 timezone, AccountTypes allowedSecurityLevel, float popu, const std::string& builds);
+        static void UpdateRealm(RealmMap& realms, uint32 ID, const std::string& name, const std::string& address, uint32 port, uint8 icon, RealmFlags realmflags, uint8 timezone, AccountTypes allowedSecurityLevel, float popu, const std::string& builds);
     private:
-        RealmMap m_realms;                                  ///< Internal map of realms
+        mutable std::mutex m_realmsLock;
+        RealmMapPtr m_realms;                               ///< Internal map of realms, replaced under m_realmsLock
         uint32   m_UpdateInterval;
         time_t   m_NextUpdateTime;
+
+        struct CachedCharacterCounts
+        {
+            RealmCharacterCounts counts;
+            time_t expireTime;
+        };
+        typedef std::unordered_map<uint32 /*account id*/, CachedCharacterCounts> CharacterCountsCache;
+
+        std::mutex m_characterCountsLock;                   // accessed from all network threads
+        CharacterCountsCache m_characterCounts;
+        time_t m_NextCharacterCountsCleanup;
 };
 
 #define sRealmList RealmList::Instance()
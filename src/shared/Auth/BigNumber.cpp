@@ -20,6 +20,24 @@
 #include <openssl/bn.h>
 #include <algorithm>
 
+namespace
+{
+    // scratch context of the calling thread, BN_CTX keeps its temporaries for reuse between calls
+    struct ThreadBNContext
+    {
+        ThreadBNContext() : ctx(BN_CTX_new()) {}
+        ~ThreadBNContext() { BN_CTX_free(ctx); }
+
+        BN_CTX* ctx;
+    };
+}
+
+BN_CTX* BigNumber::GetThreadContext()
+{
+    static thread_local ThreadBNContext context;
+    return context.ctx;
+}
+
 BigNumber::BigNumber()
 {
     _bn = BN_new();
@@ -95,27 +113,21 @@ BigNumber BigNumber::operator-=(const BigNumber& bn)
 
 BigNumber BigNumber::operator*=(const BigNumber& bn)
 {
-    BN_CTX* bnctx = BN_CTX_new();
-    BN_mul(_bn, _bn, bn._bn, bnctx);
-    BN_CTX_free(bnctx);
+    BN_mul(_bn, _bn, bn._bn, GetThreadContext());
 
     return *this;
 }
 
 BigNumber BigNumber::operator/=(const BigNumber& bn)
 {
-    BN_CTX* bnctx = BN_CTX_new();
-    BN_div(_bn, nullptr, _bn, bn._bn, bnctx);
-    BN_CTX_free(bnctx);
+    BN_div(_bn, nullptr, _bn, bn._bn, GetThreadContext());
 
     return *this;
 }
 
 BigNumber BigNumber::operator%=(const BigNumber& bn)
 {
-    BN_CTX* bnctx = BN_CTX_new();
-    BN_mod(_bn, _bn, bn._bn, bnctx);
-    BN_CTX_free(bnctx);
+    BN_mod(_bn, _bn, bn._bn, GetThreadContext());
 
     return *this;
 }
@@ -124,9 +136,7 @@ BigNumber BigNumber::Exp(const BigNumber& bn)
 {
     BigNumber ret;
 
-    BN_CTX* bnctx = BN_CTX_new();
-    BN_exp(ret._bn, _bn, bn._bn, bnctx);
-    BN_CTX_free(bnctx);
+    BN_exp(ret._bn, _bn, bn._bn, GetThreadContext());
 
     return ret;
 }
@@ -135,9 +145,7 @@ BigNumber BigNumber::ModExp(const BigNumber& bn1, const BigNumber& bn2)
 {
     BigNumber ret;
 
-    BN_CTX* bnctx = BN_CTX_new();
-    BN_mod_exp(ret._bn, _bn, bn1._bn, bn2._bn, bnctx);
-    BN_CTX_free(bnctx);
+    BN_mod_exp(ret._bn, _bn, bn1._bn, bn2._bn, GetThreadContext());
 
     return ret;
 }
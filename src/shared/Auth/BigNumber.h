@@ -23,6 +23,7 @@
 #include <vector>
 
 struct bignum_st;
+struct bignum_ctx;
 
 class BigNumber
 {
@@ -87,6 +88,9 @@ class BigNumber
         const char* AsHexStr() const;
         const char* AsDecStr() const;
 
+        // BN_CTX of the calling thread, for callers doing their own OpenSSL arithmetic
+        static struct bignum_ctx* GetThreadContext();
+
     private:
         struct bignum_st* _bn;
         uint8* _array;
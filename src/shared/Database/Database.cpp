@@ -91,13 +91,32 @@ bool SqlConnection::ExecuteStmt(int nIndex, const SqlStmtParameters& id)
     return pStmt->execute();
 }
 
+QueryResult* SqlConnection::QueryStmt(int nIndex, const SqlStmtParameters& id)
+{
+    if (nIndex == -1)
+        return nullptr;
+
+    // get prepared statement object
+    SqlPreparedStatement* pStmt = GetStmt(nIndex);
+    if (!pStmt->isQuery())
+    {
+        sLog.outError("SQL ERROR: statement '%s' does not return a result set", m_db.GetStmtString(nIndex).c_str());
+        return nullptr;
+    }
+
+    // bind parameters
+    pStmt->bind(id);
+    // fetch result set
+    return pStmt->query();
+}
+
 //////////////////////////////////////////////////////////////////////////
 Database::~Database()
 {
     StopServer();
 }
 
-bool Database::Initialize(const char* infoString, int nConns /*= 1*/)
+bool Database::Initialize(const char* infoString, int nConns /*= 1*/, int nAsyncConns /*= 1*/)
 {
     // Enable logging of SQL commands (usually only GM commands)
     // (See method: PExecuteLog)
@@ -134,10 +153,25 @@ bool Database::Initialize(const char* infoString, int nConns /*= 1*/)
         m_pQueryConnections.push_back(pConn);
     }
 
-    // create and initialize connection for async requests
-    m_pAsyncConn = CreateConnection();
-    if (!m_pAsyncConn->Initialize(infoString))
-        return false;
+    // create and initialize connections for async requests
+    if (nAsyncConns < MIN_CONNECTION_POOL_SIZE)
+        nAsyncConns = MIN_CONNECTION_POOL_SIZE;
+    else if (nAsyncConns > MAX_CONNECTION_POOL_SIZE)
+        nAsyncConns = MAX_CONNECTION_POOL_SIZE;
+
+    for (int i = 0; i < nAsyncConns; ++i)
+    {
+        SqlConnection* pConn = CreateConnection();
+        if (!pConn->Initialize(infoString))
+        {
+            delete pConn;
+            return false;
+        }
+
+        m_asyncLanes.push_back({ pConn, nullptr, nullptr, std::vector<uint64>(nAsyncConns, 0) });
+    }
+
+    m_pAsyncConn = m_asyncLanes[0].conn;
 
     m_pResultQueue = new SqlResultQueue;
 
@@ -150,10 +184,12 @@ void Database::StopServer()
     HaltDelayThread();
 
     delete m_pResultQueue;
-    delete m_pAsyncConn;
+    for (auto& lane : m_asyncLanes)
+        delete lane.conn;
 
     m_pResultQueue = nullptr;
     m_pAsyncConn = nullptr;
+    m_asyncLanes.clear();
 
     for (auto& m_pQueryConnection : m_pQueryConnections)
         delete m_pQueryConnection;
@@ -161,29 +197,53 @@ void Database::StopServer()
     m_pQueryConnections.clear();
 }
 
-SqlDelayThread* Database::CreateDelayThread()
+SqlDelayThread* Database::CreateDelayThread(SqlConnection* conn, bool pingDatabase)
 {
-    assert(m_pAsyncConn);
-    return new SqlDelayThread(this, m_pAsyncConn);
+    assert(conn);
+    return new SqlDelayThread(this, conn, pingDatabase);
 }
 
 void Database::InitDelayThread()
 {
-    assert(!m_delayThread);
+    assert(!m_asyncLanes.empty() && !m_threadBody);
 
-    // New delay thread for delay execute
-    m_threadBody = CreateDelayThread();              // will deleted at m_delayThread delete
-    m_delayThread = new MaNGOS::Thread(m_threadBody);
+    // New delay thread for delay execute, one per async connection
+    for (size_t i = 0; i < m_asyncLanes.size(); ++i)
+    {
+        AsyncLane& lane = m_asyncLanes[i];
+        lane.body = CreateDelayThread(lane.conn, i == 0);   // will deleted at lane.thread delete
+        lane.thread = new MaNGOS::Thread(lane.body);
+    }
+
+    m_threadBody = m_asyncLanes[0].body;
 }
 
 void Database::HaltDelayThread()
 {
-    if (!m_threadBody || !m_delayThread) return;
+    if (!m_threadBody) return;
+
+    for (auto& lane : m_asyncLanes)
+        lane.body->Stop();                                  // Stop event
+
+    for (auto& lane : m_asyncLanes)
+        lane.thread->wait();                                // Wait for flush to DB
+
+    // requests queued while the threads were stopping, a lane may wait for another one
+    bool done = false;
+    while (!done)
+    {
+        done = true;
+        for (auto& lane : m_asyncLanes)
+            done = lane.body->ProcessRequests(false) && done;
+    }
+
+    for (auto& lane : m_asyncLanes)
+    {
+        delete lane.thread;                                 // This also deletes lane.body
+        lane.thread = nullptr;
+        lane.body = nullptr;
+    }
 
-    m_threadBody->Stop();                                   // Stop event
-    m_delayThread->wait();                                  // Wait for flush to DB
-    delete m_delayThread;                                   // This also deletes m_threadBody
-    m_delayThread = nullptr;
     m_threadBody = nullptr;
 }
 
@@ -213,8 +273,13 @@ void Database::escape_string(std::string& str)
     delete[] buf;
 }
 
+thread_local int Database::m_threadQueryConnection = -1;
+
 SqlConnection* Database::getQueryConnection()
 {
+    if (m_threadQueryConnection >= 0)
+        return m_pQueryConnections[m_threadQueryConnection % m_nQueryConnPoolSize];
+
     int nCount = 0;
 
     if (m_nQueryCounter == long(1 << 31))
@@ -229,8 +294,9 @@ void Database::Ping()
 {
     const char* sql = "SELECT 1";
 
+    for (auto& lane : m_asyncLanes)
     {
-        SqlConnection::Lock guard(m_pAsyncConn);
+        SqlConnection::Lock guard(lane.conn);
         delete guard->Query(sql);
     }
 
@@ -302,6 +368,25 @@ QueryResult* Database::PQuery(const char* format, ...)
     return Query(szQuery);
 }
 
+QueryResult* Database::PQueryBinary(const char* format, ...)
+{
+    if (!format) return nullptr;
+
+    va_list ap;
+    char szQuery [MAX_QUERY_LEN];
+    va_start(ap, format);
+    int res = vsnprintf(szQuery, MAX_QUERY_LEN, format, ap);
+    va_end(ap);
+
+    if (res == -1)
+    {
+        sLog.outError("SQL Query truncated (and not execute) for format: %s", format);
+        return nullptr;
+    }
+
+    return QueryBinary(szQuery);
+}
+
 QueryNamedResult* Database::PQueryNamed(const char* format, ...)
 {
     if (!format) return nullptr;
@@ -339,7 +424,7 @@ bool Database::Execute(const char* sql)
             return DirectExecute(sql);
 
         // Simple sql statement
-        m_threadBody->Delay(new SqlPlainRequest(sql));
+        DelayRequest(new SqlPlainRequest(sql));
     }
 
     return true;
@@ -385,7 +470,7 @@ bool Database::DirectPExecute(const char* format, ...)
     return DirectExecute(szQuery);
 }
 
-bool Database::BeginTransaction()
+bool Database::BeginTransaction(uint32 laneKey /*= 0*/, uint32 otherLaneKey /*= 0*/)
 {
     if (!m_pAsyncConn)
         return false;
@@ -393,7 +478,7 @@ bool Database::BeginTransaction()
     MANGOS_ASSERT(!m_currentTransaction.get());   // if we will get a nested transaction request - we MUST fix code!!!
 
     if (!m_currentTransaction.get())
-        m_currentTransaction.reset(new SqlTransaction);
+        m_currentTransaction.reset(new SqlTransaction(laneKey, otherLaneKey));
 
     return m_currentTransaction.get() != nullptr;
 }
@@ -407,8 +492,46 @@ bool Database::CommitTransaction()
     if (!m_allowAsyncTransactions)
         return CommitTransactionDirect();
 
-    // add SqlTransaction to the async queue
-    m_threadBody->Delay(m_currentTransaction.release());
+    // add SqlTransaction to the async queue of its lane
+    SqlTransaction* pTrans = m_currentTransaction.release();
+    return DelayRequest(pTrans, pTrans->GetLaneKey(), pTrans->GetOtherLaneKey());
+}
+
+bool Database::DelayRequest(SqlOperation* op, uint32 laneKey /*= 0*/, uint32 otherLaneKey /*= 0*/)
+{
+    // a single async connection executes everything in queue order
+    size_t const laneCount = m_asyncLanes.size();
+    if (laneCount == 1)
+        return m_threadBody->Delay(op) != 0;
+
+    // unkeyed requests run on lane 0, they may touch the rows of any key
+    size_t const laneIndex = laneKey % laneCount;
+    AsyncLane& lane = m_asyncLanes[laneIndex];
+
+    auto spans = [&](size_t i) { return i != laneIndex && (!laneKey || (otherLaneKey && otherLaneKey % laneCount == i)); };
+
+    std::lock_guard<std::mutex> guard(m_asyncLanesOrderLock);
+
+    std::vector<SqlDelayThread::Position> waitFor;
+    for (size_t i = 0; i < laneCount; ++i)
+    {
+        if (i == laneIndex)
+            continue;
+
+        // earlier requests of the lanes spanned by this one, else the spanning requests queued there since the last one
+        uint64 const position = spans(i) ? m_asyncLanes[i].body->GetQueuedPosition() : lane.after[i];
+        if (position)
+            waitFor.emplace_back(m_asyncLanes[i].body, position);
+        lane.after[i] = 0;
+    }
+
+    uint64 const position = lane.body->Delay(op, std::move(waitFor));
+
+    // later requests of the spanned lanes wait for this one
+    for (size_t i = 0; i < laneCount; ++i)
+        if (spans(i))
+            m_asyncLanes[i].after[laneIndex] = position;
+
     return true;
 }
 
@@ -429,6 +552,15 @@ bool Database::CommitTransactionDirect()
     return true;
 }
 
+bool Database::ObserveTransaction(SqlTransactionStatePtr const& state)
+{
+    if (!m_currentTransaction.get())
+        return false;
+
+    m_currentTransaction->AddObserver(state);
+    return true;
+}
+
 bool Database::RollbackTransaction()
 {
     if (!m_pAsyncConn)
@@ -563,7 +695,7 @@ bool Database::ExecuteStmt(const SqlStatementID& id, SqlStmtParameters* params)
             return DirectExecuteStmt(id, params);
 
         // Simple sql statement
-        m_threadBody->Delay(new SqlPreparedRequest(id.ID(), params));
+        DelayRequest(new SqlPreparedRequest(id.ID(), params));
     }
 
     return true;
@@ -578,6 +710,15 @@ bool Database::DirectExecuteStmt(const SqlStatementID& id, SqlStmtParameters* pa
     return _guard->ExecuteStmt(id.ID(), *params);
 }
 
+QueryResult* Database::QueryStmt(const SqlStatementID& id, SqlStmtParameters* params)
+{
+    MANGOS_ASSERT(params);
+    std::unique_ptr<SqlStmtParameters> p(params);
+    // statements are prepared per connection, any of the query connections will do
+    SqlConnection::Lock _guard(getQueryConnection());
+    return _guard->QueryStmt(id.ID(), *params);
+}
+
 SqlStatement Database::CreateStatement(SqlStatementID& index, const char* fmt)
 {
     int nId = -1;
@@ -48,6 +48,8 @@ class SqlConnection
         // public methods for making queries
         virtual QueryResult* Query(const char* sql) = 0;
         virtual QueryNamedResult* QueryNamed(const char* sql) = 0;
+        // one-shot query over the binary protocol, worth the extra prepare round trip for big result sets only
+        virtual QueryResult* QueryBinary(const char* sql) { return Query(sql); }
 
         // public methods for making requests
         virtual bool Execute(const char* sql) = 0;
@@ -63,6 +65,7 @@ class SqlConnection
 
         // methods to work with prepared statements
         bool ExecuteStmt(int nIndex, const SqlStmtParameters& id);
+        QueryResult* QueryStmt(int nIndex, const SqlStmtParameters& id);
 
         // SqlConnection object lock
         class Lock
@@ -104,7 +107,7 @@ class Database
     public:
         virtual ~Database();
 
-        virtual bool Initialize(const char* infoString, int nConns = 1);
+        virtual bool Initialize(const char* infoString, int nConns = 1, int nAsyncConns = 1);
         // start worker thread for async DB request execution
         virtual void InitDelayThread();
         // stop worker thread
@@ -126,6 +129,15 @@ class Database
         QueryResult* PQuery(const char* format, ...) ATTR_PRINTF(2, 3);
         QueryNamedResult* PQueryNamed(const char* format, ...) ATTR_PRINTF(2, 3);
 
+        // same as Query but typed columns are fetched in binary form, meant for bulk loading
+        inline QueryResult* QueryBinary(const char* sql)
+        {
+            SqlConnection::Lock guard(getQueryConnection());
+            return guard->QueryBinary(sql);
+        }
+
+        QueryResult* PQueryBinary(const char* format, ...) ATTR_PRINTF(2, 3);
+
         bool DirectExecute(const char* sql) const
         {
             if (!m_pAsyncConn)
@@ -183,11 +195,17 @@ class Database
         // Writes SQL commands to a LOG file (see mangosd.conf "LogSQL")
         bool PExecuteLog(const char* format, ...) ATTR_PRINTF(2, 3);
 
-        bool BeginTransaction();
+        // transactions with the same lane key are executed in order on the same async connection,
+        // different keys may run in parallel when more than one async connection is configured.
+        // A second key orders the transaction against both lanes (writes spanning two characters),
+        // no key orders it against every lane like any other unkeyed async request
+        bool BeginTransaction(uint32 laneKey = 0, uint32 otherLaneKey = 0);
         bool CommitTransaction();
         bool RollbackTransaction();
         // for sync transaction execution
         bool CommitTransactionDirect();
+        // have the outcome of the open transaction reported to state, false if there is none
+        bool ObserveTransaction(SqlTransactionStatePtr const& state);
 
         // PREPARED STATEMENT API
 
@@ -215,6 +233,18 @@ class Database
         // function to ping database connections
         void Ping();
 
+        // pin the sync queries of the calling thread to one query connection (index modulo pool size) of every
+        // Database, so parallel loader threads don't queue on the same connection lock; -1 restores round-robin
+        static void SetThreadQueryConnection(int index) { m_threadQueryConnection = index; }
+
+        // queue an async request on the lane of its key; with a second key it also runs after the earlier
+        // requests of that lane and before its later ones, without key the same holds for every lane
+        bool DelayRequest(SqlOperation* op, uint32 laneKey = 0, uint32 otherLaneKey = 0);
+
+        // async connection lanes, exposed for queue depth / latency metrics
+        uint32 GetAsyncLaneCount() const { return m_asyncLanes.size(); }
+        SqlDelayThread* GetAsyncLaneThread(uint32 index) const { return m_asyncLanes[index].body; }
+
         // set this to allow async transactions
         // you should call it explicitly after your server successfully started up
         // NO ASYNC TRANSACTIONS DURING SERVER STARTUP - ONLY DURING RUNTIME!!!
@@ -223,7 +253,7 @@ class Database
     protected:
         Database() :
             m_nQueryConnPoolSize(1), m_pAsyncConn(nullptr), m_pResultQueue(nullptr),
-            m_threadBody(nullptr), m_delayThread(nullptr), m_allowAsyncTransactions(false),
+            m_threadBody(nullptr), m_allowAsyncTransactions(false),
             m_iStmtIndex(-1), m_logSQL(false), m_pingIntervallms(0)
         {
             m_nQueryCounter = -1;
@@ -234,7 +264,7 @@ class Database
         // factory method to create SqlConnection objects
         virtual SqlConnection* CreateConnection() = 0;
         // factory method to create SqlDelayThread objects
-        virtual SqlDelayThread* CreateDelayThread();
+        virtual SqlDelayThread* CreateDelayThread(SqlConnection* conn, bool pingDatabase);
 
         // per-thread based storage for SqlTransaction object initialization - no locking is required
         boost::thread_specific_ptr<SqlTransaction> m_currentTransaction;
@@ -243,29 +273,40 @@ class Database
 
         // round-robin connection selection
         SqlConnection* getQueryConnection();
-        // for now return one single connection for async requests
+        // connection used for direct (synchronous) execution of async requests
         SqlConnection* getAsyncConnection() const { return m_pAsyncConn; }
-
         friend class SqlStatement;
         // PREPARED STATEMENT API
         // query function for prepared statements
         bool ExecuteStmt(const SqlStatementID& id, SqlStmtParameters* params);
         bool DirectExecuteStmt(const SqlStatementID& id, SqlStmtParameters* params);
+        QueryResult* QueryStmt(const SqlStatementID& id, SqlStmtParameters* params);
 
         // connection helper counters
         int m_nQueryConnPoolSize;                           // current size of query connection pool
         std::atomic_long m_nQueryCounter;  // counter for connection selection
+        static thread_local int m_threadQueryConnection;   // pinned connection of the thread, -1 for round-robin
 
         // lets use pool of connections for sync queries
         typedef std::vector< SqlConnection* > SqlConnectionContainer;
         SqlConnectionContainer m_pQueryConnections;
 
-        // only one single DB connection for transactions
+        // async connections, each drained in order by its own delay thread
+        struct AsyncLane
+        {
+            SqlConnection*  conn;
+            SqlDelayThread* body;                           ///< Pointer to delay sql executer (owned by thread)
+            MaNGOS::Thread* thread;                         ///< Pointer to executer thread
+            std::vector<uint64> after;                      ///< Requests of other lanes the next request here waits for
+        };
+        std::vector<AsyncLane> m_asyncLanes;
+        std::mutex m_asyncLanesOrderLock;                   ///< Keeps the request order consistent across lanes
+
+        // main DB connection for transactions, unkeyed requests and direct execution (lane 0)
         SqlConnection* m_pAsyncConn;
 
         SqlResultQueue*     m_pResultQueue;                 ///< Transaction queues from diff. threads
-        SqlDelayThread*     m_threadBody;                   ///< Pointer to delay sql executer (owned by m_delayThread)
-        MaNGOS::Thread*     m_delayThread;                  ///< Pointer to executer thread
+        SqlDelayThread*     m_threadBody;                   ///< Delay thread of lane 0
 
         std::atomic<bool> m_allowAsyncTransactions;         ///< flag which specifies if async transactions are enabled
 
@@ -240,6 +240,30 @@ QueryNamedResult* MySQLConnection::QueryNamed(const char* sql)
     return new QueryNamedResult(queryResult, names);
 }
 
+QueryResult* MySQLConnection::QueryBinary(const char* sql)
+{
+    if (!mMysql)
+        return nullptr;
+
+    uint32 _s = WorldTimer::getMSTime();
+
+    // one-shot statement, the prepare round trip is paid back by not parsing every column as text
+    MySqlPreparedStatement stmt(sql, *this, mMysql);
+    if (!stmt.prepare())
+        return nullptr;
+
+    if (!stmt.isQuery())
+    {
+        sLog.outErrorDb("SQL: %s", sql);
+        sLog.outErrorDb("query ERROR: statement does not return a result set");
+        return nullptr;
+    }
+
+    QueryResult* result = stmt.query();
+    DEBUG_FILTER_LOG(LOG_FILTER_SQL_TEXT, "[%u ms] SQL: %s", WorldTimer::getMSTimeDiff(_s, WorldTimer::getMSTime()), sql);
+    return result;
+}
+
 bool MySQLConnection::Execute(const char* sql)
 {
     if (!mMysql)
@@ -365,7 +389,9 @@ bool MySqlPreparedStatement::prepare()
         /* Get total columns in the query */
         m_nColumns = mysql_num_fields(m_pResultMetadata);
 
-        // bind output buffers
+        // let mysql_stmt_store_result() compute max_length, string buffers are then sized once per result
+        decltype(MYSQL_BIND::is_null_value) updateMaxLength = 1;
+        mysql_stmt_attr_set(m_stmt, STMT_ATTR_UPDATE_MAX_LENGTH, &updateMaxLength);
     }
 
     m_bPrepared = true;
@@ -461,12 +487,139 @@ bool MySqlPreparedStatement::execute()
     return true;
 }
 
-enum_field_types MySqlPreparedStatement::ToMySQLType(const SqlStmtFieldData& data, bool& bUnsigned)
+QueryResult* MySqlPreparedStatement::query()
+{
+    if (!execute())
+        return nullptr;
+
+    if (mysql_stmt_store_result(m_stmt))
+    {
+        sLog.outError("SQL: cannot store result of '%s'", m_szFmt.c_str());
+        sLog.outError("SQL ERROR: %s", mysql_stmt_error(m_stmt));
+        return nullptr;
+    }
+
+    uint64 rowCount = mysql_stmt_num_rows(m_stmt);
+    if (!rowCount)
+    {
+        mysql_stmt_free_result(m_stmt);
+        return nullptr;
+    }
+
+    // fresh metadata, max_length is only filled once the result is stored
+    MYSQL_RES* metadata = mysql_stmt_result_metadata(m_stmt);
+    MYSQL_FIELD* fields = mysql_fetch_fields(metadata);
+
+    typedef decltype(MYSQL_BIND::is_null_value) BindFlag;
+    std::vector<MYSQL_BIND> binds(m_nColumns);
+    std::vector<SqlStmtField> values(m_nColumns);
+    std::vector<std::vector<char> > strings(m_nColumns);
+    std::vector<unsigned long> lengths(m_nColumns);
+    std::unique_ptr<BindFlag[]> nulls(new BindFlag[m_nColumns]());
+
+    QueryResultBinary* result = new QueryResultBinary(rowCount, m_nColumns);
+    for (uint32 i = 0; i < m_nColumns; ++i)
+    {
+        SqlStmtFieldType type = ToFieldType(fields[i]);
+        result->SetColumnType(i, type, QueryResultMysql::ConvertNativeType(fields[i].type));
+
+        MYSQL_BIND& bind = binds[i];
+        bind.is_null = &nulls[i];
+        bind.length = &lengths[i];
+        if (type == FIELD_STRING)
+        {
+            strings[i].resize(fields[i].max_length + 1);
+            bind.buffer_type = MYSQL_TYPE_STRING;
+            bind.buffer = strings[i].data();
+            bind.buffer_length = strings[i].size();
+        }
+        else
+        {
+            bool bUnsigned;
+            bind.buffer_type = ToMySQLType(type, bUnsigned);
+            bind.is_unsigned = bUnsigned;
+            bind.buffer = &values[i];
+        }
+    }
+
+    mysql_free_result(metadata);
+
+    if (mysql_stmt_bind_result(m_stmt, binds.data()))
+    {
+        sLog.outError("SQL ERROR: mysql_stmt_bind_result() failed for '%s'", m_szFmt.c_str());
+        sLog.outError("SQL ERROR: %s", mysql_stmt_error(m_stmt));
+        mysql_stmt_free_result(m_stmt);
+        delete result;
+        return nullptr;
+    }
+
+    int status;
+    while ((status = mysql_stmt_fetch(m_stmt)) == 0 || status == MYSQL_DATA_TRUNCATED)
+    {
+        bool rebind = false;
+
+        result->AddRow();
+        for (uint32 i = 0; i < m_nColumns; ++i)
+        {
+            if (nulls[i])
+                result->SetNull(i);
+            else if (strings[i].empty())
+                result->SetValue(i, values[i]);
+            else
+            {
+                // max_length is not reported for every column type, fetch again what did not fit
+                if (lengths[i] >= strings[i].size())
+                {
+                    strings[i].resize(lengths[i] + 1);
+                    binds[i].buffer = strings[i].data();
+                    binds[i].buffer_length = strings[i].size();
+                    mysql_stmt_fetch_column(m_stmt, &binds[i], i, 0);
+                    rebind = true;
+                }
+
+                result->SetString(i, strings[i].data(), lengths[i]);
+            }
+        }
+
+        if (rebind)
+            mysql_stmt_bind_result(m_stmt, binds.data());
+    }
+
+    if (status != MYSQL_NO_DATA)
+    {
+        sLog.outError("SQL: error fetching rows of '%s'", m_szFmt.c_str());
+        sLog.outError("SQL ERROR: %s", mysql_stmt_error(m_stmt));
+    }
+
+    mysql_stmt_free_result(m_stmt);
+
+    result->NextRow();
+    return result;
+}
+
+SqlStmtFieldType MySqlPreparedStatement::ToFieldType(MYSQL_FIELD const& field)
+{
+    bool const bUnsigned = (field.flags & UNSIGNED_FLAG) != 0;
+
+    switch (field.type)
+    {
+        case MYSQL_TYPE_TINY:       return bUnsigned ? FIELD_UI8 : FIELD_I8;
+        case MYSQL_TYPE_SHORT:      return bUnsigned ? FIELD_UI16 : FIELD_I16;
+        case MYSQL_TYPE_INT24:
+        case MYSQL_TYPE_LONG:       return bUnsigned ? FIELD_UI32 : FIELD_I32;
+        case MYSQL_TYPE_LONGLONG:   return bUnsigned ? FIELD_UI64 : FIELD_I64;
+        case MYSQL_TYPE_FLOAT:      return FIELD_FLOAT;
+        case MYSQL_TYPE_DOUBLE:     return FIELD_DOUBLE;
+        default:                    return FIELD_STRING;
+    }
+}
+
+enum_field_types MySqlPreparedStatement::ToMySQLType(SqlStmtFieldType type, bool& bUnsigned)
 {
     bUnsigned = 0;
     enum_field_types dataType = MYSQL_TYPE_NULL;
 
-    switch (data.type())
+    switch (type)
     {
         case FIELD_NONE:    dataType = MYSQL_TYPE_NULL;                     break;
         // MySQL does not support MYSQL_TYPE_BIT as input type
@@ -43,11 +43,17 @@ class MySqlPreparedStatement : public SqlPreparedStatement
         // execute DML statement
         virtual bool execute() override;
 
+        // execute SELECT statement and copy the binary rows into a QueryResultBinary
+        virtual QueryResult* query() override;
+
     protected:
         // bind parameters
         void addParam(unsigned int nIndex, const SqlStmtFieldData& data);
 
-        static enum_field_types ToMySQLType(const SqlStmtFieldData& data, bool& bUnsigned);
+        static enum_field_types ToMySQLType(const SqlStmtFieldData& data, bool& bUnsigned) { return ToMySQLType(data.type(), bUnsigned); }
+        static enum_field_types ToMySQLType(SqlStmtFieldType type, bool& bUnsigned);
+        // storage type of a result column, everything without a fixed width native type is kept as string
+        static SqlStmtFieldType ToFieldType(MYSQL_FIELD const& field);
 
     private:
         void RemoveBinds();
@@ -71,6 +77,7 @@ class MySQLConnection : public SqlConnection
 
         QueryResult* Query(const char* sql) override;
         QueryNamedResult* QueryNamed(const char* sql) override;
+        QueryResult* QueryBinary(const char* sql) override;
         bool Execute(const char* sql) override;
 
         unsigned long escape_string(char* to, const char* from, unsigned long length);
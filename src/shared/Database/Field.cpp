@@ -18,6 +18,7 @@
 
 //#include "DatabaseEnv.h"
 #include "Field.h"
+#include "SqlPreparedStatement.h"
 
 #include <iomanip>
 
@@ -29,3 +30,80 @@ time_t Field::GetTime() const
     ss >> std::get_time(&tm, "%Y-%m-%d %H:%M:%S");
     return std::mktime(&tm);
 }
+
+int64 Field::GetBinaryInt64() const
+{
+    switch (mBinaryType)
+    {
+        case FIELD_BOOL:
+        case FIELD_UI8:     return mBinary->ui8;
+        case FIELD_I8:      return mBinary->i8;
+        case FIELD_UI16:    return mBinary->ui16;
+        case FIELD_I16:     return mBinary->i16;
+        case FIELD_UI32:    return mBinary->ui32;
+        case FIELD_I32:     return mBinary->i32;
+        case FIELD_UI64:    return static_cast<int64>(mBinary->ui64);
+        case FIELD_I64:     return mBinary->i64;
+        case FIELD_FLOAT:
+        case FIELD_DOUBLE:
+        {
+            // converting an out of range float is undefined, NaN included
+            double value = mBinary->d;
+            if (mBinaryType == FIELD_FLOAT)
+                value = mBinary->f;
+            if (!(value > -9.2e18 && value < 9.2e18))
+                return 0;
+            return static_cast<int64>(value);
+        }
+        default:            return 0;
+    }
+}
+
+uint64 Field::GetBinaryUInt64() const
+{
+    if (mBinaryType == FIELD_UI64)
+        return mBinary->ui64;
+    return static_cast<uint64>(GetBinaryInt64());
+}
+
+double Field::GetBinaryDouble() const
+{
+    switch (mBinaryType)
+    {
+        case FIELD_FLOAT:   return mBinary->f;
+        case FIELD_DOUBLE:  return mBinary->d;
+        case FIELD_UI64:    return static_cast<double>(mBinary->ui64);
+        default:            return static_cast<double>(GetBinaryInt64());
+    }
+}
+
+void Field::BinaryToString(char* buffer, size_t size) const
+{
+    switch (mBinaryType)
+    {
+        case FIELD_BOOL:
+        case FIELD_UI8:     snprintf(buffer, size, "%u", uint32(mBinary->ui8));       break;
+        case FIELD_I8:      snprintf(buffer, size, "%i", int32(mBinary->i8));         break;
+        case FIELD_UI16:    snprintf(buffer, size, "%u", uint32(mBinary->ui16));      break;
+        case FIELD_I16:     snprintf(buffer, size, "%i", int32(mBinary->i16));        break;
+        case FIELD_UI32:    snprintf(buffer, size, "%u", mBinary->ui32);              break;
+        case FIELD_I32:     snprintf(buffer, size, "%i", mBinary->i32);               break;
+        case FIELD_UI64:    snprintf(buffer, size, UI64FMTD, mBinary->ui64);          break;
+        case FIELD_I64:     snprintf(buffer, size, SI64FMTD, mBinary->i64);           break;
+        case FIELD_FLOAT:   snprintf(buffer, size, "%.9g", mBinary->f);               break;
+        case FIELD_DOUBLE:  snprintf(buffer, size, "%.17g", mBinary->d);              break;
+        default:            buffer[0] = '\0';                                         break;
+    }
+}
+
+const char* Field::BinaryToString() const
+{
+    // a few thread local buffers instead of one per Field, so several GetString() results can be used in one call
+    static uint32 const BUFFER_COUNT = 8;
+    thread_local char buffers[BUFFER_COUNT][32];
+    thread_local uint32 next = 0;
+
+    char* buffer = buffers[next++ % BUFFER_COUNT];
+    BinaryToString(buffer, sizeof(buffers[0]));
+    return buffer;
+}
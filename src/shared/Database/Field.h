@@ -21,6 +21,8 @@
 
 #include "Common.h"
 
+union SqlStmtField;
+
 class Field
 {
     public:
@@ -34,31 +36,42 @@ class Field
             DB_TYPE_BOOL    = 0x04
         };
 
-        Field() : mValue(nullptr), mType(DB_TYPE_UNKNOWN) {}
-        Field(const char* value, enum DataTypes type) : mValue(value), mType(type) {}
+        Field() : mValue(nullptr), mBinary(nullptr), mType(DB_TYPE_UNKNOWN), mBinaryType(0) {}
+        Field(const char* value, enum DataTypes type) : mValue(value), mBinary(nullptr), mType(type), mBinaryType(0) {}
 
         ~Field() {}
 
         enum DataTypes GetType() const { return mType; }
-        bool IsNULL() const { return mValue == nullptr; }
+        bool IsNULL() const { return mValue == nullptr && mBinary == nullptr; }
 
         const char* GetString() const
         {
+            if (mBinary)
+                return BinaryToString();
             return mValue ? mValue : ""; // We need this null check as we do not always null check what we get back from the database everywhere
         }
         std::string GetCppString() const
         {
+            if (mBinary)
+            {
+                char buffer[32];
+                BinaryToString(buffer, sizeof(buffer));
+                return buffer;
+            }
             return mValue ? mValue : "";                    // std::string s = 0 have undefine result in C++
         }
-        float GetFloat() const { return mValue ? static_cast<float>(atof(mValue)) : 0.0f; }
-        bool GetBool() const { return mValue ? atoi(mValue) > 0 : false; }
-        int32 GetInt32() const { return mValue ? static_cast<int32>(atol(mValue)) : int32(0); }
-        uint8 GetUInt8() const { return mValue ? static_cast<uint8>(atol(mValue)) : uint8(0); }
-        uint16 GetUInt16() const { return mValue ? static_cast<uint16>(atol(mValue)) : uint16(0); }
-        int16 GetInt16() const { return mValue ? static_cast<int16>(atol(mValue)) : int16(0); }
-        uint32 GetUInt32() const { return mValue ? static_cast<uint32>(atoll(mValue)) : uint32(0); }
+        float GetFloat() const { return mBinary ? static_cast<float>(GetBinaryDouble()) : mValue ? static_cast<float>(atof(mValue)) : 0.0f; }
+        bool GetBool() const { return mBinary ? GetBinaryInt64() > 0 : mValue ? atoi(mValue) > 0 : false; }
+        int32 GetInt32() const { return mBinary ? static_cast<int32>(GetBinaryInt64()) : mValue ? static_cast<int32>(atol(mValue)) : int32(0); }
+        uint8 GetUInt8() const { return mBinary ? static_cast<uint8>(GetBinaryInt64()) : mValue ? static_cast<uint8>(atol(mValue)) : uint8(0); }
+        uint16 GetUInt16() const { return mBinary ? static_cast<uint16>(GetBinaryInt64()) : mValue ? static_cast<uint16>(atol(mValue)) : uint16(0); }
+        int16 GetInt16() const { return mBinary ? static_cast<int16>(GetBinaryInt64()) : mValue ? static_cast<int16>(atol(mValue)) : int16(0); }
+        uint32 GetUInt32() const { return mBinary ? static_cast<uint32>(GetBinaryInt64()) : mValue ? static_cast<uint32>(atoll(mValue)) : uint32(0); }
         uint64 GetUInt64() const
         {
+            if (mBinary)
+                return GetBinaryUInt64();
+
             uint64 value = 0;
             if (!mValue || sscanf(mValue, UI64FMTD, &value) == -1)
                 return 0;
@@ -70,13 +83,26 @@ class Field
         void SetType(enum DataTypes type) { mType = type; }
         // no need for memory allocations to store resultset field strings
         // all we need is to cache pointers returned by different DBMS APIs
-        void SetValue(const char* value) { mValue = value; }
+        void SetValue(const char* value) { mValue = value; mBinary = nullptr; }
+        // binary protocol results: point at the fixed width cell of the row, no text parsing on read
+        // type is a SqlStmtFieldType
+        void SetBinaryValue(SqlStmtField const* value, uint8 type) { mBinary = value; mBinaryType = type; mValue = nullptr; }
 
     private:
         Field(Field const&);
         Field& operator=(Field const&);
 
+        // binary cells widened to the largest type of their kind, floats are truncated like atol does on the text path
+        int64 GetBinaryInt64() const;
+        uint64 GetBinaryUInt64() const;
+        double GetBinaryDouble() const;
+        // text form of a binary numeric, for callers reading numbers as strings
+        void BinaryToString(char* buffer, size_t size) const;
+        const char* BinaryToString() const;
+
         const char* mValue;
+        SqlStmtField const* mBinary;
         enum DataTypes mType;
+        uint8 mBinaryType;
 };
 #endif
@@ -0,0 +1,94 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "DatabaseEnv.h"
+#include "QueryResultBinary.h"
+
+QueryResultBinary::QueryResultBinary(uint64 expectedRows, uint32 fieldCount) :
+    QueryResult(0, fieldCount), m_columnTypes(fieldCount, FIELD_STRING), m_nextRow(0)
+{
+    mCurrentRow = new Field[mFieldCount];
+
+    m_cells.reserve(expectedRows * mFieldCount);
+    m_nulls.reserve(expectedRows * mFieldCount);
+}
+
+QueryResultBinary::~QueryResultBinary()
+{
+    EndQuery();
+}
+
+void QueryResultBinary::SetColumnType(uint32 index, SqlStmtFieldType binaryType, enum Field::DataTypes type)
+{
+    m_columnTypes[index] = binaryType;
+    mCurrentRow[index].SetType(type);
+}
+
+void QueryResultBinary::AddRow()
+{
+    SqlStmtField empty;
+    empty.ui64 = 0;
+    m_cells.resize(m_cells.size() + mFieldCount, empty);
+    m_nulls.resize(m_nulls.size() + mFieldCount, 0);
+    ++mRowCount;
+}
+
+void QueryResultBinary::SetString(uint32 index, char const* data, size_t length)
+{
+    SqlStmtField offset;
+    offset.ui64 = m_strings.size();
+    m_strings.insert(m_strings.end(), data, data + length);
+    m_strings.push_back('\0');
+    SetValue(index, offset);
+}
+
+bool QueryResultBinary::NextRow()
+{
+    if (!mCurrentRow)
+        return false;
+
+    if (m_nextRow >= mRowCount)
+    {
+        EndQuery();
+        return false;
+    }
+
+    size_t const first = m_nextRow * mFieldCount;
+    for (uint32 i = 0; i < mFieldCount; ++i)
+    {
+        if (m_nulls[first + i])
+            mCurrentRow[i].SetValue(nullptr);
+        else if (m_columnTypes[i] == FIELD_STRING)
+            mCurrentRow[i].SetValue(&m_strings[m_cells[first + i].ui64]);
+        else
+            mCurrentRow[i].SetBinaryValue(&m_cells[first + i], m_columnTypes[i]);
+    }
+
+    ++m_nextRow;
+    return true;
+}
+
+void QueryResultBinary::EndQuery()
+{
+    delete[] mCurrentRow;
+    mCurrentRow = nullptr;
+
+    std::vector<SqlStmtField>().swap(m_cells);
+    std::vector<uint8>().swap(m_nulls);
+    std::vector<char>().swap(m_strings);
+}
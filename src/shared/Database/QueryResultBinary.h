@@ -0,0 +1,60 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef QUERYRESULTBINARY_H
+#define QUERYRESULTBINARY_H
+
+#include "Common.h"
+#include "QueryResult.h"
+#include "SqlPreparedStatement.h"
+
+#include <vector>
+
+/**
+ * Result set fetched over a binary protocol (prepared statements).
+ * Rows are kept in one row-major arena of fixed width cells so numeric columns are read
+ * back without any text conversion; strings live in a separate buffer and the cell keeps their offset.
+ * The DBMS driver fills the arena with AddRow()/Set*() and calls NextRow() once when done.
+ */
+class QueryResultBinary : public QueryResult
+{
+    public:
+        QueryResultBinary(uint64 expectedRows, uint32 fieldCount);
+        ~QueryResultBinary();
+
+        bool NextRow() override;
+
+        // column description, FIELD_STRING columns are stored as text
+        void SetColumnType(uint32 index, SqlStmtFieldType binaryType, enum Field::DataTypes type);
+
+        // append an empty row, following calls fill its cells
+        void AddRow();
+        void SetNull(uint32 index) { m_nulls[m_cells.size() - mFieldCount + index] = 1; }
+        void SetValue(uint32 index, SqlStmtField const& value) { m_cells[m_cells.size() - mFieldCount + index] = value; }
+        void SetString(uint32 index, char const* data, size_t length);
+
+    private:
+        void EndQuery();
+
+        std::vector<SqlStmtFieldType> m_columnTypes;
+        std::vector<SqlStmtField> m_cells;
+        std::vector<uint8> m_nulls;
+        std::vector<char> m_strings;
+        uint64 m_nextRow;
+};
+#endif
@@ -30,7 +30,8 @@ SQLStorageBase::SQLStorageBase() :
     m_recordCount(0),
     m_maxEntry(0),
     m_recordSize(0),
-    m_data(nullptr)
+    m_data(nullptr),
+    m_stringPool(nullptr)
 {}
 
 void SQLStorageBase::Initialize(const char* tableName, const char* entry_field, const char* src_format, const char* dst_format)
@@ -81,8 +82,9 @@ void SQLStorageBase::Free()
                 break;
             case FT_STRING:
             {
-                for (uint32 recordItr = 0; recordItr < m_recordCount; ++recordItr)
-                    delete[] *(char**)((char*)(m_data + (recordItr * m_recordSize)) + offset);
+                if (!m_stringPool)
+                    for (uint32 recordItr = 0; recordItr < m_recordCount; ++recordItr)
+                        delete[] *(char**)((char*)(m_data + (recordItr * m_recordSize)) + offset);
 
                 offset += sizeof(char*);
                 break;
@@ -117,6 +119,8 @@ void SQLStorageBase::Free()
     }
     delete[] m_data;
     m_data = nullptr;
+    delete[] m_stringPool;
+    m_stringPool = nullptr;
     m_recordCount = 0;
 }
 
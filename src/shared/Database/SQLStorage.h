@@ -22,10 +22,12 @@
 #include "Common.h"
 #include "Database/DatabaseEnv.h"
 #include "DBCFileLoader.h"
+#include "Database/SQLStorageSnapshot.h"
 
 class SQLStorageBase
 {
         template<class DerivedLoader, class StorageClass> friend class SQLStorageLoaderBase;
+        friend class SQLStorageSnapshot;
 
     public:
         char const* GetTableName() const { return m_tableName; }
@@ -76,6 +78,7 @@ class SQLStorageBase
 
         virtual void prepareToLoad(uint32 maxEntry, uint32 recordCount, uint32 recordSize);
         virtual void JustCreatedRecord(uint32 recordId, char* record) = 0;
+        virtual bool AllowsDuplicateEntries() const { return false; }
         virtual void Free();
 
     private:
@@ -96,6 +99,7 @@ class SQLStorageBase
 
         // Data Storage
         char* m_data;
+        char* m_stringPool;                                 // strings of records loaded from a snapshot
 };
 
 class SQLStorage : public SQLStorageBase
@@ -237,6 +241,7 @@ class SQLMultiStorage : public SQLStorageBase
         {
             m_indexMultiMap.insert(RecordMultiMap::value_type(recordId, record));
         }
+        bool AllowsDuplicateEntries() const override { return true; }
 
         void Free() override;
 
@@ -264,6 +269,10 @@ class SQLStorageLoaderBase
         void default_fill(uint32 field_pos, S src, D& dst);
         void default_fill_to_str(uint32 field_pos, char const* src, char*& dst);
 
+        // loaders whose conversions depend on runtime state not kept in the snapshot must not be loaded from one,
+        // string sources converted by convert_from_str (script names) are stored and converted again on load
+        bool IsSnapshotSafe() const { return true; }
+
         // trap, no body
         template<class D>
         void convert_from_str(uint32 field_pos, char* src, D& dst);
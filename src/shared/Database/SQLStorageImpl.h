@@ -213,6 +213,32 @@ void SQLStorageLoaderBase<DerivedLoader, StorageClass>::storeValue(char const* v
 template<class DerivedLoader, class StorageClass>
 void SQLStorageLoaderBase<DerivedLoader, StorageClass>::Load(StorageClass& store, bool error_at_empty /*= true*/)
 {
+    uint64 checksum = 0;
+    bool useSnapshot = SQLStorageSnapshot::IsEnabled() && static_cast<DerivedLoader*>(this)->IsSnapshotSafe() &&
+                       SQLStorageSnapshot::GetTableChecksum(store.GetTableName(), checksum);
+
+    std::vector<SQLStorageSnapshot::SourceStringField> sourceStringFields;
+    if (useSnapshot)
+    {
+        SQLStorageSnapshot::GetSourceStringFields(store, sourceStringFields);
+
+        std::vector<char const*> snapshotStrings;
+        if (SQLStorageSnapshot::Load(store, checksum, snapshotStrings))
+        {
+            // convert the source strings (script names...) like the database load does
+            for (uint32 i = 0; i < store.GetRecordCount(); ++i)
+            {
+                char* record = store.m_data + size_t(i) * store.GetRecordSize();
+                for (size_t k = 0; k < sourceStringFields.size(); ++k)
+                {
+                    uint32 offset = sourceStringFields[k].offset;
+                    storeValue(snapshotStrings[i * sourceStringFields.size() + k], store, record, sourceStringFields[k].dstField, offset);
+                }
+            }
+            return;
+        }
+    }
+
     Field* fields = nullptr;
     QueryResult* result  = WorldDatabase.PQuery("SELECT MAX(%s) FROM %s", store.EntryFieldName(), store.GetTableName());
     if (!result)
@@ -235,7 +261,7 @@ void SQLStorageLoaderBase<DerivedLoader, StorageClass>::Load(StorageClass& store
         delete result;
     }
 
-    result = WorldDatabase.PQuery("SELECT * FROM %s", store.GetTableName());
+    result = WorldDatabase.PQueryBinary("SELECT * FROM %s", store.GetTableName());
 
     if (!result)
     {
@@ -296,6 +322,14 @@ void SQLStorageLoaderBase<DerivedLoader, StorageClass>::Load(StorageClass& store
     // Prepare data storage and lookup storage
     store.prepareToLoad(maxRecordId, recordCount, recordsize);
 
+    std::vector<uint32> recordIds;
+    std::vector<std::string> sourceStrings;
+    if (useSnapshot)
+    {
+        recordIds.reserve(recordCount);
+        sourceStrings.reserve(size_t(recordCount) * sourceStringFields.size());
+    }
+
     BarGoLink bar(recordCount);
     do
     {
@@ -305,6 +339,16 @@ void SQLStorageLoaderBase<DerivedLoader, StorageClass>::Load(StorageClass& store
         char* record = store.createRecord(fields[0].GetUInt32());
         offset = 0;
 
+        if (useSnapshot)
+        {
+            recordIds.push_back(fields[0].GetUInt32());
+            for (auto const& field : sourceStringFields)
+            {
+                char const* str = fields[field.srcField].GetString();
+                sourceStrings.push_back(str ? str : "");
+            }
+        }
+
         // dependend on dest-size
         // iterate two indexes: x over dest, y over source
         //                      y++ If and only If x != FT_NA*
@@ -353,6 +397,9 @@ void SQLStorageLoaderBase<DerivedLoader, StorageClass>::Load(StorageClass& store
     while (result->NextRow());
 
     delete result;
+
+    if (useSnapshot)
+        SQLStorageSnapshot::Save(store, checksum, recordIds, sourceStrings);
 }
 
 #endif
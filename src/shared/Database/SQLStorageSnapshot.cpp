@@ -0,0 +1,390 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Database/SQLStorageSnapshot.h"
+#include "Database/SQLStorage.h"
+#include "Log.h"
+
+#include <algorithm>
+#include <cstdio>
+
+std::string SQLStorageSnapshot::m_directory;
+
+namespace
+{
+    uint32 const SNAPSHOT_MAGIC   = 0x534C5153;            // 'SQLS'
+    uint32 const SNAPSHOT_VERSION = 2;
+
+    struct SnapshotHeader
+    {
+        uint32 magic;
+        uint32 version;
+        uint32 pointerSize;
+        uint32 srcFieldCount;
+        uint32 dstFieldCount;
+        uint32 maxEntry;
+        uint32 recordCount;
+        uint32 recordSize;
+        uint32 stringPoolSize;
+        uint32 sourceStringCount;                           // source string fields per record
+        uint64 checksum;                                    // table checksum reported by the database
+        uint64 contentChecksum;                             // FNV-1a of everything following the header
+    };
+
+    uint64 const FNV_OFFSET_BASIS = 14695981039346656037ULL;
+    uint64 const FNV_PRIME        = 1099511628211ULL;
+
+    void UpdateChecksum(uint64& hash, void const* data, size_t size)
+    {
+        uint8 const* bytes = static_cast<uint8 const*>(data);
+        for (size_t i = 0; i < size; ++i)
+            hash = (hash ^ bytes[i]) * FNV_PRIME;
+    }
+
+    bool ReadBlock(FILE* f, void* dst, size_t size, uint64& hash)
+    {
+        if (size != 0 && fread(dst, size, 1, f) != 1)
+            return false;
+
+        UpdateChecksum(hash, dst, size);
+        return true;
+    }
+
+    bool WriteBlock(FILE* f, void const* src, size_t size)
+    {
+        return size == 0 || fwrite(src, size, 1, f) == 1;
+    }
+}
+
+bool SQLStorageSnapshot::GetTableChecksum(char const* table, uint64& checksum)
+{
+#ifdef DO_POSTGRESQL
+    // no table checksum available, always load from the database
+    (void)table;
+    (void)checksum;
+    return false;
+#else
+    QueryResult* result = WorldDatabase.PQuery("CHECKSUM TABLE %s", table);
+    if (!result)
+        return false;
+
+    Field* fields = result->Fetch();
+    bool found = !fields[1].IsNULL();
+    if (found)
+        checksum = fields[1].GetUInt64();
+
+    delete result;
+    return found;
+#endif
+}
+
+std::string SQLStorageSnapshot::GetFileName(SQLStorageBase const& store)
+{
+    return m_directory + store.GetTableName() + ".sqlsnapshot";
+}
+
+uint32 SQLStorageSnapshot::GetRecordLayout(SQLStorageBase const& store, std::vector<uint32>& fieldOffsets, std::vector<uint32>& stringOffsets)
+{
+    uint32 offset = 0;
+    for (uint32 x = 0; x < store.GetDstFieldCount(); ++x)
+    {
+        fieldOffsets.push_back(offset);
+        switch (store.GetDstFormat(x))
+        {
+            case FT_LOGIC:
+                offset += sizeof(bool);   break;
+            case FT_BYTE:
+            case FT_NA_BYTE:
+                offset += sizeof(char);   break;
+            case FT_INT:
+            case FT_NA:
+                offset += sizeof(uint32); break;
+            case FT_FLOAT:
+            case FT_NA_FLOAT:
+                offset += sizeof(float);  break;
+            case FT_STRING:
+            case FT_NA_POINTER:
+                stringOffsets.push_back(offset);
+                offset += sizeof(char*);  break;
+            case FT_64BITINT:
+                offset += sizeof(uint64); break;
+            default:
+                assert(false && "unknown format character");
+                break;
+        }
+    }
+    return offset;
+}
+
+void SQLStorageSnapshot::GetSourceStringFields(SQLStorageBase const& store, std::vector<SourceStringField>& fields)
+{
+    std::vector<uint32> fieldOffsets;
+    std::vector<uint32> stringOffsets;
+    GetRecordLayout(store, fieldOffsets, stringOffsets);
+
+    // same walk as the database load: x over dest, y over source, default filled dest fields have no source
+    for (uint32 x = 0, y = 0; x < store.GetDstFieldCount() && y < store.GetSrcFieldCount();)
+    {
+        switch (store.GetDstFormat(x))
+        {
+            case FT_NA:
+            case FT_NA_BYTE:
+            case FT_NA_FLOAT:
+            case FT_NA_POINTER:
+                ++x;
+                continue;
+            default:
+                break;
+        }
+
+        switch (store.GetSrcFormat(y))
+        {
+            case FT_NA:
+            case FT_NA_BYTE:
+            case FT_NA_FLOAT:
+                break;
+            case FT_STRING:
+                if (store.GetDstFormat(x) != FT_STRING)
+                    fields.push_back({ y, x, fieldOffsets[x] });
+                ++x;
+                break;
+            default:
+                ++x;
+                break;
+        }
+        ++y;
+    }
+}
+
+bool SQLStorageSnapshot::Load(SQLStorageBase& store, uint64 checksum, std::vector<char const*>& sourceStrings)
+{
+    std::string fileName = GetFileName(store);
+    FILE* f = fopen(fileName.c_str(), "rb");
+    if (!f)
+        return false;
+
+    std::vector<uint32> fieldOffsets;
+    std::vector<uint32> stringOffsets;
+    uint32 recordSize = GetRecordLayout(store, fieldOffsets, stringOffsets);
+    std::vector<SourceStringField> sourceStringFields;
+    GetSourceStringFields(store, sourceStringFields);
+
+    SnapshotHeader header;
+    uint64 headerHash = FNV_OFFSET_BASIS;
+    bool valid = ReadBlock(f, &header, sizeof(header), headerHash) &&
+                 header.magic == SNAPSHOT_MAGIC && header.version == SNAPSHOT_VERSION &&
+                 header.pointerSize == sizeof(char*) && header.checksum == checksum &&
+                 header.srcFieldCount == store.GetSrcFieldCount() && header.dstFieldCount == store.GetDstFieldCount() &&
+                 header.recordSize == recordSize && header.sourceStringCount == sourceStringFields.size();
+
+    // the blocks must fill the file exactly before anything is allocated from header sizes
+    size_t const sourceStringSize = size_t(header.recordCount) * header.sourceStringCount * sizeof(uint32);
+    size_t const dataSize = size_t(header.recordCount) * header.recordSize;
+    if (valid)
+    {
+        size_t expectedSize = sizeof(header) + header.srcFieldCount + header.dstFieldCount +
+                              size_t(header.recordCount) * sizeof(uint32) + sourceStringSize + dataSize + header.stringPoolSize;
+        valid = fseek(f, 0, SEEK_END) == 0 && ftell(f) == long(expectedSize) && fseek(f, sizeof(header), SEEK_SET) == 0;
+    }
+
+    uint64 contentHash = FNV_OFFSET_BASIS;
+    std::string srcFormat(store.GetSrcFieldCount(), '\0');
+    std::string dstFormat(store.GetDstFieldCount(), '\0');
+    valid = valid &&
+            ReadBlock(f, &srcFormat[0], srcFormat.size(), contentHash) && srcFormat == store.GetSrcFormat() &&
+            ReadBlock(f, &dstFormat[0], dstFormat.size(), contentHash) && dstFormat == store.GetDstFormat();
+
+    std::vector<uint32> recordIds;
+    if (valid)
+    {
+        recordIds.resize(header.recordCount);
+        valid = ReadBlock(f, recordIds.data(), recordIds.size() * sizeof(uint32), contentHash);
+    }
+
+    // every id must fit the index of the storage, and only multi storages may hold an id more than once
+    for (uint32 i = 0; valid && i < header.recordCount; ++i)
+        valid = recordIds[i] < header.maxEntry;
+
+    if (valid && !store.AllowsDuplicateEntries())
+    {
+        std::vector<uint32> sortedIds(recordIds);
+        std::sort(sortedIds.begin(), sortedIds.end());
+        valid = std::adjacent_find(sortedIds.begin(), sortedIds.end()) == sortedIds.end();
+    }
+
+    if (!valid)
+    {
+        fclose(f);
+        sLog.outString("Snapshot of %s table is outdated, loading from database", store.GetTableName());
+        return false;
+    }
+
+    std::vector<uint32> sourceStringOffsets(size_t(header.recordCount) * header.sourceStringCount);
+    char* stringPool = new char[header.stringPoolSize + 1];
+
+    // records are read straight into the storage block, the index is only built once everything is verified
+    store.prepareToLoad(header.maxEntry, header.recordCount, header.recordSize);
+
+    valid = ReadBlock(f, sourceStringOffsets.data(), sourceStringSize, contentHash) &&
+            ReadBlock(f, store.m_data, dataSize, contentHash) &&
+            ReadBlock(f, stringPool, header.stringPoolSize, contentHash) &&
+            contentHash == header.contentChecksum;
+    fclose(f);
+    stringPool[header.stringPoolSize] = '\0';
+
+    for (uint32 i = 0; valid && i < header.recordCount; ++i)
+    {
+        char* record = store.m_data + size_t(i) * header.recordSize;
+        for (uint32 offset : stringOffsets)
+        {
+            // stored as pool offset + 1, 0 for null strings
+            uintptr_t poolOffset;
+            memcpy(&poolOffset, record + offset, sizeof(poolOffset));
+            if (poolOffset > header.stringPoolSize)
+            {
+                valid = false;
+                break;
+            }
+
+            char* str = poolOffset ? stringPool + poolOffset - 1 : nullptr;
+            memcpy(record + offset, &str, sizeof(str));
+        }
+    }
+
+    sourceStrings.clear();
+    sourceStrings.reserve(sourceStringOffsets.size());
+    for (uint32 poolOffset : sourceStringOffsets)
+    {
+        if (!valid || poolOffset > header.stringPoolSize)
+        {
+            valid = false;
+            break;
+        }
+        sourceStrings.push_back(poolOffset ? stringPool + poolOffset - 1 : nullptr);
+    }
+
+    if (!valid)
+    {
+        delete[] stringPool;
+        sourceStrings.clear();
+        // nothing was indexed yet, the following database load overwrites the block
+        sLog.outError("Snapshot %s is corrupted, loading %s table from database", fileName.c_str(), store.GetTableName());
+        return false;
+    }
+
+    store.m_stringPool = stringPool;
+    for (uint32 i = 0; i < header.recordCount; ++i)
+        store.createRecord(recordIds[i]);
+
+    sLog.outString(">> Loaded %u records of %s table from snapshot", header.recordCount, store.GetTableName());
+    return true;
+}
+
+void SQLStorageSnapshot::Save(SQLStorageBase const& store, uint64 checksum, std::vector<uint32> const& recordIds,
+                              std::vector<std::string> const& sourceStrings)
+{
+    MANGOS_ASSERT(recordIds.size() == store.GetRecordCount());
+
+    std::vector<uint32> fieldOffsets;
+    std::vector<uint32> stringOffsets;
+    GetRecordLayout(store, fieldOffsets, stringOffsets);
+    std::vector<SourceStringField> sourceStringFields;
+    GetSourceStringFields(store, sourceStringFields);
+    MANGOS_ASSERT(sourceStrings.size() == size_t(store.GetRecordCount()) * sourceStringFields.size());
+
+    size_t dataSize = size_t(store.GetRecordCount()) * store.GetRecordSize();
+    std::vector<char> records(store.m_data, store.m_data + dataSize);
+    std::string stringPool;
+
+    for (uint32 i = 0; i < store.GetRecordCount(); ++i)
+    {
+        char* record = records.data() + size_t(i) * store.GetRecordSize();
+        for (uint32 offset : stringOffsets)
+        {
+            char const* str;
+            memcpy(&str, record + offset, sizeof(str));
+
+            uintptr_t poolOffset = 0;
+            if (str)
+            {
+                poolOffset = stringPool.size() + 1;
+                stringPool.append(str, strlen(str) + 1);
+            }
+            memcpy(record + offset, &poolOffset, sizeof(poolOffset));
+        }
+    }
+
+    // values converted from source strings are stored as is but converted again at load
+
+    std::vector<uint32> sourceStringOffsets;
+    sourceStringOffsets.reserve(sourceStrings.size());
+    for (std::string const& str : sourceStrings)
+    {
+        sourceStringOffsets.push_back(stringPool.size() + 1);
+        stringPool.append(str.c_str(), str.size() + 1);
+    }
+
+    SnapshotHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic = SNAPSHOT_MAGIC;
+    header.version = SNAPSHOT_VERSION;
+    header.pointerSize = sizeof(char*);
+    header.srcFieldCount = store.GetSrcFieldCount();
+    header.dstFieldCount = store.GetDstFieldCount();
+    header.maxEntry = store.GetMaxEntry();
+    header.recordCount = store.GetRecordCount();
+    header.recordSize = store.GetRecordSize();
+    header.stringPoolSize = stringPool.size();
+    header.sourceStringCount = sourceStringFields.size();
+    header.checksum = checksum;
+
+    uint64 contentHash = FNV_OFFSET_BASIS;
+    UpdateChecksum(contentHash, store.GetSrcFormat(), header.srcFieldCount);
+    UpdateChecksum(contentHash, store.GetDstFormat(), header.dstFieldCount);
+    UpdateChecksum(contentHash, recordIds.data(), recordIds.size() * sizeof(uint32));
+    UpdateChecksum(contentHash, sourceStringOffsets.data(), sourceStringOffsets.size() * sizeof(uint32));
+    UpdateChecksum(contentHash, records.data(), records.size());
+    UpdateChecksum(contentHash, stringPool.data(), stringPool.size());
+    header.contentChecksum = contentHash;
+
+    // write to a temporary file first so a crash never leaves a truncated snapshot behind
+    std::string fileName = GetFileName(store);
+    std::string tmpName = fileName + ".tmp";
+    FILE* f = fopen(tmpName.c_str(), "wb");
+    if (!f)
+    {
+        sLog.outError("Can't create snapshot file %s", tmpName.c_str());
+        return;
+    }
+
+    bool written = WriteBlock(f, &header, sizeof(header)) &&
+                   WriteBlock(f, store.GetSrcFormat(), header.srcFieldCount) &&
+                   WriteBlock(f, store.GetDstFormat(), header.dstFieldCount) &&
+                   WriteBlock(f, recordIds.data(), recordIds.size() * sizeof(uint32)) &&
+                   WriteBlock(f, sourceStringOffsets.data(), sourceStringOffsets.size() * sizeof(uint32)) &&
+                   WriteBlock(f, records.data(), records.size()) &&
+                   WriteBlock(f, stringPool.data(), stringPool.size());
+    written = fclose(f) == 0 && written;
+
+    std::remove(fileName.c_str());
+    if (!written || std::rename(tmpName.c_str(), fileName.c_str()) != 0)
+    {
+        sLog.outError("Can't write snapshot file %s", fileName.c_str());
+        std::remove(tmpName.c_str());
+    }
+}
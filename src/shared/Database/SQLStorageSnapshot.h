@@ -0,0 +1,73 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef SQLSTORAGESNAPSHOT_H
+#define SQLSTORAGESNAPSHOT_H
+
+#include "Common.h"
+
+#include <string>
+#include <vector>
+
+class SQLStorageBase;
+
+/**
+ * Binary snapshot of the records of a SQLStorage table, written after a load from the world database
+ * and used instead of the SELECT at the next startup while the table checksum is unchanged.
+ * The file holds the records exactly as they are laid out in memory (string pointers stored as offsets
+ * into a string pool), so loading it is one read and a pointer fixup per string field.
+ * Source strings converted to other types by the loader (script names to script ids) are kept as strings,
+ * the loader converts them again after the records are read. A content checksum guards the whole file.
+ * Snapshots are disabled while no directory is set and for loaders that convert values with side effects.
+ */
+class SQLStorageSnapshot
+{
+    public:
+        /// Destination field filled by converting a source string
+        struct SourceStringField
+        {
+            uint32 srcField;
+            uint32 dstField;
+            uint32 offset;                                  ///< offset of the destination field in the record
+        };
+
+        static void SetDirectory(std::string const& directory) { m_directory = directory; }
+        static bool IsEnabled() { return !m_directory.empty(); }
+
+        /// Checksum of the table content as reported by the database, false if it can't be computed
+        static bool GetTableChecksum(char const* table, uint64& checksum);
+
+        /// Fields of the storage whose values are converted from source strings, in destination order
+        static void GetSourceStringFields(SQLStorageBase const& store, std::vector<SourceStringField>& fields);
+
+        /// Fill the storage from the table snapshot, false if there is none or it doesn't match the checksum.
+        /// sourceStrings gets the strings of the source string fields, per record, pointing into the storage
+        static bool Load(SQLStorageBase& store, uint64 checksum, std::vector<char const*>& sourceStrings);
+        /// Write the just loaded records of the storage, recordIds and sourceStrings in record order
+        static void Save(SQLStorageBase const& store, uint64 checksum, std::vector<uint32> const& recordIds,
+                         std::vector<std::string> const& sourceStrings);
+
+    private:
+        static std::string GetFileName(SQLStorageBase const& store);
+        /// Record size of the storage, fills the offsets of every field and of the pointer fields
+        static uint32 GetRecordLayout(SQLStorageBase const& store, std::vector<uint32>& fieldOffsets, std::vector<uint32>& stringOffsets);
+
+        static std::string m_directory;
+};
+
+#endif
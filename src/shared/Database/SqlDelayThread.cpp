@@ -20,7 +20,8 @@
 #include "Database/SqlOperations.h"
 #include "DatabaseEnv.h"
 
-SqlDelayThread::SqlDelayThread(Database* db, SqlConnection* conn) : m_dbEngine(db), m_dbConnection(conn), m_running(true)
+SqlDelayThread::SqlDelayThread(Database* db, SqlConnection* conn, bool pingDatabase) : m_queued(0), m_executed(0), m_dbEngine(db),
+    m_dbConnection(conn), m_running(true), m_pingDatabase(pingDatabase), m_queueDepth(0), m_maxLatency(0)
 {
 }
 
@@ -49,7 +50,7 @@ void SqlDelayThread::run()
 
         ProcessRequests();
 
-        if ((loopCounter++) >= pingEveryLoop)
+        if (m_pingDatabase && (loopCounter++) >= pingEveryLoop)
         {
             loopCounter = 0;
             m_dbEngine->Ping();
@@ -66,21 +67,61 @@ void SqlDelayThread::Stop()
     m_running = false;
 }
 
-void SqlDelayThread::ProcessRequests()
+bool SqlDelayThread::WaitExecuted(Position const& position) const
 {
-    std::queue<std::unique_ptr<SqlOperation>> sqlQueue;
+    // the owning lane may leave its loop before reaching the position, so give up once this lane is stopped
+    // and leave the request to Database::HaltDelayThread, which finishes all lanes from the main thread
+    SqlDelayThread* thread = position.first;
+    std::unique_lock<std::mutex> lock(thread->m_executedMutex);
+    while (thread->m_executed < position.second)
+    {
+        if (!m_running)
+            return false;
+
+        thread->m_executedCondition.wait_for(lock, std::chrono::milliseconds(10));
+    }
+    return true;
+}
 
+bool SqlDelayThread::ProcessRequests(bool wait /*= true*/)
+{
     // we need to move the contents of the queue to a local copy because executing these statements with the
     // lock in place can result in a deadlock with the world thread which calls Database::ProcessResultQueue()
     {
         std::lock_guard<std::mutex> guard(m_queueMutex);
-        sqlQueue = std::move(m_sqlQueue);
+        while (!m_sqlQueue.empty())
+        {
+            m_pending.push(std::move(m_sqlQueue.front()));
+            m_sqlQueue.pop();
+        }
     }
 
-    while (!sqlQueue.empty())
+    while (!m_pending.empty())
     {
-        auto const s = std::move(sqlQueue.front());
-        sqlQueue.pop();
-        s->Execute(m_dbConnection);
+        QueuedOperation& s = m_pending.front();
+        for (Position const& position : s.waitFor)
+        {
+            if (IsExecuted(position))
+                continue;
+
+            if (!wait || !WaitExecuted(position))
+                return false;
+        }
+
+        s.operation->Execute(m_dbConnection);
+
+        uint32 latency = uint32(std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - s.queued).count());
+        uint32 maxLatency = m_maxLatency;
+        while (latency > maxLatency && !m_maxLatency.compare_exchange_weak(maxLatency, latency)) {}
+        m_pending.pop();
+        --m_queueDepth;
+
+        {
+            std::lock_guard<std::mutex> guard(m_executedMutex);
+            ++m_executed;
+        }
+        m_executedCondition.notify_all();
     }
+
+    return true;
 }
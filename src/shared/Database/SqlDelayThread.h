@@ -23,9 +23,12 @@
 #include "SqlOperations.h"
 
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <memory>
 #include <mutex>
 #include <queue>
+#include <vector>
 
 class Database;
 class SqlOperation;
@@ -33,28 +36,64 @@ class SqlConnection;
 
 class SqlDelayThread : public MaNGOS::Runnable
 {
+    public:
+        // request of a delay thread, numbered from 1 in queue order
+        typedef std::pair<SqlDelayThread*, uint64> Position;
+
     private:
+        typedef std::chrono::steady_clock Clock;
+        struct QueuedOperation
+        {
+            std::unique_ptr<SqlOperation> operation;
+            Clock::time_point queued;
+            std::vector<Position> waitFor;                      ///< Requests of other threads to be executed first
+        };
+
         std::mutex m_queueMutex;
-        std::queue<std::unique_ptr<SqlOperation>> m_sqlQueue;   ///< Queue of SQL statements
+        std::queue<QueuedOperation> m_sqlQueue;                 ///< Queue of SQL statements
+        std::queue<QueuedOperation> m_pending;                  ///< Taken from m_sqlQueue, used by the executing thread only
+        uint64 m_queued;                                        ///< Requests queued so far, guarded by m_queueMutex
+        std::atomic<uint64> m_executed;                         ///< Requests executed so far
+        std::mutex m_executedMutex;
+        std::condition_variable m_executedCondition;
         Database* m_dbEngine;                                   ///< Pointer to used Database engine
         SqlConnection* m_dbConnection;                          ///< Pointer to DB connection
         std::atomic<bool> m_running;
+        bool m_pingDatabase;                                    ///< Only one delay thread keeps the connections alive
+        std::atomic<uint32> m_queueDepth;                       ///< Requests queued or executing
+        std::atomic<uint32> m_maxLatency;                       ///< Worst queued + execution time (ms) since last read
 
-        // process all enqueued requests
-        void ProcessRequests();
+        bool IsExecuted(Position const& position) const { return position.first->m_executed >= position.second; }
+        bool WaitExecuted(Position const& position) const;
 
     public:
-        SqlDelayThread(Database* db, SqlConnection* conn);
+        SqlDelayThread(Database* db, SqlConnection* conn, bool pingDatabase = true);
         ~SqlDelayThread();
 
-        ///< Put sql statement to delay queue
-        bool Delay(SqlOperation* sql)
+        ///< Put sql statement to delay queue, executed after the given requests of other delay threads
+        uint64 Delay(SqlOperation* sql, std::vector<Position> waitFor = {})
+        {
+            std::lock_guard<std::mutex> guard(m_queueMutex);
+            m_sqlQueue.push({ std::unique_ptr<SqlOperation>(sql), Clock::now(), std::move(waitFor) });
+            ++m_queueDepth;
+            return ++m_queued;
+        }
+
+        ///< Position of the last queued request, 0 if none
+        uint64 GetQueuedPosition()
         {
             std::lock_guard<std::mutex> guard(m_queueMutex);
-            m_sqlQueue.push(std::unique_ptr<SqlOperation>(sql));
-            return true;
+            return m_queued;
         }
 
+        // process all enqueued requests, without waiting stops at the first one whose predecessors on
+        // other delay threads are not executed yet; returns true when nothing is left
+        bool ProcessRequests(bool wait = true);
+
+        uint32 GetQueueDepth() const { return m_queueDepth; }
+        ///< Worst latency since the previous call
+        uint32 TakeMaxLatency() { return m_maxLatency.exchange(0); }
+
         virtual void Stop();                                ///< Stop event
         virtual void run();                                 ///< Main Thread loop
 };
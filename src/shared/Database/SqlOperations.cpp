@@ -43,10 +43,19 @@ SqlTransaction::~SqlTransaction()
     }
 }
 
+void SqlTransaction::SetState(SqlTransactionState state)
+{
+    for (SqlTransactionStatePtr const& observer : m_observers)
+        *observer = state;
+}
+
 bool SqlTransaction::Execute(SqlConnection* conn)
 {
     if (m_queue.empty())
+    {
+        SetState(SQL_TRANSACTION_COMMITTED);
         return true;
+    }
 
     LOCK_DB_CONN(conn);
 
@@ -60,11 +69,14 @@ bool SqlTransaction::Execute(SqlConnection* conn)
         if (!pStmt->Execute(conn))
         {
             conn->RollbackTransaction();
+            SetState(SQL_TRANSACTION_FAILED);
             return false;
         }
     }
 
-    return conn->CommitTransaction();
+    bool committed = conn->CommitTransaction();
+    SetState(committed ? SQL_TRANSACTION_COMMITTED : SQL_TRANSACTION_FAILED);
+    return committed;
 }
 
 SqlPreparedRequest::SqlPreparedRequest(int nIndex, SqlStmtParameters* arg) : m_nIndex(nIndex), m_param(arg)
@@ -117,16 +129,15 @@ void SqlResultQueue::Add(MaNGOS::IQueryCallback* callback)
     m_queue.push(std::unique_ptr<MaNGOS::IQueryCallback>(callback));
 }
 
-bool SqlQueryHolder::Execute(MaNGOS::IQueryCallback* callback, SqlDelayThread* thread, SqlResultQueue* queue)
+bool SqlQueryHolder::Execute(MaNGOS::IQueryCallback* callback, Database* db, SqlResultQueue* queue)
 {
-    if (!callback || !thread || !queue)
+    if (!callback || !db || !queue)
         return false;
 
     /// delay the execution of the queries, sync them with the delay thread
     /// which will in turn resync on execution (via the queue) and call back
     SqlQueryHolderEx* holderEx = new SqlQueryHolderEx(this, callback, queue);
-    thread->Delay(holderEx);
-    return true;
+    return db->DelayRequest(holderEx, m_laneKey, m_otherLaneKey);
 }
 
 bool SqlQueryHolder::SetQuery(size_t index, const char* sql)
@@ -22,6 +22,7 @@
 #include "Common.h"
 #include "Utilities/Callback.h"
 
+#include <atomic>
 #include <queue>
 #include <vector>
 #include <mutex>
@@ -54,16 +55,35 @@ class SqlPlainRequest : public SqlOperation
         bool Execute(SqlConnection* conn) override;
 };
 
+// outcome of a transaction, for callers that need to know whether their statements reached the database
+enum SqlTransactionState
+{
+    SQL_TRANSACTION_PENDING,
+    SQL_TRANSACTION_COMMITTED,
+    SQL_TRANSACTION_FAILED
+};
+
+typedef std::shared_ptr<std::atomic<SqlTransactionState> > SqlTransactionStatePtr;
+
 class SqlTransaction : public SqlOperation
 {
     private:
         std::vector<SqlOperation* > m_queue;
+        std::vector<SqlTransactionStatePtr> m_observers;
+        uint32 m_laneKey;
+        uint32 m_otherLaneKey;
+
+        void SetState(SqlTransactionState state);
 
     public:
-        SqlTransaction() {}
+        explicit SqlTransaction(uint32 laneKey = 0, uint32 otherLaneKey = 0) : m_laneKey(laneKey), m_otherLaneKey(otherLaneKey) {}
         ~SqlTransaction();
 
+        uint32 GetLaneKey() const { return m_laneKey; }
+        uint32 GetOtherLaneKey() const { return m_otherLaneKey; }
+
         void DelayExecute(SqlOperation* sql) { m_queue.push_back(sql); }
+        void AddObserver(SqlTransactionStatePtr const& state) { m_observers.push_back(state); }
 
         bool Execute(SqlConnection* conn) override;
 };
@@ -122,15 +142,21 @@ class SqlQueryHolder
     private:
         typedef std::pair<const char*, QueryResult*> SqlResultPair;
         std::vector<SqlResultPair> m_queries;
+        uint32 m_laneKey;
+        uint32 m_otherLaneKey;
     public:
-        SqlQueryHolder() {}
+        SqlQueryHolder() : m_laneKey(0), m_otherLaneKey(0) {}
         virtual ~SqlQueryHolder();
+        // holders with the same key as a transaction run on its async connection, so they see its writes,
+        // a second key orders the holder after the writes queued on that lane as well
+        void SetLaneKey(uint32 laneKey, uint32 otherLaneKey = 0) { m_laneKey = laneKey; m_otherLaneKey = otherLaneKey; }
+        uint32 GetLaneKey() const { return m_laneKey; }
         bool SetQuery(size_t index, const char* sql);
         bool SetPQuery(size_t index, const char* format, ...) ATTR_PRINTF(3, 4);
         void SetSize(size_t size);
         QueryResult* GetResult(size_t index);
         void SetResult(size_t index, QueryResult* result);
-        bool Execute(MaNGOS::IQueryCallback* callback, SqlDelayThread* thread, SqlResultQueue* queue);
+        bool Execute(MaNGOS::IQueryCallback* callback, Database* db, SqlResultQueue* queue);
 };
 
 class SqlQueryHolderEx : public SqlOperation
@@ -0,0 +1,123 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "DatabaseEnv.h"
+#include "SqlRowSetDiff.h"
+
+uint32 SqlRowSetDiff::Commit(Database& db, std::string const& ownerCondition)
+{
+    // the saved rows are only in the table once the transaction that wrote them went through
+    if (m_initialized && (!m_lastCommit || *m_lastCommit != SQL_TRANSACTION_COMMITTED))
+        Invalidate();
+
+    std::vector<std::string const*> deleted;
+    std::vector<RowMap::value_type const*> inserted;
+    std::vector<RowMap::value_type const*> updated;
+
+    if (!m_initialized)
+    {
+        db.Execute(("DELETE FROM " + m_table + " WHERE " + ownerCondition).c_str());
+        for (auto const& row : m_current)
+            inserted.push_back(&row);
+    }
+    else
+    {
+        for (auto const& row : m_saved)
+        {
+            RowMap::const_iterator itr = m_current.find(row.first);
+            if (itr == m_current.end() || itr->second.values != row.second.values)
+                deleted.push_back(&row.first);
+        }
+
+        for (auto const& row : m_current)
+        {
+            RowMap::const_iterator itr = m_saved.find(row.first);
+            if (itr == m_saved.end() || itr->second.values != row.second.values)
+                inserted.push_back(&row);
+            else if (itr->second.volatileValue != row.second.volatileValue)
+                updated.push_back(&row);
+        }
+    }
+
+    // keep every statement well below MAX_QUERY_LEN
+    size_t const maxLength = MAX_QUERY_LEN / 2;
+
+    std::string sql;
+    for (std::string const* key : deleted)
+    {
+        if (sql.empty())
+            sql = "DELETE FROM " + m_table + " WHERE " + ownerCondition + " AND ((" + *key + ")";
+        else
+            sql += " OR (" + *key + ")";
+
+        if (sql.length() > maxLength)
+        {
+            db.Execute((sql + ")").c_str());
+            sql.clear();
+        }
+    }
+    if (!sql.empty())
+        db.Execute((sql + ")").c_str());
+
+    std::string const columns = m_volatileColumn.empty() ? m_columns : m_columns + ", " + m_volatileColumn;
+
+    sql.clear();
+    for (RowMap::value_type const* row : inserted)
+    {
+        std::string const values = m_volatileColumn.empty() ? row->second.values : row->second.values + ", " + row->second.volatileValue;
+        if (sql.empty())
+            sql = "INSERT INTO " + m_table + " (" + columns + ") VALUES (" + values + ")";
+        else
+            sql += ",(" + values + ")";
+
+        if (sql.length() > maxLength)
+        {
+            db.Execute(sql.c_str());
+            sql.clear();
+        }
+    }
+    if (!sql.empty())
+        db.Execute(sql.c_str());
+
+    // rows where only the volatile column changed: UPDATE ... SET column = CASE WHEN key THEN value ... END
+    std::string cases, keys;
+    for (size_t i = 0; i < updated.size(); ++i)
+    {
+        cases += " WHEN (" + updated[i]->first + ") THEN " + updated[i]->second.volatileValue;
+        keys += (keys.empty() ? "(" : " OR (") + updated[i]->first + ")";
+
+        if (cases.length() + keys.length() > maxLength || i + 1 == updated.size())
+        {
+            db.Execute(("UPDATE " + m_table + " SET " + m_volatileColumn + " = CASE" + cases + " END WHERE " + ownerCondition + " AND (" + keys + ")").c_str());
+            cases.clear();
+            keys.clear();
+        }
+    }
+
+    m_unchanged = uint32(m_current.size() - inserted.size() - updated.size());
+
+    m_saved.swap(m_current);
+    m_current.clear();
+    m_initialized = true;
+
+    m_lastCommit = std::make_shared<std::atomic<SqlTransactionState> >(SQL_TRANSACTION_PENDING);
+    if (!db.ObserveTransaction(m_lastCommit))
+        m_lastCommit.reset();
+
+    return uint32(deleted.size() + inserted.size() + updated.size());
+}
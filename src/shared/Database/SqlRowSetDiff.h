@@ -0,0 +1,83 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef SQLROWSETDIFF_H
+#define SQLROWSETDIFF_H
+
+#include "Common.h"
+#include "SqlOperations.h"
+
+#include <string>
+#include <unordered_map>
+
+class Database;
+
+/**
+ * Row level dirty tracking for tables that hold a set of rows per owner (character auras, cooldowns...).
+ * The caller adds every row the owner should have now, Commit() compares them with the rows written last
+ * time and only deletes/inserts the rows that changed: one DELETE and one multi-row INSERT per chunk.
+ * An optional volatile column (a remaining time) is left out of the comparison, rows where only it changed
+ * are fixed with one multi-row UPDATE instead of being rewritten.
+ * Until the first Commit(), and after one whose transaction did not go through, nothing is known about the
+ * table, so it rewrites all rows of the owner. Commit() belongs in a transaction, outside of one the outcome
+ * is unknown and the next Commit() rewrites everything too.
+ * Rows are built as plain SQL, keys and values must be numeric or already escaped.
+ */
+class SqlRowSetDiff
+{
+    public:
+        SqlRowSetDiff(char const* table, char const* columns, char const* volatileColumn = nullptr) :
+            m_table(table), m_columns(columns), m_volatileColumn(volatileColumn ? volatileColumn : ""), m_unchanged(0), m_initialized(false) {}
+
+        // key is the SQL condition selecting the row within the owner, values the comma separated VALUES content
+        // (without the volatile column, its value is passed apart)
+        void AddRow(std::string const& key, std::string const& values, std::string const& volatileValue = std::string())
+        {
+            Row& row = m_current[key];
+            row.values = values;
+            row.volatileValue = volatileValue;
+        }
+
+        // queue the writes (inside the current transaction if any), returns the amount of rows deleted, inserted or updated
+        uint32 Commit(Database& db, std::string const& ownerCondition);
+
+        // rows of the last Commit() that were already up to date
+        uint32 GetUnchangedRows() const { return m_unchanged; }
+
+        // forget the saved state, next Commit() rewrites all rows of the owner
+        void Invalidate() { m_initialized = false; m_saved.clear(); m_lastCommit.reset(); }
+
+    private:
+        struct Row
+        {
+            std::string values;
+            std::string volatileValue;
+        };
+
+        typedef std::unordered_map<std::string, Row> RowMap;
+
+        std::string m_table;
+        std::string m_columns;
+        std::string m_volatileColumn;
+        RowMap m_saved;
+        RowMap m_current;
+        SqlTransactionStatePtr m_lastCommit;                // outcome of the transaction m_saved was written in
+        uint32 m_unchanged;
+        bool m_initialized;
+};
+#endif
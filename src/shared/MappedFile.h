@@ -0,0 +1,53 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOSSERVER_MAPPEDFILE_H
+#define MANGOSSERVER_MAPPEDFILE_H
+
+#include "Platform/Define.h"
+
+#include <cstddef>
+
+// Read-only memory mapping of a whole file. The pages are shared through the OS page cache
+// with every other mapping of the same file, closing only drops the mapping.
+class MappedFile
+{
+    public:
+        MappedFile();
+        ~MappedFile();
+
+        MappedFile(MappedFile const&) = delete;
+        MappedFile& operator=(MappedFile const&) = delete;
+
+        // false if the file does not exist, is empty or can not be mapped
+        bool Open(char const* filename);
+        void Close();
+
+        bool IsOpen() const { return m_data != nullptr; }
+        uint8 const* GetData() const { return m_data; }
+        size_t GetSize() const { return m_size; }
+
+    private:
+        uint8 const* m_data;
+        size_t m_size;
+#ifdef _WIN32
+        void* m_mapping;
+#endif
+};
+
+#endif
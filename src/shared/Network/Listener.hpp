@@ -20,9 +20,12 @@
 #define __LISTENER_HPP_
 
 #include "NetworkThread.hpp"
+#include "Log.h"
 
 #include <boost/asio.hpp>
 
+#include <algorithm>
+#include <future>
 #include <memory>
 #include <thread>
 #include <vector>
@@ -39,6 +42,12 @@ namespace MaNGOS
             std::thread m_acceptorThread;
             std::vector<std::unique_ptr<NetworkThread<SocketType>>> m_workerThreads;
 
+            // with SO_REUSEPORT every worker thread gets an acceptor of its own, run by its own io_service,
+            // and the kernel spreads incoming connections over them
+            std::vector<std::unique_ptr<boost::asio::ip::tcp::acceptor>> m_workerAcceptors;
+            // socket of the accept in flight per worker acceptor, only touched by that worker's thread
+            std::vector<std::shared_ptr<SocketType>> m_workerPendingSockets;
+
             // the time in milliseconds to sleep a worker thread at the end of each tick
             const int SleepInterval = 100;
 
@@ -61,21 +70,36 @@ namespace MaNGOS
                 return m_workerThreads[minIndex].get();
             }
 
+            bool OpenWorkerAcceptors(boost::asio::ip::tcp::endpoint const& endpoint);
+
             void BeginAccept();
             void OnAccept(NetworkThread<SocketType> *worker, std::shared_ptr<SocketType> const& socket, const boost::system::error_code &ec);
 
+            void BeginWorkerAccept(size_t index, NetworkThread<SocketType> *worker, boost::asio::ip::tcp::acceptor *acceptor);
+
         public:
-            Listener(std::string const& address, int port, int workerThreads);
+            Listener(std::string const& address, int port, int workerThreads, bool reusePort = false, bool pinThreads = false);
             ~Listener();
     };
 
     template <typename SocketType>
-    Listener<SocketType>::Listener(std::string const& address, int port, int workerThreads)
-    : m_service(), m_acceptor(m_service, boost::asio::ip::tcp::endpoint(boost::asio::ip::address::from_string(address), port))
+    Listener<SocketType>::Listener(std::string const& address, int port, int workerThreads, bool reusePort, bool pinThreads)
+    : m_service(), m_acceptor(m_service)
     {
+        unsigned int const cores = std::max(std::thread::hardware_concurrency(), 1u);
         m_workerThreads.reserve(workerThreads);
         for (auto i = 0; i < workerThreads; ++i)
-            m_workerThreads.push_back(std::unique_ptr<NetworkThread<SocketType>>(new NetworkThread<SocketType>));
+            m_workerThreads.push_back(std::unique_ptr<NetworkThread<SocketType>>(new NetworkThread<SocketType>(pinThreads ? int(i % cores) : -1)));
+
+        boost::asio::ip::tcp::endpoint const endpoint(boost::asio::ip::address::from_string(address), port);
+
+        if (reusePort && OpenWorkerAcceptors(endpoint))
+            return;
+
+        m_acceptor.open(endpoint.protocol());
+        m_acceptor.set_option(boost::asio::ip::tcp::acceptor::reuse_address(true));
+        m_acceptor.bind(endpoint);
+        m_acceptor.listen();
 
         BeginAccept();
 
@@ -85,6 +109,32 @@ namespace MaNGOS
     template <typename SocketType>
     Listener<SocketType>::~Listener()
     {
+        // the worker acceptors are used by their worker threads only, so they have to be closed there as well.
+        // wait for that before letting them go out of scope
+        for (size_t i = 0; i < m_workerAcceptors.size(); ++i)
+        {
+            NetworkThread<SocketType>* worker = m_workerThreads[i].get();
+            boost::asio::ip::tcp::acceptor* acceptor = m_workerAcceptors[i].get();
+            std::shared_ptr<SocketType>& pending = m_workerPendingSockets[i];
+            std::promise<void> closed;
+            worker->GetService().post([worker, acceptor, &pending, &closed]()
+            {
+                boost::system::error_code ec;
+                acceptor->close(ec);
+                // the aborted accept handler only holds the last reference and frees the socket when it is done
+                if (pending)
+                {
+                    worker->RemoveSocket(pending.get());
+                    pending.reset();
+                }
+                closed.set_value();
+            });
+            closed.get_future().wait();
+        }
+
+        if (!m_acceptorThread.joinable())
+            return;
+
         // Close the acceptor. This will cancel any asynchronous accept
         // operation and should stop the acceptor thread. Note that closing
         // the acceptor needs to be done in the acceptor thread, because
@@ -93,6 +143,40 @@ namespace MaNGOS
         m_acceptorThread.join();
     }
 
+    template <typename SocketType>
+    bool Listener<SocketType>::OpenWorkerAcceptors(boost::asio::ip::tcp::endpoint const& endpoint)
+    {
+#ifdef SO_REUSEPORT
+        typedef boost::asio::detail::socket_option::boolean<SOL_SOCKET, SO_REUSEPORT> reuse_port;
+
+        for (auto& worker : m_workerThreads)
+        {
+            std::unique_ptr<boost::asio::ip::tcp::acceptor> acceptor(new boost::asio::ip::tcp::acceptor(worker->GetService()));
+            acceptor->open(endpoint.protocol());
+            acceptor->set_option(boost::asio::ip::tcp::acceptor::reuse_address(true));
+            acceptor->set_option(reuse_port(true));
+            acceptor->bind(endpoint);
+            acceptor->listen();
+            m_workerAcceptors.push_back(std::move(acceptor));
+        }
+        m_workerPendingSockets.resize(m_workerAcceptors.size());
+
+        // the worker services are already running, so start accepting from their own threads
+        for (size_t i = 0; i < m_workerThreads.size(); ++i)
+        {
+            NetworkThread<SocketType>* worker = m_workerThreads[i].get();
+            boost::asio::ip::tcp::acceptor* acceptor = m_workerAcceptors[i].get();
+            worker->GetService().post([this, i, worker, acceptor]() { BeginWorkerAccept(i, worker, acceptor); });
+        }
+
+        return true;
+#else
+        (void)endpoint;
+        sLog.outError("Listener: SO_REUSEPORT is not supported on this platform, using a single acceptor.");
+        return false;
+#endif
+    }
+
     template <typename SocketType>
     void Listener<SocketType>::BeginAccept()
     {
@@ -118,6 +202,32 @@ namespace MaNGOS
         if (m_acceptor.is_open())
             BeginAccept();
     }
+
+    template <typename SocketType>
+    void Listener<SocketType>::BeginWorkerAccept(size_t index, NetworkThread<SocketType> *worker, boost::asio::ip::tcp::acceptor *acceptor)
+    {
+        auto socket = worker->CreateSocket();
+        m_workerPendingSockets[index] = socket;
+
+        acceptor->async_accept(socket->GetAsioSocket(),
+            [this, index, worker, acceptor, socket] (const boost::system::error_code &ec)
+        {
+            // the listener may be gone already when a closed acceptor reports back, touch nothing.
+            // the destructor has taken the socket out of the worker already
+            if (ec == boost::asio::error::operation_aborted)
+                return;
+
+            m_workerPendingSockets[index].reset();
+
+            if (ec)
+                worker->RemoveSocket(socket.get());
+            else
+                socket->Open();
+
+            if (acceptor->is_open())
+                this->BeginWorkerAccept(index, worker, acceptor);
+        });
+    }
 }
 
 #endif /* !__LISTENER_HPP_ */
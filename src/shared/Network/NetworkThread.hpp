@@ -27,6 +27,11 @@
 #include <mutex>
 #include <unordered_set>
 
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
 namespace MaNGOS
 {
     template <typename SocketType>
@@ -43,9 +48,27 @@ namespace MaNGOS
 
             std::thread m_serviceThread;
 
+            // pin the service thread to one core, so its sockets stay in that core's caches
+            void SetAffinity(unsigned int core)
+            {
+#ifdef __linux__
+                cpu_set_t cpuSet;
+                CPU_ZERO(&cpuSet);
+                CPU_SET(core, &cpuSet);
+                pthread_setaffinity_np(m_serviceThread.native_handle(), sizeof(cpuSet), &cpuSet);
+#else
+                (void)core;
+#endif
+            }
+
         public:
-            NetworkThread() : m_work(new boost::asio::io_service::work(m_service)), m_serviceThread([this] { boost::system::error_code ec; this->m_service.run(ec); })
+            // core < 0 leaves the service thread to the scheduler
+            explicit NetworkThread(int core = -1) : m_work(new boost::asio::io_service::work(m_service)), m_serviceThread([this] { boost::system::error_code ec; this->m_service.run(ec); })
             {
+                // the handle is only valid as long as the thread is joinable
+                if (core >= 0)
+                    SetAffinity(core);
+
                 m_serviceThread.detach();
             }
 
@@ -67,6 +90,8 @@ namespace MaNGOS
 
             size_t Size() const { return m_sockets.size(); }
 
+            boost::asio::io_service& GetService() { return m_service; }
+
             std::shared_ptr<SocketType> CreateSocket();
 
             void RemoveSocket(Socket *socket)
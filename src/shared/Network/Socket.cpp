@@ -237,9 +237,16 @@ namespace MaNGOS
         // at this point we are guarunteed that there is data to send in the primary buffer.  send it.
         m_writeState = WriteState::Sending;
 
+        StartAsyncWrite();
+    }
+
+// note that this function assumes that the socket mutex is locked
+    void Socket::StartAsyncWrite()
+    {
+        // async_write keeps going until the whole primary buffer is out, so a completed write never leaves a remainder behind
         std::shared_ptr<Socket> ptr = shared<Socket>();
-        m_socket.async_write_some(boost::asio::buffer(m_outBuffer->m_buffer, m_outBuffer->m_writePosition),
-                                  make_custom_alloc_handler(m_allocator,
+        boost::asio::async_write(m_socket, boost::asio::buffer(m_outBuffer->m_buffer.data(), m_outBuffer->m_writePosition),
+                                 make_custom_alloc_handler(m_allocator,
         [ptr](const boost::system::error_code & error, size_t length) { ptr->OnWriteComplete(error, length); }));
     }
 
@@ -251,6 +258,14 @@ namespace MaNGOS
         m_outBufferFlushTimer.cancel();
     }
 
+    void Socket::Flush()
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+
+        if (m_writeState == WriteState::Buffering)
+            m_outBufferFlushTimer.cancel();
+    }
+
     void Socket::OnWriteComplete(const boost::system::error_code& error, size_t length)
     {
         // we must check this before locking the mutex because the connection will be closed,
@@ -270,37 +285,16 @@ namespace MaNGOS
         std::lock_guard<std::mutex> guard(m_mutex);
 
         assert(m_writeState == WriteState::Sending);
-        assert(length <= m_outBuffer->m_writePosition);
+        assert(length == m_outBuffer->m_writePosition);
 
-        // if there is data left to write, move it to the start of the buffer
-        if (length < m_outBuffer->m_writePosition)
-        {
-            memcpy(&(m_outBuffer->m_buffer[0]), &(m_outBuffer->m_buffer[length]), (m_outBuffer->m_writePosition - length) * sizeof(m_outBuffer->m_buffer[0]));
-            m_outBuffer->m_writePosition -= length;
-        }
-        // if not, reset the write pointer
-        else
-            m_outBuffer->m_writePosition = 0;
+        m_outBuffer->m_writePosition = 0;
 
-        // if there is data in the secondary buffer, append it to the primary buffer
-        if (m_secondaryOutBuffer->m_writePosition > 0)
-        {
-            // do we have enough space? if not, resize
-            if (m_outBuffer->m_buffer.size() < (m_outBuffer->m_writePosition + m_secondaryOutBuffer->m_writePosition))
-                m_outBuffer->m_buffer.resize(m_outBuffer->m_writePosition + m_secondaryOutBuffer->m_writePosition);
+        // everything written while we were sending is in the secondary buffer, swap it in instead of copying it over
+        std::swap(m_outBuffer, m_secondaryOutBuffer);
 
-            memcpy(&(m_outBuffer->m_buffer[m_outBuffer->m_writePosition]), &(m_secondaryOutBuffer->m_buffer[0]), (m_secondaryOutBuffer->m_writePosition) * sizeof(m_secondaryOutBuffer->m_buffer[0]));
-
-            m_outBuffer->m_writePosition += m_secondaryOutBuffer->m_writePosition;
-            m_secondaryOutBuffer->m_writePosition = 0;
-        }
-
-        std::shared_ptr<Socket> ptr = shared<Socket>();
         // if there is any data to write, do so immediately
         if (m_outBuffer->m_writePosition > 0)
-            m_socket.async_write_some(boost::asio::buffer(m_outBuffer->m_buffer, m_outBuffer->m_writePosition),
-                                      make_custom_alloc_handler(m_allocator,
-            [ptr](const boost::system::error_code & error, size_t length) { ptr->OnWriteComplete(error, length);}));
+            StartAsyncWrite();
         else
             m_writeState = WriteState::Idle;
     }
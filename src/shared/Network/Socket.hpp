@@ -71,6 +71,7 @@ namespace MaNGOS
             void OnRead(const boost::system::error_code &error, size_t length);
 
             void StartWriteFlushTimer();
+            void StartAsyncWrite();
             void OnWriteComplete(const boost::system::error_code &error, size_t length);
             void FlushOut();
 
@@ -106,6 +107,9 @@ namespace MaNGOS
             void Write(const char *buffer, int length);
             void Write(const char *header, int headerSize, const char* content, int contentSize);
 
+            // send buffered data now instead of waiting for the flush timer, f.e. at the end of a map tick
+            void Flush();
+
             boost::asio::ip::tcp::socket &GetAsioSocket() { return m_socket; }
 
             const std::string &GetRemoteEndpoint() const { return m_remoteEndpoint; }
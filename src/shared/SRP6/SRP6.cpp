@@ -21,19 +21,139 @@
 #include "Auth/base32.h"
 #include "SRP6.h"
 
+#include <openssl/bn.h>
+
+namespace
+{
+    char const* const s_primeHex = "894B645E89E1535BBDAD5B8B290650530801B18EBFBF5E8FAB3C82872A3E9BB7";
+    uint32 const s_generator = 7;
+
+    /**
+     * N and g are the same for every session, so the Montgomery context of N and a table of
+     * g^(d * 16^i) are built once. g^e then costs one Montgomery multiplication per nonzero
+     * 4 bit digit of e instead of a full square-and-multiply exponentiation.
+     */
+    class SRP6Group
+    {
+        public:
+            static SRP6Group const& Instance()
+            {
+                static SRP6Group group;
+                return group;
+            }
+
+            // r = g^e mod N
+            void ModExpG(BIGNUM* r, BIGNUM const* e, BN_CTX* ctx) const
+            {
+                if (BN_num_bits(e) > MAX_EXPONENT_BITS)
+                {
+                    ModExp(r, m_g, e, ctx);
+                    return;
+                }
+
+                BN_CTX_start(ctx);
+                BIGNUM* acc = BN_CTX_get(ctx);
+                BN_copy(acc, m_one);
+
+                for (int i = 0; i < WINDOWS; ++i)
+                {
+                    int digit = 0;
+                    for (int bit = 0; bit < WINDOW_BITS; ++bit)
+                        if (BN_is_bit_set(e, i * WINDOW_BITS + bit))
+                            digit |= 1 << bit;
+
+                    if (digit)
+                        BN_mod_mul_montgomery(acc, acc, m_table[i][digit - 1], m_mont, ctx);
+                }
+
+                BN_from_montgomery(r, acc, m_mont, ctx);
+                BN_CTX_end(ctx);
+            }
+
+            // r = a^e mod N
+            void ModExp(BIGNUM* r, BIGNUM const* a, BIGNUM const* e, BN_CTX* ctx) const
+            {
+                BN_mod_exp_mont(r, a, e, m_N, ctx, m_mont);
+            }
+
+            BIGNUM const* GetN() const { return m_N; }
+
+        private:
+            static int const WINDOW_BITS = 4;
+            static int const MAX_EXPONENT_BITS = 256;
+            static int const WINDOWS = MAX_EXPONENT_BITS / WINDOW_BITS;
+            static int const DIGITS = (1 << WINDOW_BITS) - 1;   // nonzero digits only
+
+            SRP6Group() : m_N(BN_new()), m_g(BN_new()), m_one(BN_new()), m_mont(BN_MONT_CTX_new())
+            {
+                BN_CTX* ctx = BigNumber::GetThreadContext();
+
+                BN_hex2bn(&m_N, s_primeHex);
+                BN_set_word(m_g, s_generator);
+                BN_MONT_CTX_set(m_mont, m_N, ctx);
+                BN_to_montgomery(m_one, BN_value_one(), m_mont, ctx);
+
+                // base = g^(16^i) in Montgomery form
+                BIGNUM* base = BN_new();
+                BN_to_montgomery(base, m_g, m_mont, ctx);
+                for (int i = 0; i < WINDOWS; ++i)
+                {
+                    m_table[i][0] = BN_dup(base);
+                    for (int d = 1; d < DIGITS; ++d)
+                    {
+                        m_table[i][d] = BN_new();
+                        BN_mod_mul_montgomery(m_table[i][d], m_table[i][d - 1], base, m_mont, ctx);
+                    }
+                    BN_mod_mul_montgomery(base, m_table[i][DIGITS - 1], base, m_mont, ctx);
+                }
+                BN_free(base);
+            }
+
+            ~SRP6Group()
+            {
+                for (auto& window : m_table)
+                    for (BIGNUM* entry : window)
+                        BN_free(entry);
+
+                BN_MONT_CTX_free(m_mont);
+                BN_free(m_one);
+                BN_free(m_g);
+                BN_free(m_N);
+            }
+
+            BIGNUM* m_N;
+            BIGNUM* m_g;
+            BIGNUM* m_one;                                  // 1 in Montgomery form
+            BN_MONT_CTX* m_mont;
+            BIGNUM* m_table[WINDOWS][DIGITS];               // [i][d - 1] = g^(d * 16^i) in Montgomery form
+    };
+}
+
 SRP6::SRP6()
 {
-    N.SetHexStr("894B645E89E1535BBDAD5B8B290650530801B18EBFBF5E8FAB3C82872A3E9BB7");
-    g.SetDword(7);
+    N.SetHexStr(s_primeHex);
+    g.SetDword(s_generator);
 }
 
 void SRP6::CalculateHostPublicEphemeral(void)
 {
+    SRP6Group const& group = SRP6Group::Instance();
+    BN_CTX* ctx = BigNumber::GetThreadContext();
+
     b.SetRand(19 * 8);
-    BigNumber gmod = g.ModExp(b, N);
-    B = ((v * 3) + gmod) % N;
 
-    MANGOS_ASSERT(gmod.GetNumBytes() <= 32);
+    BN_CTX_start(ctx);
+    BIGNUM* gmod = BN_CTX_get(ctx);
+    BIGNUM* kv = BN_CTX_get(ctx);
+
+    group.ModExpG(gmod, b.BN(), ctx);
+    MANGOS_ASSERT(BN_num_bytes(gmod) <= 32);
+
+    // B = (k * v + g^b) % N with k = 3
+    BN_copy(kv, v.BN());
+    BN_mul_word(kv, 3);
+    BN_mod_add(B.BN(), kv, gmod, group.GetN(), ctx);
+    BN_CTX_end(ctx);
 }
 
 void SRP6::CalculateProof(std::string username)
@@ -84,7 +204,16 @@ bool SRP6::CalculateSessionKey(uint8* lp_A, int l)
     sha.UpdateBigNumbers(&A, &B, nullptr);
     sha.Finalize();
     u.SetBinary(sha.GetDigest(), 20);
-    S = (A * (v.ModExp(u, N))).ModExp(b, N);
+
+    // S = (A * v^u)^b % N
+    SRP6Group const& group = SRP6Group::Instance();
+    BN_CTX* ctx = BigNumber::GetThreadContext();
+    BN_CTX_start(ctx);
+    BIGNUM* base = BN_CTX_get(ctx);
+    group.ModExp(base, v.BN(), u.BN(), ctx);
+    BN_mod_mul(base, A.BN(), base, group.GetN(), ctx);
+    group.ModExp(S.BN(), base, b.BN(), ctx);
+    BN_CTX_end(ctx);
 
     return true;
 }
@@ -124,7 +253,7 @@ bool SRP6::CalculateVerifier(const std::string& rI, const char* salt)
     sha.Finalize();
     BigNumber x;
     x.SetBinary(sha.GetDigest(), Sha1Hash::GetLength());
-    v = g.ModExp(x, N);
+    SRP6Group::Instance().ModExpG(v.BN(), x.BN(), BigNumber::GetThreadContext());
 
     return true;
 }